@@ -10,6 +10,10 @@ public enum AtlasAllocatorType : byte
 {
     Common,
     Bucketed,
+    /// <summary>
+    /// Rows of one height class each, the tightest and fastest for many small similarly sized rects such as glyphs
+    /// </summary>
+    Shelf,
 }
 
 [Dropping(Unmanaged = true)]
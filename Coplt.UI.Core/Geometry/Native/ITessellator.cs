@@ -1,11 +1,77 @@
 using System.Runtime.InteropServices;
 using Coplt.Com;
+using Coplt.UI.Miscellaneous;
 
 namespace Coplt.UI.Core.Geometry.Native;
 
+[Interface, Guid("9ebb41f9-ee12-4c68-8766-0b4b682c3268")]
+public unsafe partial struct ITessCache
+{
+    /// <returns>AddRef will not be called</returns>
+    public partial IFrameSource* GetFrameSource();
+
+    /// <summary>
+    /// Sets the number of frames after which an unused mesh expires in <see cref="Collect"/>, default is 180 frames
+    /// </summary>
+    public partial void SetExpireFrame(ulong FrameCount);
+    /// <summary>
+    /// Default is 16 MiB, 0 disables the cache
+    /// </summary>
+    public partial void SetBudget(ulong Bytes);
+
+    /// <summary>
+    /// Drops the expired meshes, and the least recently used ones while over the budget
+    /// </summary>
+    public partial void Collect();
+    public partial void Clear();
+
+    public partial void GetStats(ulong* hits, ulong* misses, ulong* evictions, ulong* bytes, uint* entries);
+
+    /// <summary>
+    /// The mesh is shared by every call with the same path content and options, the tolerance is rounded down to a
+    /// power of two
+    /// </summary>
+    public partial HResult Fill(IPath* path, TessFillOptions* options, ITessMesh** mesh);
+    public partial HResult Stroke(IPath* path, TessStrokeOptions* options, ITessMesh** mesh);
+}
+
+[Interface, Guid("159c2428-d869-4fb4-a458-842bf871bcba")]
+public unsafe partial struct ITessMesh
+{
+    /// <summary>
+    /// Vertices are x y pairs, 3 indices per triangle; immutable and valid while the mesh is alive
+    /// </summary>
+    public partial void GetData(
+        [ComType<Ptr<ConstPtr<float>>>] float** vertices, int* vertex_count,
+        [ComType<Ptr<ConstPtr<uint>>>] uint** indices, int* index_count
+    );
+}
+
 [Interface, Guid("acf5d52e-a656-4c00-a528-09aa4d86b2b2")]
 public unsafe partial struct ITessellator
 {
-    public partial HResult Fill(IPath* path, TessFillOptions* options); // todo output
-    public partial HResult Stroke(IPath* path, TessStrokeOptions* options); // todo output
+    /// <summary>
+    /// Fill and Stroke append triangles to the mesh, it is kept until <see cref="Clear"/>
+    /// </summary>
+    public partial HResult Fill(IPath* path, TessFillOptions* options);
+    public partial HResult Stroke(IPath* path, TessStrokeOptions* options);
+
+    public partial void Clear();
+    /// <summary>
+    /// Vertices are x y pairs, 3 indices per triangle; valid until the next Fill, Stroke or Clear
+    /// </summary>
+    public partial void GetMesh(float** vertices, int* vertex_count, uint** indices, int* index_count);
+
+    /// <summary>
+    /// Appends the shapes in order, the same mesh as a Fill or Stroke per shape whatever the thread count.
+    /// <para>vertex_offsets and index_offsets get count + 1 entries, shape i is [offsets[i], offsets[i + 1])</para>
+    /// </summary>
+    public partial HResult FillBatch(
+        [ComType<ConstPtr<Ptr<IPath>>>] IPath** paths, [ComType<ConstPtr<TessFillOptions>>] TessFillOptions* options,
+        int count, uint* vertex_offsets, uint* index_offsets, bool parallel
+    );
+    public partial HResult StrokeBatch(
+        [ComType<ConstPtr<Ptr<IPath>>>] IPath** paths, [ComType<ConstPtr<TessStrokeOptions>>] TessStrokeOptions* options,
+        int count, uint* vertex_offsets, uint* index_offsets, bool parallel
+    );
 }
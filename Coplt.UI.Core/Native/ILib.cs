@@ -38,4 +38,19 @@ public unsafe partial struct ILib
     public partial HResult CreateLayout(ILayout** layout);
 
     public partial HResult SplitTexts(NativeList<TextRange>* ranges, [ComType<ConstPtr<char>>] char* chars, int len);
+    public partial HResult WarmUpLikelyLocales();
+    public partial HResult SplitTextsBatch(
+        NativeList<TextRange>* ranges, NativeList<int>* offsets,
+        [ComType<ConstPtr<Str16>>] Str16* inputs, int count, bool parallel
+    );
+
+    public partial void GetArenaStats(ulong* used, ulong* peak);
+    public partial void SetTextMeasureCache(uint capacity, float width_quantum);
+    public partial void SetParallelTextLayout(bool enable);
+    public partial void SetShapeCacheBudget(ulong bytes);
+    public partial void GetShapeCacheStats(ulong* hits, ulong* misses, ulong* evictions, ulong* bytes, uint* entries);
+
+    public partial HResult CreatePathBuilder(IPathBuilder** pb);
+    public partial HResult CreateTessellator(ITessellator** tess);
+    public partial HResult CreateTessCache(IFrameSource* fs, ITessCache** cache);
 }
@@ -3,6 +3,7 @@ using System.Runtime.InteropServices;
 using Coplt.Com;
 using Coplt.Dropping;
 using Coplt.UI.Collections;
+using Coplt.UI.Core.Geometry.Native;
 using Coplt.UI.Miscellaneous;
 using Coplt.UI.Texts;
 using Coplt.UI.Utilities;
@@ -165,5 +166,103 @@ public sealed unsafe partial class NativeLib
         m_lib.SplitTexts(ranges, chars, len).TryThrowWithMsg();
     }
 
+    public void SplitTextsBatch(NativeList<TextRange>* ranges, NativeList<int>* offsets, Str16* inputs, int count, bool parallel)
+    {
+        m_lib.SplitTextsBatch(ranges, offsets, inputs, count, parallel).TryThrowWithMsg();
+    }
+
+    #endregion
+
+    #region WarmUpLikelyLocales
+
+    public void WarmUpLikelyLocales()
+    {
+        m_lib.WarmUpLikelyLocales().TryThrowWithMsg();
+    }
+
+    #endregion
+
+    #region ArenaStats
+
+    public (ulong Used, ulong Peak) ArenaStats
+    {
+        get
+        {
+            ulong used, peak;
+            m_lib.GetArenaStats(&used, &peak);
+            return (used, peak);
+        }
+    }
+
+    #endregion
+
+    #region TextMeasureCache
+
+    // Off by default, capacity 0 disables it again; widths are rounded down to a multiple of widthQuantum and
+    // measured at the rounded width, 0 keeps them exact
+    public void SetTextMeasureCache(uint capacity, float widthQuantum = 0)
+    {
+        m_lib.SetTextMeasureCache(capacity, widthQuantum);
+    }
+
+    #endregion
+
+    #region ParallelTextLayout
+
+    // Paragraphs of a text layout are analysed and shaped on all cores, the result is the same as sequential
+    public void SetParallelTextLayout(bool enable)
+    {
+        m_lib.SetParallelTextLayout(enable);
+    }
+
+    #endregion
+
+    #region ShapeCache
+
+    // Glyphs of short runs are shared by every layout in the process, 0 bytes disables the cache
+    public void SetShapeCacheBudget(ulong bytes)
+    {
+        m_lib.SetShapeCacheBudget(bytes);
+    }
+
+    public (ulong Hits, ulong Misses, ulong Evictions, ulong Bytes, uint Entries) ShapeCacheStats
+    {
+        get
+        {
+            ulong hits, misses, evictions, bytes;
+            uint entries;
+            m_lib.GetShapeCacheStats(&hits, &misses, &evictions, &bytes, &entries);
+            return (hits, misses, evictions, bytes, entries);
+        }
+    }
+
+    #endregion
+
+    #region Geometry
+
+    // A builder can be reused, Build leaves it empty with its buffers kept
+    public Rc<IPathBuilder> CreatePathBuilder()
+    {
+        IPathBuilder* ptr;
+        m_lib.CreatePathBuilder(&ptr).TryThrowWithMsg();
+        return new(ptr);
+    }
+
+    // Reuse one per thread, the mesh and scratch buffers keep their capacity across Clear
+    public Rc<ITessellator> CreateTessellator()
+    {
+        ITessellator* ptr;
+        m_lib.CreateTessellator(&ptr).TryThrowWithMsg();
+        return new(ptr);
+    }
+
+    // Meshes not used for the expire frame count of the frame source are dropped by Collect
+    public Rc<ITessCache> CreateTessCache(FrameSource FrameSource)
+    {
+        ITessCache* ptr;
+        m_lib.CreateTessCache(FrameSource.m_inner.Handle, &ptr).TryThrowWithMsg();
+        return new(ptr);
+    }
+
     #endregion
 }
@@ -24,6 +24,8 @@ namespace Coplt {
     struct IPath;
     struct IPathBuilder;
     struct IStub;
+    struct ITessCache;
+    struct ITessMesh;
     struct ITessellator;
     struct ITextData;
     struct ITextLayout;
@@ -2083,6 +2085,16 @@ struct ::Coplt::Internal::VirtualTable<::Coplt::ILib>
     ::Coplt::i32 (*const COPLT_CDECL f_CreateFontFallbackBuilder)(::Coplt::ILib*, IFontFallbackBuilder** ffb, ::Coplt::FontFallbackBuilderCreateInfo const* info) noexcept;
     ::Coplt::i32 (*const COPLT_CDECL f_CreateLayout)(::Coplt::ILib*, ILayout** layout) noexcept;
     ::Coplt::i32 (*const COPLT_CDECL f_SplitTexts)(::Coplt::ILib*, ::Coplt::NativeList<::Coplt::TextRange>* ranges, ::Coplt::char16 const* chars, ::Coplt::i32 len) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_WarmUpLikelyLocales)(::Coplt::ILib*) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_SplitTextsBatch)(::Coplt::ILib*, ::Coplt::NativeList<::Coplt::TextRange>* ranges, ::Coplt::NativeList<::Coplt::i32>* offsets, ::Coplt::Str16 const* inputs, ::Coplt::i32 count, bool parallel) noexcept;
+    void (*const COPLT_CDECL f_GetArenaStats)(::Coplt::ILib*, ::Coplt::u64* used, ::Coplt::u64* peak) noexcept;
+    void (*const COPLT_CDECL f_SetTextMeasureCache)(::Coplt::ILib*, ::Coplt::u32 capacity, ::Coplt::f32 width_quantum) noexcept;
+    void (*const COPLT_CDECL f_SetParallelTextLayout)(::Coplt::ILib*, bool enable) noexcept;
+    void (*const COPLT_CDECL f_SetShapeCacheBudget)(::Coplt::ILib*, ::Coplt::u64 bytes) noexcept;
+    void (*const COPLT_CDECL f_GetShapeCacheStats)(::Coplt::ILib*, ::Coplt::u64* hits, ::Coplt::u64* misses, ::Coplt::u64* evictions, ::Coplt::u64* bytes, ::Coplt::u32* entries) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_CreatePathBuilder)(::Coplt::ILib*, IPathBuilder** pb) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_CreateTessellator)(::Coplt::ILib*, ITessellator** tess) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_CreateTessCache)(::Coplt::ILib*, IFrameSource* fs, ITessCache** cache) noexcept;
 };
 namespace Coplt::Internal::VirtualImpl_Coplt_ILib
 {
@@ -2097,6 +2109,16 @@ namespace Coplt::Internal::VirtualImpl_Coplt_ILib
     ::Coplt::i32 COPLT_CDECL CreateFontFallbackBuilder(::Coplt::ILib* self, IFontFallbackBuilder** p0, ::Coplt::FontFallbackBuilderCreateInfo const* p1) noexcept;
     ::Coplt::i32 COPLT_CDECL CreateLayout(::Coplt::ILib* self, ILayout** p0) noexcept;
     ::Coplt::i32 COPLT_CDECL SplitTexts(::Coplt::ILib* self, ::Coplt::NativeList<::Coplt::TextRange>* p0, ::Coplt::char16 const* p1, ::Coplt::i32 p2) noexcept;
+    ::Coplt::i32 COPLT_CDECL WarmUpLikelyLocales(::Coplt::ILib* self) noexcept;
+    ::Coplt::i32 COPLT_CDECL SplitTextsBatch(::Coplt::ILib* self, ::Coplt::NativeList<::Coplt::TextRange>* p0, ::Coplt::NativeList<::Coplt::i32>* p1, ::Coplt::Str16 const* p2, ::Coplt::i32 p3, bool p4) noexcept;
+    void COPLT_CDECL GetArenaStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1) noexcept;
+    void COPLT_CDECL SetTextMeasureCache(::Coplt::ILib* self, ::Coplt::u32 p0, ::Coplt::f32 p1) noexcept;
+    void COPLT_CDECL SetParallelTextLayout(::Coplt::ILib* self, bool p0) noexcept;
+    void COPLT_CDECL SetShapeCacheBudget(::Coplt::ILib* self, ::Coplt::u64 p0) noexcept;
+    void COPLT_CDECL GetShapeCacheStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept;
+    ::Coplt::i32 COPLT_CDECL CreatePathBuilder(::Coplt::ILib* self, IPathBuilder** p0) noexcept;
+    ::Coplt::i32 COPLT_CDECL CreateTessellator(::Coplt::ILib* self, ITessellator** p0) noexcept;
+    ::Coplt::i32 COPLT_CDECL CreateTessCache(::Coplt::ILib* self, IFrameSource* p0, ITessCache** p1) noexcept;
 }
 
 template <>
@@ -2140,6 +2162,16 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ILib>
             .f_CreateFontFallbackBuilder = VirtualImpl_Coplt_ILib::CreateFontFallbackBuilder,
             .f_CreateLayout = VirtualImpl_Coplt_ILib::CreateLayout,
             .f_SplitTexts = VirtualImpl_Coplt_ILib::SplitTexts,
+            .f_WarmUpLikelyLocales = VirtualImpl_Coplt_ILib::WarmUpLikelyLocales,
+            .f_SplitTextsBatch = VirtualImpl_Coplt_ILib::SplitTextsBatch,
+            .f_GetArenaStats = VirtualImpl_Coplt_ILib::GetArenaStats,
+            .f_SetTextMeasureCache = VirtualImpl_Coplt_ILib::SetTextMeasureCache,
+            .f_SetParallelTextLayout = VirtualImpl_Coplt_ILib::SetParallelTextLayout,
+            .f_SetShapeCacheBudget = VirtualImpl_Coplt_ILib::SetShapeCacheBudget,
+            .f_GetShapeCacheStats = VirtualImpl_Coplt_ILib::GetShapeCacheStats,
+            .f_CreatePathBuilder = VirtualImpl_Coplt_ILib::CreatePathBuilder,
+            .f_CreateTessellator = VirtualImpl_Coplt_ILib::CreateTessellator,
+            .f_CreateTessCache = VirtualImpl_Coplt_ILib::CreateTessCache,
         };
         return vtb;
     };
@@ -2158,6 +2190,16 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ILib>
         virtual ::Coplt::HResult Impl_CreateFontFallbackBuilder(IFontFallbackBuilder** ffb, ::Coplt::FontFallbackBuilderCreateInfo const* info) = 0;
         virtual ::Coplt::HResult Impl_CreateLayout(ILayout** layout) = 0;
         virtual ::Coplt::HResult Impl_SplitTexts(::Coplt::NativeList<::Coplt::TextRange>* ranges, ::Coplt::char16 const* chars, ::Coplt::i32 len) = 0;
+        virtual ::Coplt::HResult Impl_WarmUpLikelyLocales() = 0;
+        virtual ::Coplt::HResult Impl_SplitTextsBatch(::Coplt::NativeList<::Coplt::TextRange>* ranges, ::Coplt::NativeList<::Coplt::i32>* offsets, ::Coplt::Str16 const* inputs, ::Coplt::i32 count, bool parallel) = 0;
+        virtual void Impl_GetArenaStats(::Coplt::u64* used, ::Coplt::u64* peak) = 0;
+        virtual void Impl_SetTextMeasureCache(::Coplt::u32 capacity, ::Coplt::f32 width_quantum) = 0;
+        virtual void Impl_SetParallelTextLayout(bool enable) = 0;
+        virtual void Impl_SetShapeCacheBudget(::Coplt::u64 bytes) = 0;
+        virtual void Impl_GetShapeCacheStats(::Coplt::u64* hits, ::Coplt::u64* misses, ::Coplt::u64* evictions, ::Coplt::u64* bytes, ::Coplt::u32* entries) = 0;
+        virtual ::Coplt::HResult Impl_CreatePathBuilder(IPathBuilder** pb) = 0;
+        virtual ::Coplt::HResult Impl_CreateTessellator(ITessellator** tess) = 0;
+        virtual ::Coplt::HResult Impl_CreateTessCache(IFrameSource* fs, ITessCache** cache) = 0;
     };
 
     template <std::derived_from<::Coplt::ILib> Base = ::Coplt::ILib>
@@ -2230,6 +2272,56 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ILib>
         {
             return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_SplitTexts(p0, p1, p2));
         }
+
+        static ::Coplt::i32 COPLT_CDECL f_WarmUpLikelyLocales(::Coplt::ILib* self) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_WarmUpLikelyLocales());
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_SplitTextsBatch(::Coplt::ILib* self, ::Coplt::NativeList<::Coplt::TextRange>* p0, ::Coplt::NativeList<::Coplt::i32>* p1, ::Coplt::Str16 const* p2, ::Coplt::i32 p3, bool p4) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_SplitTextsBatch(p0, p1, p2, p3, p4));
+        }
+
+        static void COPLT_CDECL f_GetArenaStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1) noexcept
+        {
+            AsImpl(self)->Impl_GetArenaStats(p0, p1);
+        }
+
+        static void COPLT_CDECL f_SetTextMeasureCache(::Coplt::ILib* self, ::Coplt::u32 p0, ::Coplt::f32 p1) noexcept
+        {
+            AsImpl(self)->Impl_SetTextMeasureCache(p0, p1);
+        }
+
+        static void COPLT_CDECL f_SetParallelTextLayout(::Coplt::ILib* self, bool p0) noexcept
+        {
+            AsImpl(self)->Impl_SetParallelTextLayout(p0);
+        }
+
+        static void COPLT_CDECL f_SetShapeCacheBudget(::Coplt::ILib* self, ::Coplt::u64 p0) noexcept
+        {
+            AsImpl(self)->Impl_SetShapeCacheBudget(p0);
+        }
+
+        static void COPLT_CDECL f_GetShapeCacheStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept
+        {
+            AsImpl(self)->Impl_GetShapeCacheStats(p0, p1, p2, p3, p4);
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_CreatePathBuilder(::Coplt::ILib* self, IPathBuilder** p0) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_CreatePathBuilder(p0));
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_CreateTessellator(::Coplt::ILib* self, ITessellator** p0) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_CreateTessellator(p0));
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_CreateTessCache(::Coplt::ILib* self, IFrameSource* p0, ITessCache** p1) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_CreateTessCache(p0, p1));
+        }
     };
 
     template<class Impl>
@@ -2247,6 +2339,16 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ILib>
         .f_CreateFontFallbackBuilder = VirtualImpl<Impl>::f_CreateFontFallbackBuilder,
         .f_CreateLayout = VirtualImpl<Impl>::f_CreateLayout,
         .f_SplitTexts = VirtualImpl<Impl>::f_SplitTexts,
+        .f_WarmUpLikelyLocales = VirtualImpl<Impl>::f_WarmUpLikelyLocales,
+        .f_SplitTextsBatch = VirtualImpl<Impl>::f_SplitTextsBatch,
+        .f_GetArenaStats = VirtualImpl<Impl>::f_GetArenaStats,
+        .f_SetTextMeasureCache = VirtualImpl<Impl>::f_SetTextMeasureCache,
+        .f_SetParallelTextLayout = VirtualImpl<Impl>::f_SetParallelTextLayout,
+        .f_SetShapeCacheBudget = VirtualImpl<Impl>::f_SetShapeCacheBudget,
+        .f_GetShapeCacheStats = VirtualImpl<Impl>::f_GetShapeCacheStats,
+        .f_CreatePathBuilder = VirtualImpl<Impl>::f_CreatePathBuilder,
+        .f_CreateTessellator = VirtualImpl<Impl>::f_CreateTessellator,
+        .f_CreateTessCache = VirtualImpl<Impl>::f_CreateTessCache,
     };
 };
 namespace Coplt::Internal::VirtualImpl_Coplt_ILib
@@ -2391,6 +2493,131 @@ namespace Coplt::Internal::VirtualImpl_Coplt_ILib
         #endif
         return r;
     }
+
+    inline ::Coplt::i32 COPLT_CDECL WarmUpLikelyLocales(::Coplt::ILib* self) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, WarmUpLikelyLocales, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_WarmUpLikelyLocales());
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, WarmUpLikelyLocales, ::Coplt::i32)
+        #endif
+        return r;
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL SplitTextsBatch(::Coplt::ILib* self, ::Coplt::NativeList<::Coplt::TextRange>* p0, ::Coplt::NativeList<::Coplt::i32>* p1, ::Coplt::Str16 const* p2, ::Coplt::i32 p3, bool p4) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, SplitTextsBatch, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_SplitTextsBatch(p0, p1, p2, p3, p4));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, SplitTextsBatch, ::Coplt::i32)
+        #endif
+        return r;
+    }
+
+    inline void COPLT_CDECL GetArenaStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, GetArenaStats, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_GetArenaStats(p0, p1);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, GetArenaStats, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL SetTextMeasureCache(::Coplt::ILib* self, ::Coplt::u32 p0, ::Coplt::f32 p1) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, SetTextMeasureCache, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_SetTextMeasureCache(p0, p1);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, SetTextMeasureCache, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL SetParallelTextLayout(::Coplt::ILib* self, bool p0) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, SetParallelTextLayout, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_SetParallelTextLayout(p0);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, SetParallelTextLayout, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL SetShapeCacheBudget(::Coplt::ILib* self, ::Coplt::u64 p0) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, SetShapeCacheBudget, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_SetShapeCacheBudget(p0);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, SetShapeCacheBudget, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL GetShapeCacheStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, GetShapeCacheStats, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_GetShapeCacheStats(p0, p1, p2, p3, p4);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, GetShapeCacheStats, void)
+        #endif
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL CreatePathBuilder(::Coplt::ILib* self, IPathBuilder** p0) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, CreatePathBuilder, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_CreatePathBuilder(p0));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, CreatePathBuilder, ::Coplt::i32)
+        #endif
+        return r;
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL CreateTessellator(::Coplt::ILib* self, ITessellator** p0) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, CreateTessellator, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_CreateTessellator(p0));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, CreateTessellator, ::Coplt::i32)
+        #endif
+        return r;
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL CreateTessCache(::Coplt::ILib* self, IFrameSource* p0, ITessCache** p1) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ILib, CreateTessCache, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ILib>(self)->Impl_CreateTessCache(p0, p1));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ILib, CreateTessCache, ::Coplt::i32)
+        #endif
+        return r;
+    }
 }
 #define COPLT_COM_INTERFACE_BODY_Coplt_ILib\
     using Super = ::Coplt::IUnknown;\
@@ -2446,6 +2673,46 @@ struct ::Coplt::Internal::CallComMethod<::Coplt::ILib>
     {
         return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ILib, self)->f_SplitTexts(self, p0, p1, p2));
     }
+    static COPLT_FORCE_INLINE ::Coplt::HResult WarmUpLikelyLocales(::Coplt::ILib* self) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ILib, self)->f_WarmUpLikelyLocales(self));
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult SplitTextsBatch(::Coplt::ILib* self, ::Coplt::NativeList<::Coplt::TextRange>* p0, ::Coplt::NativeList<::Coplt::i32>* p1, ::Coplt::Str16 const* p2, ::Coplt::i32 p3, bool p4) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ILib, self)->f_SplitTextsBatch(self, p0, p1, p2, p3, p4));
+    }
+    static COPLT_FORCE_INLINE void GetArenaStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1) noexcept
+    {
+        COPLT_COM_PVTB(ILib, self)->f_GetArenaStats(self, p0, p1);
+    }
+    static COPLT_FORCE_INLINE void SetTextMeasureCache(::Coplt::ILib* self, ::Coplt::u32 p0, ::Coplt::f32 p1) noexcept
+    {
+        COPLT_COM_PVTB(ILib, self)->f_SetTextMeasureCache(self, p0, p1);
+    }
+    static COPLT_FORCE_INLINE void SetParallelTextLayout(::Coplt::ILib* self, bool p0) noexcept
+    {
+        COPLT_COM_PVTB(ILib, self)->f_SetParallelTextLayout(self, p0);
+    }
+    static COPLT_FORCE_INLINE void SetShapeCacheBudget(::Coplt::ILib* self, ::Coplt::u64 p0) noexcept
+    {
+        COPLT_COM_PVTB(ILib, self)->f_SetShapeCacheBudget(self, p0);
+    }
+    static COPLT_FORCE_INLINE void GetShapeCacheStats(::Coplt::ILib* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept
+    {
+        COPLT_COM_PVTB(ILib, self)->f_GetShapeCacheStats(self, p0, p1, p2, p3, p4);
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult CreatePathBuilder(::Coplt::ILib* self, IPathBuilder** p0) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ILib, self)->f_CreatePathBuilder(self, p0));
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult CreateTessellator(::Coplt::ILib* self, ITessellator** p0) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ILib, self)->f_CreateTessellator(self, p0));
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult CreateTessCache(::Coplt::ILib* self, IFrameSource* p0, ITessCache** p1) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ILib, self)->f_CreateTessCache(self, p0, p1));
+    }
 };
 
 template <>
@@ -2987,17 +3254,430 @@ struct ::Coplt::Internal::CallComMethod<::Coplt::IStub>
     }
 };
 
+template <>
+struct ::Coplt::Internal::VirtualTable<::Coplt::ITessCache>
+{
+    VirtualTable<::Coplt::IUnknown> b;
+    IFrameSource* (*const COPLT_CDECL f_GetFrameSource)(::Coplt::ITessCache*) noexcept;
+    void (*const COPLT_CDECL f_SetExpireFrame)(::Coplt::ITessCache*, ::Coplt::u64 FrameCount) noexcept;
+    void (*const COPLT_CDECL f_SetBudget)(::Coplt::ITessCache*, ::Coplt::u64 Bytes) noexcept;
+    void (*const COPLT_CDECL f_Collect)(::Coplt::ITessCache*) noexcept;
+    void (*const COPLT_CDECL f_Clear)(::Coplt::ITessCache*) noexcept;
+    void (*const COPLT_CDECL f_GetStats)(::Coplt::ITessCache*, ::Coplt::u64* hits, ::Coplt::u64* misses, ::Coplt::u64* evictions, ::Coplt::u64* bytes, ::Coplt::u32* entries) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_Fill)(::Coplt::ITessCache*, IPath* path, ::Coplt::TessFillOptions* options, ITessMesh** mesh) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_Stroke)(::Coplt::ITessCache*, IPath* path, ::Coplt::TessStrokeOptions* options, ITessMesh** mesh) noexcept;
+};
+namespace Coplt::Internal::VirtualImpl_Coplt_ITessCache
+{
+    IFrameSource* COPLT_CDECL GetFrameSource(::Coplt::ITessCache* self) noexcept;
+    void COPLT_CDECL SetExpireFrame(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept;
+    void COPLT_CDECL SetBudget(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept;
+    void COPLT_CDECL Collect(::Coplt::ITessCache* self) noexcept;
+    void COPLT_CDECL Clear(::Coplt::ITessCache* self) noexcept;
+    void COPLT_CDECL GetStats(::Coplt::ITessCache* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept;
+    ::Coplt::i32 COPLT_CDECL Fill(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessFillOptions* p1, ITessMesh** p2) noexcept;
+    ::Coplt::i32 COPLT_CDECL Stroke(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessStrokeOptions* p1, ITessMesh** p2) noexcept;
+}
+
+template <>
+struct ::Coplt::Internal::ComProxy<::Coplt::ITessCache>
+{
+    using VirtualTable = VirtualTable<::Coplt::ITessCache>;
+
+    static COPLT_FORCE_INLINE constexpr inline const ::Coplt::Guid& get_Guid()
+    {
+        static ::Coplt::Guid s_guid("9ebb41f9-ee12-4c68-8766-0b4b682c3268");
+        return s_guid;
+    }
+
+    template <class Self>
+    COPLT_FORCE_INLINE
+    static HResult QueryInterface(const Self* self, const ::Coplt::Guid& guid, COPLT_OUT void*& object)
+    {
+        if (guid == guid_of<::Coplt::ITessCache>())
+        {
+            object = const_cast<void*>(static_cast<const void*>(static_cast<const ::Coplt::ITessCache*>(self)));
+            self->AddRef();
+            return ::Coplt::HResultE::Ok;
+        }
+        return ComProxy<::Coplt::IUnknown>::QueryInterface(self, guid, object);
+    }
+
+    COPLT_FORCE_INLINE
+    static const VirtualTable& GetVtb()
+    {
+        static VirtualTable vtb
+        {
+            .b = ComProxy<::Coplt::IUnknown>::GetVtb(),
+            .f_GetFrameSource = VirtualImpl_Coplt_ITessCache::GetFrameSource,
+            .f_SetExpireFrame = VirtualImpl_Coplt_ITessCache::SetExpireFrame,
+            .f_SetBudget = VirtualImpl_Coplt_ITessCache::SetBudget,
+            .f_Collect = VirtualImpl_Coplt_ITessCache::Collect,
+            .f_Clear = VirtualImpl_Coplt_ITessCache::Clear,
+            .f_GetStats = VirtualImpl_Coplt_ITessCache::GetStats,
+            .f_Fill = VirtualImpl_Coplt_ITessCache::Fill,
+            .f_Stroke = VirtualImpl_Coplt_ITessCache::Stroke,
+        };
+        return vtb;
+    };
+
+    struct Impl : ComProxy<::Coplt::IUnknown>::Impl
+    {
+
+        virtual IFrameSource* Impl_GetFrameSource() = 0;
+        virtual void Impl_SetExpireFrame(::Coplt::u64 FrameCount) = 0;
+        virtual void Impl_SetBudget(::Coplt::u64 Bytes) = 0;
+        virtual void Impl_Collect() = 0;
+        virtual void Impl_Clear() = 0;
+        virtual void Impl_GetStats(::Coplt::u64* hits, ::Coplt::u64* misses, ::Coplt::u64* evictions, ::Coplt::u64* bytes, ::Coplt::u32* entries) = 0;
+        virtual ::Coplt::HResult Impl_Fill(IPath* path, ::Coplt::TessFillOptions* options, ITessMesh** mesh) = 0;
+        virtual ::Coplt::HResult Impl_Stroke(IPath* path, ::Coplt::TessStrokeOptions* options, ITessMesh** mesh) = 0;
+    };
+
+    template <std::derived_from<::Coplt::ITessCache> Base = ::Coplt::ITessCache>
+    struct Proxy : Impl, Base
+    {
+        explicit Proxy(const ::Coplt::Internal::VirtualTable<Base>* vtb) : Base(vtb) {}
+
+        explicit Proxy() : Base(&GetVtb()) {}
+    };
+    template <class Impl>
+    struct VirtualImpl
+    {
+        template <class Interface>
+        COPLT_FORCE_INLINE static auto AsImpl(const Interface* self) { return static_cast<const Impl*>(self); }
+        template <class Interface>
+        COPLT_FORCE_INLINE static auto AsImpl(Interface* self) { return static_cast<Impl*>(self); }
+
+        static IFrameSource* COPLT_CDECL f_GetFrameSource(::Coplt::ITessCache* self) noexcept
+        {
+            return AsImpl(self)->Impl_GetFrameSource();
+        }
+
+        static void COPLT_CDECL f_SetExpireFrame(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept
+        {
+            AsImpl(self)->Impl_SetExpireFrame(p0);
+        }
+
+        static void COPLT_CDECL f_SetBudget(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept
+        {
+            AsImpl(self)->Impl_SetBudget(p0);
+        }
+
+        static void COPLT_CDECL f_Collect(::Coplt::ITessCache* self) noexcept
+        {
+            AsImpl(self)->Impl_Collect();
+        }
+
+        static void COPLT_CDECL f_Clear(::Coplt::ITessCache* self) noexcept
+        {
+            AsImpl(self)->Impl_Clear();
+        }
+
+        static void COPLT_CDECL f_GetStats(::Coplt::ITessCache* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept
+        {
+            AsImpl(self)->Impl_GetStats(p0, p1, p2, p3, p4);
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_Fill(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessFillOptions* p1, ITessMesh** p2) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_Fill(p0, p1, p2));
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_Stroke(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessStrokeOptions* p1, ITessMesh** p2) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_Stroke(p0, p1, p2));
+        }
+    };
+
+    template<class Impl>
+    constexpr static VirtualTable s_vtb
+    {
+        .b = ComProxy<::Coplt::IUnknown>::s_vtb<Impl>,
+        .f_GetFrameSource = VirtualImpl<Impl>::f_GetFrameSource,
+        .f_SetExpireFrame = VirtualImpl<Impl>::f_SetExpireFrame,
+        .f_SetBudget = VirtualImpl<Impl>::f_SetBudget,
+        .f_Collect = VirtualImpl<Impl>::f_Collect,
+        .f_Clear = VirtualImpl<Impl>::f_Clear,
+        .f_GetStats = VirtualImpl<Impl>::f_GetStats,
+        .f_Fill = VirtualImpl<Impl>::f_Fill,
+        .f_Stroke = VirtualImpl<Impl>::f_Stroke,
+    };
+};
+namespace Coplt::Internal::VirtualImpl_Coplt_ITessCache
+{
+
+    inline IFrameSource* COPLT_CDECL GetFrameSource(::Coplt::ITessCache* self) noexcept
+    {
+        IFrameSource* r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, GetFrameSource, IFrameSource*)
+        #endif
+        r = ::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_GetFrameSource();
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, GetFrameSource, IFrameSource*)
+        #endif
+        return r;
+    }
+
+    inline void COPLT_CDECL SetExpireFrame(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, SetExpireFrame, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_SetExpireFrame(p0);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, SetExpireFrame, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL SetBudget(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, SetBudget, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_SetBudget(p0);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, SetBudget, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL Collect(::Coplt::ITessCache* self) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, Collect, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_Collect();
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, Collect, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL Clear(::Coplt::ITessCache* self) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, Clear, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_Clear();
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, Clear, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL GetStats(::Coplt::ITessCache* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, GetStats, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_GetStats(p0, p1, p2, p3, p4);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, GetStats, void)
+        #endif
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL Fill(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessFillOptions* p1, ITessMesh** p2) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, Fill, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_Fill(p0, p1, p2));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, Fill, ::Coplt::i32)
+        #endif
+        return r;
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL Stroke(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessStrokeOptions* p1, ITessMesh** p2) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessCache, Stroke, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ITessCache>(self)->Impl_Stroke(p0, p1, p2));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessCache, Stroke, ::Coplt::i32)
+        #endif
+        return r;
+    }
+}
+#define COPLT_COM_INTERFACE_BODY_Coplt_ITessCache\
+    using Super = ::Coplt::IUnknown;\
+    using Self = ::Coplt::ITessCache;\
+\
+    explicit ITessCache(const ::Coplt::Internal::VirtualTable<Self>* vtbl) : Super(&vtbl->b) {}
+
+template <>
+struct ::Coplt::Internal::CallComMethod<::Coplt::ITessCache>
+{
+    static COPLT_FORCE_INLINE IFrameSource* GetFrameSource(::Coplt::ITessCache* self) noexcept
+    {
+        return COPLT_COM_PVTB(ITessCache, self)->f_GetFrameSource(self);
+    }
+    static COPLT_FORCE_INLINE void SetExpireFrame(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept
+    {
+        COPLT_COM_PVTB(ITessCache, self)->f_SetExpireFrame(self, p0);
+    }
+    static COPLT_FORCE_INLINE void SetBudget(::Coplt::ITessCache* self, ::Coplt::u64 p0) noexcept
+    {
+        COPLT_COM_PVTB(ITessCache, self)->f_SetBudget(self, p0);
+    }
+    static COPLT_FORCE_INLINE void Collect(::Coplt::ITessCache* self) noexcept
+    {
+        COPLT_COM_PVTB(ITessCache, self)->f_Collect(self);
+    }
+    static COPLT_FORCE_INLINE void Clear(::Coplt::ITessCache* self) noexcept
+    {
+        COPLT_COM_PVTB(ITessCache, self)->f_Clear(self);
+    }
+    static COPLT_FORCE_INLINE void GetStats(::Coplt::ITessCache* self, ::Coplt::u64* p0, ::Coplt::u64* p1, ::Coplt::u64* p2, ::Coplt::u64* p3, ::Coplt::u32* p4) noexcept
+    {
+        COPLT_COM_PVTB(ITessCache, self)->f_GetStats(self, p0, p1, p2, p3, p4);
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult Fill(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessFillOptions* p1, ITessMesh** p2) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ITessCache, self)->f_Fill(self, p0, p1, p2));
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult Stroke(::Coplt::ITessCache* self, IPath* p0, ::Coplt::TessStrokeOptions* p1, ITessMesh** p2) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ITessCache, self)->f_Stroke(self, p0, p1, p2));
+    }
+};
+
+template <>
+struct ::Coplt::Internal::VirtualTable<::Coplt::ITessMesh>
+{
+    VirtualTable<::Coplt::IUnknown> b;
+    void (*const COPLT_CDECL f_GetData)(::Coplt::ITessMesh*, ::Coplt::f32 const** vertices, ::Coplt::i32* vertex_count, ::Coplt::u32 const** indices, ::Coplt::i32* index_count) noexcept;
+};
+namespace Coplt::Internal::VirtualImpl_Coplt_ITessMesh
+{
+    void COPLT_CDECL GetData(::Coplt::ITessMesh* self, ::Coplt::f32 const** p0, ::Coplt::i32* p1, ::Coplt::u32 const** p2, ::Coplt::i32* p3) noexcept;
+}
+
+template <>
+struct ::Coplt::Internal::ComProxy<::Coplt::ITessMesh>
+{
+    using VirtualTable = VirtualTable<::Coplt::ITessMesh>;
+
+    static COPLT_FORCE_INLINE constexpr inline const ::Coplt::Guid& get_Guid()
+    {
+        static ::Coplt::Guid s_guid("159c2428-d869-4fb4-a458-842bf871bcba");
+        return s_guid;
+    }
+
+    template <class Self>
+    COPLT_FORCE_INLINE
+    static HResult QueryInterface(const Self* self, const ::Coplt::Guid& guid, COPLT_OUT void*& object)
+    {
+        if (guid == guid_of<::Coplt::ITessMesh>())
+        {
+            object = const_cast<void*>(static_cast<const void*>(static_cast<const ::Coplt::ITessMesh*>(self)));
+            self->AddRef();
+            return ::Coplt::HResultE::Ok;
+        }
+        return ComProxy<::Coplt::IUnknown>::QueryInterface(self, guid, object);
+    }
+
+    COPLT_FORCE_INLINE
+    static const VirtualTable& GetVtb()
+    {
+        static VirtualTable vtb
+        {
+            .b = ComProxy<::Coplt::IUnknown>::GetVtb(),
+            .f_GetData = VirtualImpl_Coplt_ITessMesh::GetData,
+        };
+        return vtb;
+    };
+
+    struct Impl : ComProxy<::Coplt::IUnknown>::Impl
+    {
+
+        virtual void Impl_GetData(::Coplt::f32 const** vertices, ::Coplt::i32* vertex_count, ::Coplt::u32 const** indices, ::Coplt::i32* index_count) = 0;
+    };
+
+    template <std::derived_from<::Coplt::ITessMesh> Base = ::Coplt::ITessMesh>
+    struct Proxy : Impl, Base
+    {
+        explicit Proxy(const ::Coplt::Internal::VirtualTable<Base>* vtb) : Base(vtb) {}
+
+        explicit Proxy() : Base(&GetVtb()) {}
+    };
+    template <class Impl>
+    struct VirtualImpl
+    {
+        template <class Interface>
+        COPLT_FORCE_INLINE static auto AsImpl(const Interface* self) { return static_cast<const Impl*>(self); }
+        template <class Interface>
+        COPLT_FORCE_INLINE static auto AsImpl(Interface* self) { return static_cast<Impl*>(self); }
+
+        static void COPLT_CDECL f_GetData(::Coplt::ITessMesh* self, ::Coplt::f32 const** p0, ::Coplt::i32* p1, ::Coplt::u32 const** p2, ::Coplt::i32* p3) noexcept
+        {
+            AsImpl(self)->Impl_GetData(p0, p1, p2, p3);
+        }
+    };
+
+    template<class Impl>
+    constexpr static VirtualTable s_vtb
+    {
+        .b = ComProxy<::Coplt::IUnknown>::s_vtb<Impl>,
+        .f_GetData = VirtualImpl<Impl>::f_GetData,
+    };
+};
+namespace Coplt::Internal::VirtualImpl_Coplt_ITessMesh
+{
+
+    inline void COPLT_CDECL GetData(::Coplt::ITessMesh* self, ::Coplt::f32 const** p0, ::Coplt::i32* p1, ::Coplt::u32 const** p2, ::Coplt::i32* p3) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessMesh, GetData, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessMesh>(self)->Impl_GetData(p0, p1, p2, p3);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessMesh, GetData, void)
+        #endif
+    }
+}
+#define COPLT_COM_INTERFACE_BODY_Coplt_ITessMesh\
+    using Super = ::Coplt::IUnknown;\
+    using Self = ::Coplt::ITessMesh;\
+\
+    explicit ITessMesh(const ::Coplt::Internal::VirtualTable<Self>* vtbl) : Super(&vtbl->b) {}
+
+template <>
+struct ::Coplt::Internal::CallComMethod<::Coplt::ITessMesh>
+{
+    static COPLT_FORCE_INLINE void GetData(::Coplt::ITessMesh* self, ::Coplt::f32 const** p0, ::Coplt::i32* p1, ::Coplt::u32 const** p2, ::Coplt::i32* p3) noexcept
+    {
+        COPLT_COM_PVTB(ITessMesh, self)->f_GetData(self, p0, p1, p2, p3);
+    }
+};
+
 template <>
 struct ::Coplt::Internal::VirtualTable<::Coplt::ITessellator>
 {
     VirtualTable<::Coplt::IUnknown> b;
     ::Coplt::i32 (*const COPLT_CDECL f_Fill)(::Coplt::ITessellator*, IPath* path, ::Coplt::TessFillOptions* options) noexcept;
     ::Coplt::i32 (*const COPLT_CDECL f_Stroke)(::Coplt::ITessellator*, IPath* path, ::Coplt::TessStrokeOptions* options) noexcept;
+    void (*const COPLT_CDECL f_Clear)(::Coplt::ITessellator*) noexcept;
+    void (*const COPLT_CDECL f_GetMesh)(::Coplt::ITessellator*, ::Coplt::f32** vertices, ::Coplt::i32* vertex_count, ::Coplt::u32** indices, ::Coplt::i32* index_count) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_FillBatch)(::Coplt::ITessellator*, IPath* const* paths, ::Coplt::TessFillOptions const* options, ::Coplt::i32 count, ::Coplt::u32* vertex_offsets, ::Coplt::u32* index_offsets, bool parallel) noexcept;
+    ::Coplt::i32 (*const COPLT_CDECL f_StrokeBatch)(::Coplt::ITessellator*, IPath* const* paths, ::Coplt::TessStrokeOptions const* options, ::Coplt::i32 count, ::Coplt::u32* vertex_offsets, ::Coplt::u32* index_offsets, bool parallel) noexcept;
 };
 namespace Coplt::Internal::VirtualImpl_Coplt_ITessellator
 {
     ::Coplt::i32 COPLT_CDECL Fill(::Coplt::ITessellator* self, IPath* p0, ::Coplt::TessFillOptions* p1) noexcept;
     ::Coplt::i32 COPLT_CDECL Stroke(::Coplt::ITessellator* self, IPath* p0, ::Coplt::TessStrokeOptions* p1) noexcept;
+    void COPLT_CDECL Clear(::Coplt::ITessellator* self) noexcept;
+    void COPLT_CDECL GetMesh(::Coplt::ITessellator* self, ::Coplt::f32** p0, ::Coplt::i32* p1, ::Coplt::u32** p2, ::Coplt::i32* p3) noexcept;
+    ::Coplt::i32 COPLT_CDECL FillBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessFillOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept;
+    ::Coplt::i32 COPLT_CDECL StrokeBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessStrokeOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept;
 }
 
 template <>
@@ -3032,6 +3712,10 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ITessellator>
             .b = ComProxy<::Coplt::IUnknown>::GetVtb(),
             .f_Fill = VirtualImpl_Coplt_ITessellator::Fill,
             .f_Stroke = VirtualImpl_Coplt_ITessellator::Stroke,
+            .f_Clear = VirtualImpl_Coplt_ITessellator::Clear,
+            .f_GetMesh = VirtualImpl_Coplt_ITessellator::GetMesh,
+            .f_FillBatch = VirtualImpl_Coplt_ITessellator::FillBatch,
+            .f_StrokeBatch = VirtualImpl_Coplt_ITessellator::StrokeBatch,
         };
         return vtb;
     };
@@ -3041,6 +3725,10 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ITessellator>
 
         virtual ::Coplt::HResult Impl_Fill(IPath* path, ::Coplt::TessFillOptions* options) = 0;
         virtual ::Coplt::HResult Impl_Stroke(IPath* path, ::Coplt::TessStrokeOptions* options) = 0;
+        virtual void Impl_Clear() = 0;
+        virtual void Impl_GetMesh(::Coplt::f32** vertices, ::Coplt::i32* vertex_count, ::Coplt::u32** indices, ::Coplt::i32* index_count) = 0;
+        virtual ::Coplt::HResult Impl_FillBatch(IPath* const* paths, ::Coplt::TessFillOptions const* options, ::Coplt::i32 count, ::Coplt::u32* vertex_offsets, ::Coplt::u32* index_offsets, bool parallel) = 0;
+        virtual ::Coplt::HResult Impl_StrokeBatch(IPath* const* paths, ::Coplt::TessStrokeOptions const* options, ::Coplt::i32 count, ::Coplt::u32* vertex_offsets, ::Coplt::u32* index_offsets, bool parallel) = 0;
     };
 
     template <std::derived_from<::Coplt::ITessellator> Base = ::Coplt::ITessellator>
@@ -3067,6 +3755,26 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ITessellator>
         {
             return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_Stroke(p0, p1));
         }
+
+        static void COPLT_CDECL f_Clear(::Coplt::ITessellator* self) noexcept
+        {
+            AsImpl(self)->Impl_Clear();
+        }
+
+        static void COPLT_CDECL f_GetMesh(::Coplt::ITessellator* self, ::Coplt::f32** p0, ::Coplt::i32* p1, ::Coplt::u32** p2, ::Coplt::i32* p3) noexcept
+        {
+            AsImpl(self)->Impl_GetMesh(p0, p1, p2, p3);
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_FillBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessFillOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_FillBatch(p0, p1, p2, p3, p4, p5));
+        }
+
+        static ::Coplt::i32 COPLT_CDECL f_StrokeBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessStrokeOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept
+        {
+            return ::Coplt::Internal::BitCast<::Coplt::i32>(AsImpl(self)->Impl_StrokeBatch(p0, p1, p2, p3, p4, p5));
+        }
     };
 
     template<class Impl>
@@ -3075,6 +3783,10 @@ struct ::Coplt::Internal::ComProxy<::Coplt::ITessellator>
         .b = ComProxy<::Coplt::IUnknown>::s_vtb<Impl>,
         .f_Fill = VirtualImpl<Impl>::f_Fill,
         .f_Stroke = VirtualImpl<Impl>::f_Stroke,
+        .f_Clear = VirtualImpl<Impl>::f_Clear,
+        .f_GetMesh = VirtualImpl<Impl>::f_GetMesh,
+        .f_FillBatch = VirtualImpl<Impl>::f_FillBatch,
+        .f_StrokeBatch = VirtualImpl<Impl>::f_StrokeBatch,
     };
 };
 namespace Coplt::Internal::VirtualImpl_Coplt_ITessellator
@@ -3105,6 +3817,56 @@ namespace Coplt::Internal::VirtualImpl_Coplt_ITessellator
         #endif
         return r;
     }
+
+    inline void COPLT_CDECL Clear(::Coplt::ITessellator* self) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessellator, Clear, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessellator>(self)->Impl_Clear();
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessellator, Clear, void)
+        #endif
+    }
+
+    inline void COPLT_CDECL GetMesh(::Coplt::ITessellator* self, ::Coplt::f32** p0, ::Coplt::i32* p1, ::Coplt::u32** p2, ::Coplt::i32* p3) noexcept
+    {
+        struct { } r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessellator, GetMesh, void)
+        #endif
+        ::Coplt::Internal::AsImpl<::Coplt::ITessellator>(self)->Impl_GetMesh(p0, p1, p2, p3);
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessellator, GetMesh, void)
+        #endif
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL FillBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessFillOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessellator, FillBatch, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ITessellator>(self)->Impl_FillBatch(p0, p1, p2, p3, p4, p5));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessellator, FillBatch, ::Coplt::i32)
+        #endif
+        return r;
+    }
+
+    inline ::Coplt::i32 COPLT_CDECL StrokeBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessStrokeOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept
+    {
+        ::Coplt::i32 r;
+        #ifdef COPLT_COM_BEFORE_VIRTUAL_CALL
+        COPLT_COM_BEFORE_VIRTUAL_CALL(::Coplt::ITessellator, StrokeBatch, ::Coplt::i32)
+        #endif
+        r = ::Coplt::Internal::BitCast<::Coplt::i32>(::Coplt::Internal::AsImpl<::Coplt::ITessellator>(self)->Impl_StrokeBatch(p0, p1, p2, p3, p4, p5));
+        #ifdef COPLT_COM_AFTER_VIRTUAL_CALL
+        COPLT_COM_AFTER_VIRTUAL_CALL(::Coplt::ITessellator, StrokeBatch, ::Coplt::i32)
+        #endif
+        return r;
+    }
 }
 #define COPLT_COM_INTERFACE_BODY_Coplt_ITessellator\
     using Super = ::Coplt::IUnknown;\
@@ -3123,6 +3885,22 @@ struct ::Coplt::Internal::CallComMethod<::Coplt::ITessellator>
     {
         return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ITessellator, self)->f_Stroke(self, p0, p1));
     }
+    static COPLT_FORCE_INLINE void Clear(::Coplt::ITessellator* self) noexcept
+    {
+        COPLT_COM_PVTB(ITessellator, self)->f_Clear(self);
+    }
+    static COPLT_FORCE_INLINE void GetMesh(::Coplt::ITessellator* self, ::Coplt::f32** p0, ::Coplt::i32* p1, ::Coplt::u32** p2, ::Coplt::i32* p3) noexcept
+    {
+        COPLT_COM_PVTB(ITessellator, self)->f_GetMesh(self, p0, p1, p2, p3);
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult FillBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessFillOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ITessellator, self)->f_FillBatch(self, p0, p1, p2, p3, p4, p5));
+    }
+    static COPLT_FORCE_INLINE ::Coplt::HResult StrokeBatch(::Coplt::ITessellator* self, IPath* const* p0, ::Coplt::TessStrokeOptions const* p1, ::Coplt::i32 p2, ::Coplt::u32* p3, ::Coplt::u32* p4, bool p5) noexcept
+    {
+        return ::Coplt::Internal::BitCast<::Coplt::HResult>(COPLT_COM_PVTB(ITessellator, self)->f_StrokeBatch(self, p0, p1, p2, p3, p4, p5));
+    }
 };
 
 template <>
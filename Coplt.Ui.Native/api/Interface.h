@@ -127,6 +127,16 @@ namespace Coplt {
         COPLT_COM_METHOD(CreateFontFallbackBuilder, ::Coplt::HResult, (IFontFallbackBuilder** ffb, ::Coplt::FontFallbackBuilderCreateInfo const* info), ffb, info);
         COPLT_COM_METHOD(CreateLayout, ::Coplt::HResult, (ILayout** layout), layout);
         COPLT_COM_METHOD(SplitTexts, ::Coplt::HResult, (::Coplt::NativeList<::Coplt::TextRange>* ranges, ::Coplt::char16 const* chars, ::Coplt::i32 len), ranges, chars, len);
+        COPLT_COM_METHOD(WarmUpLikelyLocales, ::Coplt::HResult, ());
+        COPLT_COM_METHOD(SplitTextsBatch, ::Coplt::HResult, (::Coplt::NativeList<::Coplt::TextRange>* ranges, ::Coplt::NativeList<::Coplt::i32>* offsets, ::Coplt::Str16 const* inputs, ::Coplt::i32 count, bool parallel), ranges, offsets, inputs, count, parallel);
+        COPLT_COM_METHOD(GetArenaStats, void, (::Coplt::u64* used, ::Coplt::u64* peak), used, peak);
+        COPLT_COM_METHOD(SetTextMeasureCache, void, (::Coplt::u32 capacity, ::Coplt::f32 width_quantum), capacity, width_quantum);
+        COPLT_COM_METHOD(SetParallelTextLayout, void, (bool enable), enable);
+        COPLT_COM_METHOD(SetShapeCacheBudget, void, (::Coplt::u64 bytes), bytes);
+        COPLT_COM_METHOD(GetShapeCacheStats, void, (::Coplt::u64* hits, ::Coplt::u64* misses, ::Coplt::u64* evictions, ::Coplt::u64* bytes, ::Coplt::u32* entries), hits, misses, evictions, bytes, entries);
+        COPLT_COM_METHOD(CreatePathBuilder, ::Coplt::HResult, (IPathBuilder** pb), pb);
+        COPLT_COM_METHOD(CreateTessellator, ::Coplt::HResult, (ITessellator** tess), tess);
+        COPLT_COM_METHOD(CreateTessCache, ::Coplt::HResult, (IFrameSource* fs, ITessCache** cache), fs, cache);
     };
 
     COPLT_COM_INTERFACE(IPath, "dac7a459-b942-4a96-b7d6-ee5c74eca806", ::Coplt::IUnknown)
@@ -158,12 +168,37 @@ namespace Coplt {
         COPLT_COM_METHOD(Some, void, (::Coplt::NodeType a, ::Coplt::RootData* b, ::Coplt::NString* c), a, b, c);
     };
 
+    COPLT_COM_INTERFACE(ITessCache, "9ebb41f9-ee12-4c68-8766-0b4b682c3268", ::Coplt::IUnknown)
+    {
+        COPLT_COM_INTERFACE_BODY_Coplt_ITessCache
+
+        COPLT_COM_METHOD(GetFrameSource, IFrameSource*, ());
+        COPLT_COM_METHOD(SetExpireFrame, void, (::Coplt::u64 FrameCount), FrameCount);
+        COPLT_COM_METHOD(SetBudget, void, (::Coplt::u64 Bytes), Bytes);
+        COPLT_COM_METHOD(Collect, void, ());
+        COPLT_COM_METHOD(Clear, void, ());
+        COPLT_COM_METHOD(GetStats, void, (::Coplt::u64* hits, ::Coplt::u64* misses, ::Coplt::u64* evictions, ::Coplt::u64* bytes, ::Coplt::u32* entries), hits, misses, evictions, bytes, entries);
+        COPLT_COM_METHOD(Fill, ::Coplt::HResult, (IPath* path, ::Coplt::TessFillOptions* options, ITessMesh** mesh), path, options, mesh);
+        COPLT_COM_METHOD(Stroke, ::Coplt::HResult, (IPath* path, ::Coplt::TessStrokeOptions* options, ITessMesh** mesh), path, options, mesh);
+    };
+
+    COPLT_COM_INTERFACE(ITessMesh, "159c2428-d869-4fb4-a458-842bf871bcba", ::Coplt::IUnknown)
+    {
+        COPLT_COM_INTERFACE_BODY_Coplt_ITessMesh
+
+        COPLT_COM_METHOD(GetData, void, (::Coplt::f32 const** vertices, ::Coplt::i32* vertex_count, ::Coplt::u32 const** indices, ::Coplt::i32* index_count), vertices, vertex_count, indices, index_count);
+    };
+
     COPLT_COM_INTERFACE(ITessellator, "acf5d52e-a656-4c00-a528-09aa4d86b2b2", ::Coplt::IUnknown)
     {
         COPLT_COM_INTERFACE_BODY_Coplt_ITessellator
 
         COPLT_COM_METHOD(Fill, ::Coplt::HResult, (IPath* path, ::Coplt::TessFillOptions* options), path, options);
         COPLT_COM_METHOD(Stroke, ::Coplt::HResult, (IPath* path, ::Coplt::TessStrokeOptions* options), path, options);
+        COPLT_COM_METHOD(Clear, void, ());
+        COPLT_COM_METHOD(GetMesh, void, (::Coplt::f32** vertices, ::Coplt::i32* vertex_count, ::Coplt::u32** indices, ::Coplt::i32* index_count), vertices, vertex_count, indices, index_count);
+        COPLT_COM_METHOD(FillBatch, ::Coplt::HResult, (IPath* const* paths, ::Coplt::TessFillOptions const* options, ::Coplt::i32 count, ::Coplt::u32* vertex_offsets, ::Coplt::u32* index_offsets, bool parallel), paths, options, count, vertex_offsets, index_offsets, parallel);
+        COPLT_COM_METHOD(StrokeBatch, ::Coplt::HResult, (IPath* const* paths, ::Coplt::TessStrokeOptions const* options, ::Coplt::i32 count, ::Coplt::u32* vertex_offsets, ::Coplt::u32* index_offsets, bool parallel), paths, options, count, vertex_offsets, index_offsets, parallel);
     };
 
     COPLT_COM_INTERFACE(ITextData, "bd0c7402-1de8-4547-860d-c78fd70ff203", ::Coplt::IUnknown)
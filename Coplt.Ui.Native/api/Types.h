@@ -165,6 +165,10 @@ namespace Coplt {
 
     struct IStub;
 
+    struct ITessCache;
+
+    struct ITessMesh;
+
     struct ITessellator;
 
     struct ITextData;
@@ -181,6 +185,7 @@ namespace Coplt {
     {
         Common = 0,
         Bucketed = 1,
+        Shelf = 2,
     };
 
     enum class FillRule : ::Coplt::u8
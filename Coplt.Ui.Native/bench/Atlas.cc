@@ -0,0 +1,229 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../src/Com.h"
+#include "../src/ShelfAtlas.h"
+
+using namespace Coplt;
+
+extern "C" void coplt_ui_new_atlas_allocator(
+    AtlasAllocatorType t, i32 width, i32 height, IAtlasAllocator** output
+);
+
+namespace
+{
+    // Glyph-like sizes, mostly small with the occasional large emoji
+    std::vector<std::pair<i32, i32>> MakeSizes(const usize count)
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<i32> small(6, 32);
+        std::uniform_int_distribution<i32> large(48, 128);
+        std::uniform_int_distribution<i32> pick(0, 15);
+        std::vector<std::pair<i32, i32>> sizes;
+        sizes.reserve(count);
+        for (usize i = 0; i < count; ++i)
+        {
+            if (pick(rng) == 0) sizes.emplace_back(large(rng), large(rng));
+            else sizes.emplace_back(small(rng), small(rng));
+        }
+        return sizes;
+    }
+
+    Rc<IAtlasAllocator> CreateAtlas(const AtlasAllocatorType type, const i32 size)
+    {
+        if (type == AtlasAllocatorType::Shelf) return Rc<IAtlasAllocator>(new ShelfAtlasAllocator(size, size));
+        Rc<IAtlasAllocator> atlas{};
+        coplt_ui_new_atlas_allocator(type, size, size, atlas.put());
+        return atlas;
+    }
+
+    void BM_Allocate(benchmark::State& state, const AtlasAllocatorType type)
+    {
+        const auto sizes = MakeSizes(4096);
+        const auto atlas = CreateAtlas(type, static_cast<i32>(state.range(0)));
+        i64 allocated = 0;
+        for (auto _ : state)
+        {
+            atlas->Clear();
+            for (const auto [w, h] : sizes)
+            {
+                u32 id;
+                AABB2DI rect;
+                allocated += atlas->Allocate(w, h, &id, &rect);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * sizes.size());
+        state.counters["fill"] = benchmark::Counter(
+            static_cast<double>(allocated) / static_cast<double>(state.iterations() * sizes.size())
+        );
+    }
+
+    struct TraceOp
+    {
+        u32 Key;
+        i32 Width;
+        i32 Height;
+        bool Free;
+    };
+
+    constexpr i32 TraceGlyphs = 300;
+    constexpr i32 TraceSizes[] = {11, 12, 13, 14, 16, 18, 20, 24, 32, 48};
+    constexpr u32 TraceKeys = static_cast<u32>(std::size(TraceSizes)) * TraceGlyphs;
+
+    // What a glyph cache asks of its atlas over 600 frames of text: each stretch of frames uses a few font sizes,
+    // glyphs are drawn with a Zipf like frequency, added on first use and freed after 60 frames unused
+    const std::vector<TraceOp>& GlyphTrace()
+    {
+        static const auto s_trace = []
+        {
+            constexpr i32 Frames = 600;
+            constexpr i32 GlyphsPerFrame = 400;
+            constexpr u32 ExpireFrames = 60;
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<f32> unit(0, 1);
+            // Bitmap sizes with a pixel of padding, x height, cap height or with a descender
+            std::vector<std::pair<i32, i32>> dims(TraceKeys);
+            for (u32 key = 0; key < TraceKeys; ++key)
+            {
+                const auto size = static_cast<f32>(TraceSizes[key / TraceGlyphs]);
+                const f32 heights[] = {0.55f, 0.75f, 1.0f};
+                dims[key] = {
+                    static_cast<i32>(size * (0.3f + 0.6f * unit(rng))) + 2,
+                    static_cast<i32>(size * heights[rng() % 3] + unit(rng) * 2) + 2,
+                };
+            }
+            std::vector<TraceOp> trace;
+            std::vector<u32> last_used(TraceKeys, 0);
+            std::vector<bool> live(TraceKeys, false);
+            std::vector<i32> sizes;
+            for (u32 frame = 1; frame <= Frames; ++frame)
+            {
+                if (frame % 50 == 1)
+                {
+                    sizes.clear();
+                    for (auto n = 2 + rng() % 3; n > 0; --n)
+                        sizes.push_back(static_cast<i32>(rng() % std::size(TraceSizes)));
+                }
+                for (i32 i = 0; i < GlyphsPerFrame; ++i)
+                {
+                    const auto glyph = static_cast<u32>(std::pow(static_cast<f32>(TraceGlyphs), unit(rng))) - 1;
+                    const auto key = static_cast<u32>(sizes[rng() % sizes.size()]) * TraceGlyphs + glyph;
+                    if (!live[key]) trace.push_back({key, dims[key].first, dims[key].second, false});
+                    live[key] = true;
+                    last_used[key] = frame;
+                }
+                for (u32 key = 0; key < TraceKeys; ++key)
+                {
+                    if (!live[key] || frame - last_used[key] < ExpireFrames) continue;
+                    trace.push_back({key, dims[key].first, dims[key].second, true});
+                    live[key] = false;
+                }
+            }
+            return trace;
+        }();
+        return s_trace;
+    }
+
+    // Replays the trace, occupancy is the peak area of live rects over the atlas area, so the tighter packer gets
+    // further before the first failed allocation
+    void BM_GlyphTrace(benchmark::State& state, const AtlasAllocatorType type)
+    {
+        const auto& trace = GlyphTrace();
+        const auto size = static_cast<i32>(state.range(0));
+        const auto atlas = CreateAtlas(type, size);
+        std::vector<u32> ids(TraceKeys);
+        std::vector<bool> live;
+        i64 area = 0;
+        i64 peak = 0;
+        i64 failed = 0;
+        for (auto _ : state)
+        {
+            atlas->Clear();
+            live.assign(TraceKeys, false);
+            area = peak = failed = 0;
+            for (const auto& op : trace)
+            {
+                if (op.Free)
+                {
+                    if (!live[op.Key]) continue;
+                    atlas->Deallocate(ids[op.Key]);
+                    live[op.Key] = false;
+                    area -= op.Width * op.Height;
+                    continue;
+                }
+                AABB2DI rect;
+                if (!atlas->Allocate(op.Width, op.Height, &ids[op.Key], &rect))
+                {
+                    ++failed;
+                    continue;
+                }
+                live[op.Key] = true;
+                area += op.Width * op.Height;
+                peak = std::max(peak, area);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * trace.size());
+        state.counters["occupancy"] = static_cast<double>(peak) / (static_cast<double>(size) * size);
+        state.counters["failed"] = static_cast<double>(failed);
+    }
+
+    // Steady state of a glyph cache: free a random old entry, allocate a new one
+    void BM_Churn(benchmark::State& state, const AtlasAllocatorType type)
+    {
+        const auto sizes = MakeSizes(4096);
+        const auto atlas = CreateAtlas(type, static_cast<i32>(state.range(0)));
+        std::vector<u32> live;
+        for (const auto [w, h] : sizes)
+        {
+            u32 id;
+            AABB2DI rect;
+            if (atlas->Allocate(w, h, &id, &rect)) live.push_back(id);
+        }
+        if (live.empty())
+        {
+            state.SkipWithError("atlas too small");
+            return;
+        }
+        std::mt19937 rng(42);
+        usize i = 0;
+        for (auto _ : state)
+        {
+            const auto victim = std::uniform_int_distribution<usize>(0, live.size() - 1)(rng);
+            atlas->Deallocate(live[victim]);
+            const auto [w, h] = sizes[i++ % sizes.size()];
+            u32 id;
+            AABB2DI rect;
+            if (atlas->Allocate(w, h, &id, &rect)) live[victim] = id;
+            else
+            {
+                live[victim] = live.back();
+                live.pop_back();
+                if (live.empty()) break;
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK_CAPTURE(BM_Allocate, Common, AtlasAllocatorType::Common)
+    ->Name("Atlas/Allocate/Common")->Arg(1024)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Allocate, Bucketed, AtlasAllocatorType::Bucketed)
+    ->Name("Atlas/Allocate/Bucketed")->Arg(1024)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Allocate, Shelf, AtlasAllocatorType::Shelf)
+    ->Name("Atlas/Allocate/Shelf")->Arg(1024)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Churn, Common, AtlasAllocatorType::Common)
+    ->Name("Atlas/Churn/Common")->Arg(1024)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Churn, Bucketed, AtlasAllocatorType::Bucketed)
+    ->Name("Atlas/Churn/Bucketed")->Arg(1024)->Arg(4096);
+BENCHMARK_CAPTURE(BM_Churn, Shelf, AtlasAllocatorType::Shelf)
+    ->Name("Atlas/Churn/Shelf")->Arg(1024)->Arg(4096);
+BENCHMARK_CAPTURE(BM_GlyphTrace, Common, AtlasAllocatorType::Common)
+    ->Name("Atlas/GlyphTrace/Common")->Arg(512)->Arg(1024);
+BENCHMARK_CAPTURE(BM_GlyphTrace, Bucketed, AtlasAllocatorType::Bucketed)
+    ->Name("Atlas/GlyphTrace/Bucketed")->Arg(512)->Arg(1024);
+BENCHMARK_CAPTURE(BM_GlyphTrace, Shelf, AtlasAllocatorType::Shelf)
+    ->Name("Atlas/GlyphTrace/Shelf")->Arg(512)->Arg(1024);
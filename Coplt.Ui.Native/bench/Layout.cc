@@ -0,0 +1,153 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "../src/LayoutCommon.h"
+#include "../src/TextLayout.h"
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc;
+using namespace Coplt::LayoutCalc::Texts;
+
+namespace
+{
+    constexpr AvailableSpaceType AvailableSpaceTypes[] = {
+        AvailableSpaceType::Definite, AvailableSpaceType::MinContent, AvailableSpaceType::MaxContent,
+    };
+
+    std::vector<LayoutInputs> MakeInputs(const usize count, const LayoutRunMode mode)
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<u32> bit(0, 1);
+        std::uniform_int_distribution<u32> space(0, 2);
+        std::uniform_int_distribution<u32> px(0, 4);
+        std::vector<LayoutInputs> inputs;
+        inputs.reserve(count);
+        for (usize i = 0; i < count; ++i)
+        {
+            const auto w = static_cast<f32>(px(rng) * 100);
+            const auto h = static_cast<f32>(px(rng) * 20);
+            inputs.push_back(LayoutInputs(
+                mode, LayoutSizingMode::InherentSize, LayoutRequestedAxis::Both,
+                Size<std::optional<f32>>{
+                    .Width = bit(rng) ? std::optional{w} : std::nullopt,
+                    .Height = bit(rng) ? std::optional{h} : std::nullopt,
+                },
+                Size<std::optional<f32>>{.Width = 800.0f, .Height = 600.0f},
+                Size<AvailableSpace>{
+                    .Width = std::make_pair(AvailableSpaceTypes[space(rng)], w),
+                    .Height = std::make_pair(AvailableSpaceTypes[space(rng)], h),
+                }
+            ));
+        }
+        return inputs;
+    }
+
+    void BM_ComputeCacheSlot(benchmark::State& state)
+    {
+        const auto inputs = MakeInputs(1024, LayoutRunMode::ComputeSize);
+        for (auto _ : state)
+        {
+            u32 sum = 0;
+            for (const auto& input : inputs)
+            {
+                sum += ComputeCacheSlot(
+                    input.HasKnownWidth, input.HasKnownHeight,
+                    input.AvailableSpaceWidth, input.AvailableSpaceHeight
+                );
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * inputs.size());
+    }
+
+    void BM_TextLayoutCache_GetOutput(benchmark::State& state, const LayoutRunMode mode, const bool warm)
+    {
+        const auto inputs = MakeInputs(1024, mode);
+        TextLayoutCache cache{};
+        if (warm)
+        {
+            for (const auto& input : inputs)
+            {
+                if (mode == LayoutRunMode::PerformLayout)
+                    cache.StoreFinal(input, LayoutOutputFromOuterSize({input.KnownWidth, input.KnownHeight}));
+                else cache.StoreMeasure(input, input.KnownWidth, input.KnownHeight);
+            }
+        }
+        for (auto _ : state)
+        {
+            u32 hits = 0;
+            for (const auto& input : inputs) hits += cache.GetOutput(input).has_value();
+            benchmark::DoNotOptimize(hits);
+        }
+        state.SetItemsProcessed(state.iterations() * inputs.size());
+    }
+
+    void BM_Size_Resolve(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<u32> type(0, 2);
+        std::uniform_real_distribution<f32> value(0, 1);
+        constexpr LengthType types[] = {LengthType::Fixed, LengthType::Percent, LengthType::Auto};
+        std::vector<Size<Length>> sizes;
+        for (auto i = 0; i < 1024; ++i)
+        {
+            sizes.push_back(Size<Length>{
+                .Width = std::make_pair(types[type(rng)], value(rng) * 100),
+                .Height = std::make_pair(types[type(rng)], value(rng) * 100),
+            });
+        }
+        const Size<std::optional<f32>> parent{.Width = 800.0f, .Height = std::nullopt};
+        const Size<std::optional<f32>> min{.Width = 10.0f, .Height = std::nullopt};
+        const Size<std::optional<f32>> max{.Width = 500.0f, .Height = 300.0f};
+        const Size<f32> padding{.Width = 8, .Height = 4};
+        for (auto _ : state)
+        {
+            f32 sum = 0;
+            for (const auto& size : sizes)
+            {
+                const auto r = size.TryResolve(parent)
+                                   .TryApplyAspectRatio(1.5f)
+                                   .TryClamp(min, max)
+                                   .TryAdd(padding)
+                                   .Or(Size<f32>{0, 0});
+                sum += r.Width + r.Height;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * sizes.size());
+    }
+
+    void BM_Size_AvailableSpace(benchmark::State& state)
+    {
+        const auto inputs = MakeInputs(1024, LayoutRunMode::ComputeSize);
+        const Size<f32> padding{.Width = 8, .Height = 4};
+        const Size<std::optional<f32>> min{.Width = 10.0f, .Height = std::nullopt};
+        const Size<std::optional<f32>> max{.Width = 500.0f, .Height = 300.0f};
+        for (auto _ : state)
+        {
+            f32 sum = 0;
+            for (const auto& input : inputs)
+            {
+                const auto r = GetAvailableSpace(input)
+                               .TrySub(padding)
+                               .Normalize(GetKnownSize(input), min, max)
+                               .Or(GetKnownSize(input));
+                sum += r.Width.value_or(0) + r.Height.value_or(0);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * inputs.size());
+    }
+}
+
+BENCHMARK(BM_ComputeCacheSlot)->Name("Layout/ComputeCacheSlot");
+BENCHMARK_CAPTURE(BM_TextLayoutCache_GetOutput, ColdMeasure, LayoutRunMode::ComputeSize, false)
+    ->Name("TextLayoutCache/GetOutput/ColdMeasure");
+BENCHMARK_CAPTURE(BM_TextLayoutCache_GetOutput, WarmMeasure, LayoutRunMode::ComputeSize, true)
+    ->Name("TextLayoutCache/GetOutput/WarmMeasure");
+BENCHMARK_CAPTURE(BM_TextLayoutCache_GetOutput, WarmFinal, LayoutRunMode::PerformLayout, true)
+    ->Name("TextLayoutCache/GetOutput/WarmFinal");
+BENCHMARK(BM_Size_Resolve)->Name("Geometry/Size/Resolve");
+BENCHMARK(BM_Size_AvailableSpace)->Name("Geometry/Size/AvailableSpace");
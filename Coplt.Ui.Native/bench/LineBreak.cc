@@ -0,0 +1,183 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "../src/ClusterWidths.h"
+
+using namespace Coplt;
+
+namespace
+{
+    constexpr u16 ClusterStart = 1 << 4;
+
+    // Shaping output in the shape the dwrite backend keeps it, cluster maps are per run so runs stay short
+    struct ShapedRun
+    {
+        std::vector<u16> ClusterMap{};
+        std::vector<u8> CanBreakAfter{};
+        std::vector<u16> GlyphProps{};
+        std::vector<f32> Advances{};
+        std::vector<GlyphOffset> Offsets{};
+        std::vector<f32> ClusterWidths{};
+    };
+
+    std::vector<ShapedRun> MakeParagraph(const i32 chars)
+    {
+        constexpr i32 RunLength = 4000;
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<u32> percent(0, 99);
+        std::uniform_real_distribution<f32> advance(4.0f, 14.0f);
+        std::vector<ShapedRun> runs;
+        for (i32 start = 0; start < chars; start += RunLength)
+        {
+            auto& run = runs.emplace_back();
+            const auto len = std::min(RunLength, chars - start);
+            const auto add_glyph = [&](const bool cluster_start)
+            {
+                run.GlyphProps.push_back(cluster_start ? ClusterStart : 0);
+                run.Advances.push_back(cluster_start ? advance(rng) : 0.0f);
+                run.Offsets.push_back(GlyphOffset{.AdvanceOffset = cluster_start ? 0.0f : -1.5f, .AscenderOffset = 0});
+            };
+            for (i32 c = 0; c < len; ++c)
+            {
+                const auto glyph = static_cast<u16>(run.Advances.size());
+                const auto kind = percent(rng);
+                add_glyph(true);
+                run.ClusterMap.push_back(glyph);
+                // ~1 in 6 chars is a space
+                run.CanBreakAfter.push_back(kind % 6 == 0);
+                // Ligature, two chars share one glyph
+                if (kind < 5 && c + 1 < len)
+                {
+                    run.ClusterMap.push_back(glyph);
+                    run.CanBreakAfter.push_back(false);
+                    ++c;
+                }
+                // Combining mark, one char with two glyphs
+                else if (kind < 10) add_glyph(false);
+            }
+            run.ClusterWidths.resize(run.Advances.size());
+        }
+        return runs;
+    }
+
+    void ComputeWidths(std::vector<ShapedRun>& runs)
+    {
+        for (auto& run : runs)
+        {
+            ComputeClusterWidths(
+                run.ClusterWidths.data(), run.Advances.data(), run.Offsets.data(), run.GlyphProps.data(),
+                ClusterStart, static_cast<u32>(run.Advances.size())
+            );
+        }
+    }
+
+    // What the breaker did per cluster before widths were precomputed
+    f32 SumSize(const ShapedRun& run, const u16 first_cluster, const u16 last_cluster)
+    {
+        f32 sum_size = 0;
+        u32 i = first_cluster;
+        for (; i <= last_cluster; ++i) sum_size += run.Advances[i] + run.Offsets[i].AdvanceOffset;
+        for (; i < run.Advances.size(); ++i)
+        {
+            if (run.GlyphProps[i] & ClusterStart) break;
+            sum_size += run.Advances[i] + run.Offsets[i].AdvanceOffset;
+        }
+        return sum_size;
+    }
+
+    // Greedy breaking with the same cluster walk as Run::BreakLines, returns the line count
+    template <bool Precomputed>
+    u32 BreakParagraph(const std::vector<ShapedRun>& runs, const f32 width)
+    {
+        u32 lines = 1;
+        f32 offset = 0;
+        f32 since_break = 0;
+        bool has_break = false;
+        for (const auto& run : runs)
+        {
+            const auto len = static_cast<i32>(run.ClusterMap.size());
+            for (i32 c = 0; c < len;)
+            {
+                const auto first_cluster = run.ClusterMap[c];
+                while (c + 1 < len && run.ClusterMap[c + 1] == first_cluster) ++c;
+                const auto last_cluster = run.ClusterMap[c];
+                const auto size = Precomputed && first_cluster == last_cluster
+                    ? run.ClusterWidths[first_cluster]
+                    : SumSize(run, first_cluster, last_cluster);
+                offset += size;
+                since_break += size;
+                if (offset > width && has_break)
+                {
+                    lines++;
+                    offset = since_break;
+                    has_break = false;
+                }
+                if (run.CanBreakAfter[c])
+                {
+                    has_break = true;
+                    since_break = 0;
+                }
+                ++c;
+            }
+        }
+        return lines;
+    }
+
+    // A measure pass tries many widths against the same shaping output
+    std::vector<f32> MakeWidths()
+    {
+        std::vector<f32> widths;
+        for (auto w = 40.0f; w < 4000.0f; w *= 1.15f) widths.push_back(w);
+        return widths;
+    }
+
+    enum class Mode
+    {
+        // Re-derive every cluster width from the glyphs on each break
+        PerGlyph,
+        // Widths computed once after shaping, outside the timed region
+        Precomputed,
+        // Widths computed inside the timed region, so the kernel is paid once per set of widths
+        PrecomputedWithKernel,
+    };
+
+    void BM_BreakLines(benchmark::State& state, const Mode mode)
+    {
+        auto runs = MakeParagraph(static_cast<i32>(state.range(0)));
+        const auto widths = MakeWidths();
+        ComputeWidths(runs);
+        u64 lines = 0;
+        for (auto _ : state)
+        {
+            if (mode == Mode::PrecomputedWithKernel) ComputeWidths(runs);
+            for (const auto width : widths)
+            {
+                lines += mode == Mode::PerGlyph ? BreakParagraph<false>(runs, width) : BreakParagraph<true>(runs, width);
+            }
+            benchmark::DoNotOptimize(lines);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * widths.size());
+        state.counters["widths"] = static_cast<double>(widths.size());
+    }
+
+    void BM_ClusterWidths(benchmark::State& state)
+    {
+        auto runs = MakeParagraph(static_cast<i32>(state.range(0)));
+        usize glyphs = 0;
+        for (const auto& run : runs) glyphs += run.Advances.size();
+        for (auto _ : state)
+        {
+            ComputeWidths(runs);
+            benchmark::DoNotOptimize(runs.front().ClusterWidths.data());
+        }
+        state.SetItemsProcessed(state.iterations() * glyphs);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_BreakLines, PerGlyph, Mode::PerGlyph)->Name("LineBreak/PerGlyph")->Arg(100'000);
+BENCHMARK_CAPTURE(BM_BreakLines, Precomputed, Mode::Precomputed)->Name("LineBreak/Precomputed")->Arg(100'000);
+BENCHMARK_CAPTURE(BM_BreakLines, PrecomputedWithKernel, Mode::PrecomputedWithKernel)
+    ->Name("LineBreak/PrecomputedWithKernel")->Arg(100'000);
+BENCHMARK(BM_ClusterWidths)->Name("LineBreak/ClusterWidths")->Arg(100'000);
@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include "../src/List.h"
+#include "../src/SmallList.h"
+#include "../src/TextLayout.h"
+
+using namespace Coplt;
+
+namespace
+{
+    struct Item
+    {
+        f32 X;
+        f32 Y;
+        u32 Id;
+        u32 Flags;
+    };
+
+    template <class T>
+    T MakeItem(const i32 i)
+    {
+        if constexpr (std::same_as<T, Item>) return Item{static_cast<f32>(i), static_cast<f32>(i), static_cast<u32>(i), 0};
+        else if constexpr (std::same_as<T, LayoutCalc::Texts::TextScopeRange>)
+            return T{.ItemStart = static_cast<u32>(i), .ItemLength = 1, .Scope = static_cast<u32>(i)};
+        else return static_cast<T>(i);
+    }
+
+    template <class T, class L = List<T>>
+    void BM_Add(benchmark::State& state)
+    {
+        const auto count = static_cast<i32>(state.range(0));
+        for (auto _ : state)
+        {
+            L list{};
+            for (i32 i = 0; i < count; ++i) list.Add(MakeItem<T>(i));
+            benchmark::DoNotOptimize(list.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <class T>
+    void BM_AddReserved(benchmark::State& state)
+    {
+        const auto count = static_cast<i32>(state.range(0));
+        for (auto _ : state)
+        {
+            List<T> list{};
+            list.SetCapacity(count);
+            for (i32 i = 0; i < count; ++i) list.Add(MakeItem<T>(i));
+            benchmark::DoNotOptimize(list.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Reused list, the common pattern for per-layout scratch buffers
+    template <class T>
+    void BM_AddClear(benchmark::State& state)
+    {
+        const auto count = static_cast<i32>(state.range(0));
+        List<T> list{};
+        for (auto _ : state)
+        {
+            list.Clear();
+            for (i32 i = 0; i < count; ++i) list.Add(MakeItem<T>(i));
+            benchmark::DoNotOptimize(list.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <class T>
+    void BM_Iterate(benchmark::State& state)
+    {
+        const auto count = static_cast<i32>(state.range(0));
+        List<T> list{};
+        for (i32 i = 0; i < count; ++i) list.Add(MakeItem<T>(i));
+        for (auto _ : state)
+        {
+            u64 sum = 0;
+            for (const auto& item : list)
+            {
+                if constexpr (std::same_as<T, Item>) sum += item.Id;
+                else sum += static_cast<u64>(item);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <class L>
+    bool OwnsHeap(const L& list)
+    {
+        if constexpr (requires { list.IsInline(); }) return !list.IsInline();
+        else return list.data() != nullptr;
+    }
+
+    // Run count of each paragraph in a typical layout, most paragraphs are a single run
+    constexpr i32 LayoutRuns[] = {1, 1, 2, 1, 3, 1, 1, 5, 2, 1, 1, 12, 1, 2, 1, 4};
+
+    // Builds one short-lived run list per paragraph, returns the number of heap blocks it had to get
+    template <class L>
+    i32 BuildLayout()
+    {
+        using T = std::remove_pointer_t<decltype(std::declval<L&>().data())>;
+        i32 allocs = 0;
+        for (const auto runs : LayoutRuns)
+        {
+            L list{};
+            for (i32 i = 0; i < runs; ++i)
+            {
+                const auto before = list.data();
+                list.Add(MakeItem<T>(i));
+                if (list.data() != before && OwnsHeap(list)) allocs++;
+            }
+            benchmark::DoNotOptimize(list.data());
+        }
+        return allocs;
+    }
+
+    template <class L>
+    void BM_PerLayout(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(BuildLayout<L>());
+        }
+        state.counters["allocs_per_layout"] = BuildLayout<L>();
+        state.SetItemsProcessed(state.iterations() * std::size(LayoutRuns));
+    }
+}
+
+#define COPLT_BENCH_LIST(name, T) \
+    BENCHMARK(BM_Add<T>)->Name("List/Add/" name)->Arg(16)->Arg(1'000)->Arg(100'000); \
+    BENCHMARK(BM_AddReserved<T>)->Name("List/AddReserved/" name)->Arg(16)->Arg(1'000)->Arg(100'000); \
+    BENCHMARK(BM_AddClear<T>)->Name("List/AddClear/" name)->Arg(16)->Arg(1'000)->Arg(100'000); \
+    BENCHMARK(BM_Iterate<T>)->Name("List/Iterate/" name)->Arg(16)->Arg(1'000)->Arg(100'000); \
+    BENCHMARK(BM_Add<T, SmallList<T, 16>>)->Name("SmallList16/Add/" name)->Arg(16)->Arg(1'000)->Arg(100'000);
+
+COPLT_BENCH_LIST("u32", u32)
+COPLT_BENCH_LIST("Item", Item)
+
+BENCHMARK(BM_PerLayout<List<Item>>)->Name("List/PerLayout/List");
+BENCHMARK(BM_PerLayout<SmallList<Item, 4>>)->Name("List/PerLayout/SmallList4");
+BENCHMARK(BM_PerLayout<SmallList<Item, 8>>)->Name("List/PerLayout/SmallList8");
+// The scope ranges of every paragraph, before and after they kept their first items inline
+BENCHMARK(BM_PerLayout<List<LayoutCalc::Texts::TextScopeRange>>)->Name("List/PerLayout/ScopeRanges/List");
+BENCHMARK(BM_PerLayout<decltype(LayoutCalc::Texts::Paragraph::ScopeRanges)>)->Name("List/PerLayout/ScopeRanges/SmallList");
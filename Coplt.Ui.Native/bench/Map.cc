@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "../src/Map.h"
+#include "../src/FlatMap.h"
+
+using namespace Coplt;
+
+namespace
+{
+    struct NodeIdHash
+    {
+        static i32 GetHashCode(const NodeId& id)
+        {
+            return static_cast<i32>(id.Index ^ (id.IdAndType * 0x9E3779B9u));
+        }
+    };
+
+    struct NodeIdEq
+    {
+        static bool Equals(const NodeId& a, const NodeId& b)
+        {
+            return a.Index == b.Index && a.IdAndType == b.IdAndType;
+        }
+    };
+
+    template <class K>
+    struct Keys;
+
+    template <>
+    struct Keys<i32>
+    {
+        using Hash = DefaultHash<i32>;
+        using Eq = DefaultEq<i32>;
+
+        static i32 Make(const u64 i) { return static_cast<i32>(i * 2654435761u); }
+    };
+
+    template <>
+    struct Keys<void*>
+    {
+        using Hash = DefaultHash<void*>;
+        using Eq = DefaultEq<void*>;
+
+        // Looks like heap pointers, 16 bytes aligned and close together
+        static void* Make(const u64 i) { return reinterpret_cast<void*>(0x7f0000000000ull + i * 16); }
+    };
+
+    template <>
+    struct Keys<NodeId>
+    {
+        using Hash = NodeIdHash;
+        using Eq = NodeIdEq;
+
+        static NodeId Make(const u64 i) { return NodeId{static_cast<u32>(i), static_cast<u32>(i >> 32) << 2 | 1}; }
+    };
+
+    template <class K>
+    std::vector<K> MakeKeys(const i64 count, const u64 offset, const bool shuffle)
+    {
+        std::vector<K> keys;
+        keys.reserve(count);
+        for (i64 i = 0; i < count; ++i) keys.push_back(Keys<K>::Make(offset + i));
+        if (shuffle) std::ranges::shuffle(keys, std::mt19937_64(42));
+        return keys;
+    }
+
+    template <template <class, class, class, class> class M, class K>
+    using MapOf = M<K, i32, typename Keys<K>::Hash, typename Keys<K>::Eq>;
+
+    template <template <class, class, class, class> class M, class K>
+    void BM_Insert(benchmark::State& state)
+    {
+        const auto keys = MakeKeys<K>(state.range(0), 0, false);
+        for (auto _ : state)
+        {
+            MapOf<M, K> map{};
+            for (const auto& key : keys) map.TryAdd(key, 0);
+            benchmark::DoNotOptimize(map.Count());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <template <class, class, class, class> class M, class K>
+    void BM_FindHit(benchmark::State& state)
+    {
+        const auto keys = MakeKeys<K>(state.range(0), 0, false);
+        MapOf<M, K> map{};
+        for (const auto& key : keys) map.TryAdd(key, 1);
+        const auto lookups = MakeKeys<K>(state.range(0), 0, true);
+        for (auto _ : state)
+        {
+            i64 sum = 0;
+            for (const auto& key : lookups) sum += map.TryGet(key).GetValue();
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <template <class, class, class, class> class M, class K>
+    void BM_FindMiss(benchmark::State& state)
+    {
+        const auto keys = MakeKeys<K>(state.range(0), 0, false);
+        MapOf<M, K> map{};
+        for (const auto& key : keys) map.TryAdd(key, 1);
+        const auto lookups = MakeKeys<K>(state.range(0), state.range(0), true);
+        for (auto _ : state)
+        {
+            i64 found = 0;
+            for (const auto& key : lookups) found += static_cast<bool>(map.TryGet(key));
+            benchmark::DoNotOptimize(found);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    template <class K, class V, class H, class E>
+    using MapT = Map<K, V, H, E>;
+
+    template <class K, class V, class H, class E>
+    using FlatMapT = FlatMap<K, V, H, E>;
+}
+
+#define COPLT_BENCH_MAP(name, K) \
+    BENCHMARK(BM_Insert<MapT, K>)->Name("Map/Insert/" name)->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMicrosecond); \
+    BENCHMARK(BM_Insert<FlatMapT, K>)->Name("FlatMap/Insert/" name)->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMicrosecond); \
+    BENCHMARK(BM_FindHit<MapT, K>)->Name("Map/FindHit/" name)->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMicrosecond); \
+    BENCHMARK(BM_FindHit<FlatMapT, K>)->Name("FlatMap/FindHit/" name)->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMicrosecond); \
+    BENCHMARK(BM_FindMiss<MapT, K>)->Name("Map/FindMiss/" name)->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMicrosecond); \
+    BENCHMARK(BM_FindMiss<FlatMapT, K>)->Name("FlatMap/FindMiss/" name)->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMicrosecond);
+
+COPLT_BENCH_MAP("i32", i32)
+COPLT_BENCH_MAP("ptr", void*)
+COPLT_BENCH_MAP("NodeId", NodeId)
@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "../src/Path.h"
+
+using namespace Coplt;
+
+namespace
+{
+    // Icon-like paths, a few sub paths of lines, curves and the odd rounded corner
+    std::vector<std::vector<PathBuilderCmd>> MakeIcons(const usize count)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<f32> coord(0.0f, 24.0f);
+        std::uniform_int_distribution<i32> pick(0, 9);
+        std::vector<std::vector<PathBuilderCmd>> icons(count);
+        for (auto& cmds : icons)
+        {
+            const auto sub_paths = 1 + pick(rng) % 3;
+            for (i32 s = 0; s < sub_paths; ++s)
+            {
+                PathBuilderCmd cmd{};
+                cmd.XTo = {PathBuilderCmdType::MoveTo, coord(rng), coord(rng)};
+                cmds.push_back(cmd);
+                for (i32 i = 0; i < 8; ++i)
+                {
+                    const auto kind = pick(rng);
+                    if (kind < 5) cmd.XTo = {PathBuilderCmdType::LineTo, coord(rng), coord(rng)};
+                    else if (kind < 7)
+                        cmd.QuadraticBezierTo = {
+                            PathBuilderCmdType::QuadraticBezierTo, coord(rng), coord(rng), coord(rng), coord(rng)
+                        };
+                    else if (kind < 9)
+                        cmd.CubicBezierTo = {
+                            PathBuilderCmdType::CubicBezierTo, coord(rng), coord(rng), coord(rng), coord(rng),
+                            coord(rng), coord(rng)
+                        };
+                    else cmd.Arc = {PathBuilderCmdType::Arc, coord(rng), coord(rng), 2.0f, 2.0f, 1.5707964f, 0.0f};
+                    cmds.push_back(cmd);
+                }
+                cmd.Type = PathBuilderCmdType::Close;
+                cmds.push_back(cmd);
+            }
+        }
+        return icons;
+    }
+
+    // A frame worth of icons through one reused builder, each command a virtual call like single commands from C#
+    void BM_BuildIconsSingle(benchmark::State& state)
+    {
+        const auto icons = MakeIcons(static_cast<usize>(state.range(0)));
+        auto builder = Rc(new PathBuilder());
+        IPathBuilder* com = builder.get();
+        usize cmd_count = 0;
+        for (const auto& cmds : icons) cmd_count += cmds.size();
+        for (auto _ : state)
+        {
+            for (const auto& cmds : icons)
+            {
+                for (const auto& cmd : cmds)
+                {
+                    switch (cmd.Type)
+                    {
+                    case PathBuilderCmdType::Close:
+                        com->Close();
+                        break;
+                    case PathBuilderCmdType::MoveTo:
+                        com->MoveTo(cmd.XTo.X, cmd.XTo.Y);
+                        break;
+                    case PathBuilderCmdType::LineTo:
+                        com->LineTo(cmd.XTo.X, cmd.XTo.Y);
+                        break;
+                    case PathBuilderCmdType::QuadraticBezierTo:
+                    {
+                        const auto& c = cmd.QuadraticBezierTo;
+                        com->QuadraticBezierTo(c.CtrlX, c.CtrlY, c.ToX, c.ToY);
+                        break;
+                    }
+                    case PathBuilderCmdType::CubicBezierTo:
+                    {
+                        const auto& c = cmd.CubicBezierTo;
+                        com->CubicBezierTo(c.Ctrl0X, c.Ctrl0Y, c.Ctrl1X, c.Ctrl1Y, c.ToX, c.ToY);
+                        break;
+                    }
+                    case PathBuilderCmdType::Arc:
+                    {
+                        const auto& c = cmd.Arc;
+                        com->Arc(c.CenterX, c.CenterY, c.RadiiX, c.RadiiY, c.SweepAngle, c.XRotation);
+                        break;
+                    }
+                    }
+                }
+                Rc<IPath> path{};
+                com->Build(path.put());
+                benchmark::DoNotOptimize(path.get());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * cmd_count);
+    }
+
+    // Same icons, one Batch call per icon
+    void BM_BuildIconsBatch(benchmark::State& state)
+    {
+        const auto icons = MakeIcons(static_cast<usize>(state.range(0)));
+        auto builder = Rc(new PathBuilder());
+        IPathBuilder* com = builder.get();
+        usize cmd_count = 0;
+        for (const auto& cmds : icons) cmd_count += cmds.size();
+        for (auto _ : state)
+        {
+            for (const auto& cmds : icons)
+            {
+                com->Batch(cmds.data(), static_cast<i32>(cmds.size()));
+                Rc<IPath> path{};
+                com->Build(path.put());
+                benchmark::DoNotOptimize(path.get());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * cmd_count);
+    }
+
+    void BM_CalcAABB(benchmark::State& state)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<f32> coord(-1000.0f, 1000.0f);
+        std::vector<PathPoint> points(static_cast<usize>(state.range(0)));
+        for (auto& point : points) point = {coord(rng), coord(rng)};
+        for (auto _ : state)
+        {
+            auto aabb = CalcPointsAABB(points.data(), static_cast<u32>(points.size()));
+            benchmark::DoNotOptimize(aabb);
+        }
+        state.SetItemsProcessed(state.iterations() * points.size());
+    }
+}
+
+BENCHMARK(BM_BuildIconsSingle)->Name("Path/BuildIconsSingle")->Arg(4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BuildIconsBatch)->Name("Path/BuildIconsBatch")->Arg(4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CalcAABB)->Name("Path/CalcAABB")->Arg(16)->Arg(4096);
@@ -0,0 +1,220 @@
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <numbers>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../src/FrameSource.h"
+#include "../src/Path.h"
+#include "../src/TessCache.h"
+#include "../src/Tessellator.h"
+#include "../src/ThreadPool.h"
+
+using namespace Coplt;
+
+namespace
+{
+    constexpr f32 Pi = std::numbers::pi_v<f32>;
+
+    // The usual shapes of a 24 unit icon set: rounded frames, rings, stars, check marks and curvy blobs
+    std::vector<Rc<Path>> MakeIcons(const usize count)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<f32> coord(2.0f, 22.0f);
+        std::vector<Rc<Path>> icons;
+        icons.reserve(count);
+        PathBuilder builder{};
+        for (usize i = 0; i < count; ++i)
+        {
+            switch (i % 5)
+            {
+            case 0:
+            {
+                // Rounded rect
+                builder.MoveTo({6, 2});
+                builder.LineTo({18, 2});
+                builder.Arc({18, 6}, {4, 4}, Pi / 2, 0);
+                builder.LineTo({22, 18});
+                builder.Arc({18, 18}, {4, 4}, Pi / 2, 0);
+                builder.LineTo({6, 22});
+                builder.Arc({6, 18}, {4, 4}, Pi / 2, 0);
+                builder.LineTo({2, 6});
+                builder.Arc({6, 6}, {4, 4}, Pi / 2, 0);
+                builder.Close();
+                break;
+            }
+            case 1:
+            {
+                // Ring, the inner circle runs the other way
+                builder.MoveTo({22, 12});
+                builder.Arc({12, 12}, {10, 10}, 2 * Pi, 0);
+                builder.Close();
+                builder.MoveTo({18, 12});
+                builder.Arc({12, 12}, {6, 6}, -2 * Pi, 0);
+                builder.Close();
+                break;
+            }
+            case 2:
+            {
+                // Self intersecting star
+                for (i32 k = 0; k < 5; ++k)
+                {
+                    const auto angle = -Pi / 2 + static_cast<f32>(k * 2) * (2 * Pi / 5);
+                    const PathPoint point{12 + 10 * std::cos(angle), 12 + 10 * std::sin(angle)};
+                    if (k == 0) builder.MoveTo(point);
+                    else builder.LineTo(point);
+                }
+                builder.Close();
+                break;
+            }
+            case 3:
+            {
+                // Check mark
+                builder.MoveTo({4, 13});
+                builder.LineTo({9, 18});
+                builder.LineTo({20, 6});
+                builder.LineTo({18.5f, 4.5f});
+                builder.LineTo({9, 15});
+                builder.LineTo({5.5f, 11.5f});
+                builder.Close();
+                break;
+            }
+            default:
+            {
+                // Blob of random curves
+                builder.MoveTo({coord(rng), coord(rng)});
+                for (i32 k = 0; k < 6; ++k)
+                {
+                    if (k % 2 == 0) builder.QuadTo({coord(rng), coord(rng)}, {coord(rng), coord(rng)});
+                    else builder.CubicTo({coord(rng), coord(rng)}, {coord(rng), coord(rng)}, {coord(rng), coord(rng)});
+                }
+                builder.Close();
+                break;
+            }
+            }
+            icons.push_back(builder.Build());
+        }
+        return icons;
+    }
+
+    // The whole set into one reused mesh, as a frame of icons would be
+    void BM_FillIcons(benchmark::State& state)
+    {
+        const auto icons = MakeIcons(static_cast<usize>(state.range(0)));
+        const TessFillOptions options{
+            .ToLerance = 0.1f, .FillRule = FillRule::NonZero, .SweepOrientation = Orientation::Vertical,
+            .HandleIntersections = state.range(1) != 0,
+        };
+        auto tess = Rc(new Tessellator());
+        for (auto _ : state)
+        {
+            tess->Clear();
+            for (const auto& icon : icons) tess->Fill(*icon.get(), options);
+            benchmark::DoNotOptimize(tess->m_indices.data());
+        }
+        state.SetItemsProcessed(state.iterations() * icons.size());
+        state.counters["triangles"] = static_cast<double>(tess->m_indices.size() / 3);
+    }
+
+    // Pools cannot be torn down, keep one per thread count for the whole run
+    ThreadPool& PoolOf(const i32 threads)
+    {
+        static std::map<i32, ThreadPool*> s_pools;
+        auto& pool = s_pools[threads];
+        if (pool == nullptr) pool = new ThreadPool(threads - 1);
+        return *pool;
+    }
+
+    // A whole scene in one batch, the mesh is the same for every thread count
+    void BM_FillBatch(benchmark::State& state)
+    {
+        const auto icons = MakeIcons(static_cast<usize>(state.range(0)));
+        auto& pool = PoolOf(static_cast<i32>(state.range(1)));
+        const auto count = static_cast<i32>(icons.size());
+        std::vector<const IPath*> paths;
+        for (const auto& icon : icons) paths.push_back(icon.get());
+        const std::vector options(
+            icons.size(), TessFillOptions{
+                .ToLerance = 0.1f, .FillRule = FillRule::NonZero, .SweepOrientation = Orientation::Vertical,
+                .HandleIntersections = true,
+            }
+        );
+        std::vector<u32> vertex_offsets(count + 1);
+        std::vector<u32> index_offsets(count + 1);
+        auto tess = Rc(new Tessellator());
+        for (auto _ : state)
+        {
+            tess->Clear();
+            tess->FillBatch(paths.data(), options.data(), count, &pool, vertex_offsets.data(), index_offsets.data());
+            benchmark::DoNotOptimize(tess->m_indices.data());
+        }
+        state.SetItemsProcessed(state.iterations() * icons.size());
+        state.counters["threads"] = static_cast<double>(pool.Concurrency());
+        state.counters["triangles"] = static_cast<double>(tess->m_indices.size() / 3);
+    }
+
+    void ThreadCounts(benchmark::internal::Benchmark* b)
+    {
+        const auto max = static_cast<i64>(std::max(std::thread::hardware_concurrency(), 1u));
+        for (i64 threads = 1; threads < std::min<i64>(max, 16); threads *= 2) b->Args({50'000, threads});
+        b->Args({50'000, std::min<i64>(max, 16)});
+    }
+
+    // The same set through the cache frame after frame, all but the first frame only hit
+    void BM_FillIconsCached(benchmark::State& state)
+    {
+        const auto icons = MakeIcons(static_cast<usize>(state.range(0)));
+        const TessFillOptions options{
+            .ToLerance = 0.1f, .FillRule = FillRule::NonZero, .SweepOrientation = Orientation::Vertical,
+            .HandleIntersections = true,
+        };
+        auto frame_source = Rc(new FrameSource());
+        frame_source->AddRef();
+        auto cache = Rc(new TessCache(Rc<IFrameSource>(frame_source.get())));
+        for (auto _ : state)
+        {
+            ++frame_source->m_frame_time.NthFrame;
+            for (const auto& icon : icons)
+            {
+                auto mesh = cache->Fill(*icon.get(), options);
+                benchmark::DoNotOptimize(mesh->m_index_count);
+            }
+            cache->Collect();
+        }
+        state.SetItemsProcessed(state.iterations() * icons.size());
+        const auto stats = cache->Stats();
+        state.counters["entries"] = stats.Entries;
+        state.counters["hit_rate"] = static_cast<double>(stats.Hits) / static_cast<double>(stats.Hits + stats.Misses);
+    }
+
+    void BM_StrokeIcons(benchmark::State& state)
+    {
+        const auto icons = MakeIcons(static_cast<usize>(state.range(0)));
+        const TessStrokeOptions options{
+            .ToLerance = 0.1f, .LineWidth = 2.0f, .MiterLimit = 4.0f, .StartCap = LineCap::Round,
+            .EndCap = LineCap::Round, .LineJoin = static_cast<LineJoin>(state.range(1)),
+        };
+        auto tess = Rc(new Tessellator());
+        for (auto _ : state)
+        {
+            tess->Clear();
+            for (const auto& icon : icons) tess->Stroke(*icon.get(), options);
+            benchmark::DoNotOptimize(tess->m_indices.data());
+        }
+        state.SetItemsProcessed(state.iterations() * icons.size());
+        state.counters["triangles"] = static_cast<double>(tess->m_indices.size() / 3);
+    }
+}
+
+BENCHMARK(BM_FillIcons)->Name("Tess/FillIcons")->ArgNames({"icons", "intersections"})
+                       ->Args({1024, 1})->Args({1024, 0})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FillBatch)->Name("Tess/FillBatch")->ArgNames({"shapes", "threads"})->Apply(ThreadCounts)
+                       ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_FillIconsCached)->Name("Tess/FillIconsCached")->ArgNames({"icons"})
+                             ->Arg(1024)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StrokeIcons)->Name("Tess/StrokeIcons")->ArgNames({"icons", "join"})
+                         ->Args({1024, static_cast<int64_t>(LineJoin::Miter)})
+                         ->Args({1024, static_cast<int64_t>(LineJoin::Round)})
+                         ->Unit(benchmark::kMicrosecond);
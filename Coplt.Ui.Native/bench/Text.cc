@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "../src/Text.h"
+#include "../src/Icu.h"
+
+using namespace Coplt;
+
+namespace
+{
+    enum class Corpus
+    {
+        Ascii,
+        Cjk,
+        Mixed,
+    };
+
+    std::u16string MakeText(const Corpus corpus, const i64 len)
+    {
+        static constexpr std::u16string_view ascii = u"The quick brown fox jumps over the lazy dog, 0123456789. ";
+        static constexpr std::u16string_view cjk = u"我能吞下玻璃而不伤身体。私はガラスを食べられます。나는 유리를 먹을 수 있어요. ";
+        static constexpr std::u16string_view mixed = u"hello 你好 مرحبا שלום こんにちは Привет 😀 ok! ";
+        const auto src = corpus == Corpus::Ascii ? ascii : corpus == Corpus::Cjk ? cjk : mixed;
+        std::u16string text;
+        text.reserve(len + src.size());
+        while (static_cast<i64>(text.size()) < len) text.append(src);
+        text.resize(len);
+        // Never end the corpus in the middle of a surrogate pair
+        if (!text.empty() && U16_IS_LEAD(text.back())) text.back() = u' ';
+        return text;
+    }
+
+    void BM_SplitTexts(benchmark::State& state, const Corpus corpus)
+    {
+        const auto text = MakeText(corpus, state.range(0));
+        const auto str = reinterpret_cast<const char16*>(text.data());
+        const auto len = static_cast<i32>(text.size());
+        List<TextRange> ranges{};
+        for (auto _ : state)
+        {
+            ranges.Clear();
+            SplitTexts(ranges, str, len);
+            benchmark::DoNotOptimize(ranges.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(char16));
+        state.counters["ranges"] = ranges.Count();
+    }
+
+    // Many short labels, the way the document loader splits texts
+    void BM_SplitTextsBatch(benchmark::State& state, const bool parallel)
+    {
+        std::vector<std::u16string> texts;
+        std::vector<Str16> inputs;
+        texts.reserve(state.range(0));
+        for (i64 i = 0; i < state.range(0); ++i)
+        {
+            texts.push_back(MakeText(i % 4 == 0 ? Corpus::Mixed : Corpus::Ascii, 8 + i % 56));
+        }
+        for (const auto& text : texts)
+        {
+            inputs.push_back(Str16{
+                .Data = reinterpret_cast<const char16*>(text.data()),
+                .Size = static_cast<u32>(text.size()),
+            });
+        }
+        List<TextRange> ranges{};
+        List<i32> offsets{};
+        for (auto _ : state)
+        {
+            ranges.Clear();
+            offsets.Clear();
+            SplitTextsBatch(ranges, offsets, inputs.data(), static_cast<i32>(inputs.size()), parallel);
+            benchmark::DoNotOptimize(ranges.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_LikelyLocale(benchmark::State& state)
+    {
+        static constexpr UScriptCode scripts[] = {
+            USCRIPT_LATIN, USCRIPT_HAN, USCRIPT_HIRAGANA, USCRIPT_KATAKANA, USCRIPT_HANGUL,
+            USCRIPT_ARABIC, USCRIPT_HEBREW, USCRIPT_CYRILLIC, USCRIPT_GREEK, USCRIPT_THAI,
+            USCRIPT_DEVANAGARI, USCRIPT_COMMON, USCRIPT_INHERITED,
+        };
+        u64 i = 0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(UnicodeUtils::LikelyLocale(scripts[i++ % std::size(scripts)]));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+BENCHMARK_CAPTURE(BM_SplitTexts, Ascii, Corpus::Ascii)->Name("SplitTexts/Ascii")->Arg(64)->Arg(4'096)->Arg(524'288);
+BENCHMARK_CAPTURE(BM_SplitTexts, Cjk, Corpus::Cjk)->Name("SplitTexts/Cjk")->Arg(64)->Arg(4'096)->Arg(524'288);
+BENCHMARK_CAPTURE(BM_SplitTexts, Mixed, Corpus::Mixed)->Name("SplitTexts/Mixed")->Arg(64)->Arg(4'096)->Arg(524'288);
+BENCHMARK_CAPTURE(BM_SplitTextsBatch, Serial, false)->Name("SplitTextsBatch/Serial")->Arg(10'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SplitTextsBatch, Parallel, true)->Name("SplitTextsBatch/Parallel")->Arg(10'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LikelyLocale)->Name("UnicodeUtils/LikelyLocale");
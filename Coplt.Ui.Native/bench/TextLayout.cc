@@ -0,0 +1,289 @@
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/Arena.h"
+#include "../src/ClusterWidths.h"
+#include "../src/PackedLines.h"
+#include "../src/ThreadPool.h"
+#include "../src/dwrite/ShapeCache.h"
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc::Texts;
+
+namespace
+{
+    constexpr u16 ClusterStart = 1 << 4;
+
+    // Shaping output of one paragraph, the part of a text layout rebuild that runs per paragraph
+    struct Paragraph
+    {
+        std::vector<u16> ClusterMap{};
+        std::vector<u16> GlyphProps{};
+        std::vector<f32> Advances{};
+        std::vector<GlyphOffset> Offsets{};
+    };
+
+    // Lengths vary the way they do in a document, so workers finish their items at different times
+    std::vector<Paragraph> MakeDocument(const i32 paragraphs)
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<i32> length(20, 2000);
+        std::uniform_real_distribution<f32> advance(4.0f, 14.0f);
+        std::vector<Paragraph> document(paragraphs);
+        for (auto& paragraph : document)
+        {
+            const auto len = length(rng);
+            for (i32 c = 0; c < len; ++c)
+            {
+                paragraph.ClusterMap.push_back(static_cast<u16>(paragraph.Advances.size()));
+                paragraph.GlyphProps.push_back(ClusterStart);
+                paragraph.Advances.push_back(advance(rng));
+                paragraph.Offsets.push_back(GlyphOffset{});
+                // Combining mark
+                if (c % 13 == 0)
+                {
+                    paragraph.GlyphProps.push_back(0);
+                    paragraph.Advances.push_back(0.0f);
+                    paragraph.Offsets.push_back(GlyphOffset{.AdvanceOffset = -1.5f, .AscenderOffset = 0});
+                }
+            }
+        }
+        return document;
+    }
+
+    // Copies the shaping output into arena vectors and derives what the breaker reads, like ReBuildParagraph does
+    // with real analyzer output; returns the max-content width
+    f32 BuildParagraph(const Paragraph& paragraph, Arena& arena)
+    {
+        const auto count = static_cast<u32>(paragraph.Advances.size());
+        ArenaVector<f32> advances(paragraph.Advances.begin(), paragraph.Advances.end(), &arena);
+        ArenaVector<GlyphOffset> offsets(paragraph.Offsets.begin(), paragraph.Offsets.end(), &arena);
+        ArenaVector<u16> props(paragraph.GlyphProps.begin(), paragraph.GlyphProps.end(), &arena);
+        ArenaVector<f32> widths(count, &arena);
+        ComputeClusterWidths(widths.data(), advances.data(), offsets.data(), props.data(), ClusterStart, count);
+        f32 max_content = 0;
+        for (const auto cluster : paragraph.ClusterMap) max_content += widths[cluster];
+        return max_content;
+    }
+
+    // Pools cannot be torn down, keep one per thread count for the whole run
+    ThreadPool& PoolOf(const i32 threads)
+    {
+        static std::map<i32, ThreadPool*> s_pools;
+        auto& pool = s_pools[threads];
+        if (pool == nullptr) pool = new ThreadPool(threads - 1);
+        return *pool;
+    }
+
+    void BM_ParallelParagraphs(benchmark::State& state)
+    {
+        const auto document = MakeDocument(static_cast<i32>(state.range(0)));
+        auto& pool = PoolOf(static_cast<i32>(state.range(1)));
+        std::vector<std::unique_ptr<Arena>> arenas;
+        for (i32 i = 0; i < pool.Concurrency(); ++i) arenas.push_back(std::make_unique<Arena>());
+        std::vector<f32> results(document.size());
+        usize glyphs = 0;
+        for (const auto& paragraph : document) glyphs += paragraph.Advances.size();
+        for (auto _ : state)
+        {
+            for (const auto& arena : arenas) arena->Reset();
+            pool.ParallelForWorkers(
+                static_cast<i32>(document.size()), [&](const i32 worker, const i32 i)
+                {
+                    results[i] = BuildParagraph(document[i], *arenas[worker]);
+                }
+            );
+            benchmark::DoNotOptimize(results.data());
+        }
+        state.SetItemsProcessed(state.iterations() * glyphs);
+        state.counters["threads"] = static_cast<double>(pool.Concurrency());
+    }
+
+    // The cells of a table, a few distinct labels repeated over every row
+    std::vector<std::u16string> MakeLabels(const i32 rows, const i32 distinct)
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<i32> pick(0, distinct - 1);
+        std::vector<std::u16string> labels;
+        for (i32 i = 0; i < rows; ++i)
+        {
+            auto label = u"Label " + std::u16string(1, static_cast<char16_t>(u'A' + pick(rng) % 26));
+            label += static_cast<char16_t>(u'0' + pick(rng) % 10);
+            labels.push_back(std::move(label));
+        }
+        return labels;
+    }
+
+    // Fake shaping output for a label, one glyph per char
+    void ShapeLabel(const std::u16string& label, GlyphBuffer& glyphs, u32& char_start, u32& glyph_start)
+    {
+        const auto len = static_cast<u32>(label.size());
+        char_start = glyphs.AddChars(len);
+        glyph_start = glyphs.AddGlyphs(len);
+        for (u32 i = 0; i < len; ++i)
+        {
+            glyphs.m_cluster_map[char_start + i] = static_cast<u16>(i);
+            glyphs.m_text_props[char_start + i] = {};
+            glyphs.m_glyph_indices[glyph_start + i] = label[i];
+            glyphs.m_glyph_props[glyph_start + i] = DWRITE_SHAPING_GLYPH_PROPERTIES{.isClusterStart = 1};
+            glyphs.m_glyph_advances[glyph_start + i] = 7.0f;
+            glyphs.m_glyph_offsets[glyph_start + i] = {};
+        }
+        glyphs.ComputeClusterWidths(glyph_start, len);
+    }
+
+    // Looks every cell up in the shared cache the way ShapeRun does, shaping and storing on a miss
+    void BM_ShapeCacheLabels(benchmark::State& state)
+    {
+        const auto labels = MakeLabels(static_cast<i32>(state.range(0)), static_cast<i32>(state.range(1)));
+        auto& cache = ShapeCache::Shared();
+        cache.SetBudget(ShapeCache::DefaultBudget);
+        static constexpr std::u16string_view locale = u"en-us";
+        const ShapeCacheKey key{
+            .FontSize = 14.0f, .Script = {}, .Locale = reinterpret_cast<const char16*>(locale.data()), .Features = 0,
+            .IsRtl = false,
+        };
+        GlyphBuffer glyphs{};
+        const auto before = cache.Stats();
+        for (auto _ : state)
+        {
+            glyphs.Clear();
+            for (const auto& label : labels)
+            {
+                const std::span text(reinterpret_cast<const char16*>(label.data()), label.size());
+                const auto hash = ShapeCache::Hash(text, key);
+                if (cache.TryAppend(hash, text, key, glyphs) >= 0) continue;
+                u32 char_start, glyph_start;
+                ShapeLabel(label, glyphs, char_start, glyph_start);
+                cache.Store(hash, text, key, glyphs, char_start, glyph_start, static_cast<u32>(label.size()));
+            }
+            benchmark::DoNotOptimize(glyphs.m_glyph_indices);
+        }
+        const auto after = cache.Stats();
+        const auto lookups = static_cast<double>(after.Hits - before.Hits + after.Misses - before.Misses);
+        state.SetItemsProcessed(state.iterations() * labels.size());
+        state.counters["hit_rate"] = lookups == 0 ? 0 : static_cast<double>(after.Hits - before.Hits) / lookups;
+        state.counters["entries"] = after.Entries;
+        cache.Clear();
+    }
+
+    // Final spans and lines of a long paragraph as line breaking emits them, a few font sizes and runs of words
+    void MakeLines(
+        const i32 span_count, std::vector<LayoutCalc::ParagraphSpan>& spans, std::vector<u32>& runs,
+        std::vector<LayoutCalc::ParagraphLine>& lines
+    )
+    {
+        using namespace Coplt::LayoutCalc;
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<u32> word(1, 12);
+        std::uniform_int_distribution<i32> pick(0, 99);
+        constexpr f32 sizes[] = {12.0f, 14.0f, 20.0f};
+        u32 run = 0, char_end = 0, nth_line = 0, line_start = 0;
+        f32 offset = 0, font_size = sizes[0];
+        for (i32 i = 0; i < span_count; ++i)
+        {
+            if (pick(rng) < 5)
+            {
+                run++;
+                char_end = 0;
+                font_size = sizes[pick(rng) % std::size(sizes)];
+            }
+            const auto type = i % 2 == 0 ? ParagraphSpanType::Common : ParagraphSpanType::Space;
+            const auto length = type == ParagraphSpanType::Space ? 1 : word(rng);
+            const auto size = static_cast<f32>(length) * font_size * 0.55f;
+            if (offset + size > 600.0f)
+            {
+                lines.push_back(
+                    ParagraphLine{
+                        ParagraphLineInfo{.Ascent = font_size * 0.8f, .Descent = font_size * 0.2f},
+                        nth_line, 0, static_cast<f32>(nth_line) * font_size * 1.2f, offset, font_size * 1.2f,
+                        line_start, static_cast<u32>(i) - line_start,
+                    }
+                );
+                line_start = static_cast<u32>(i);
+                nth_line++;
+                offset = 0;
+            }
+            spans.push_back(
+                ParagraphSpan{
+                    .NthLine = nth_line,
+                    .CharStart = char_end,
+                    .CharLength = length,
+                    .GlyphStart = char_end,
+                    .GlyphLength = length,
+                    .Ascent = font_size * 0.8f,
+                    .Descent = font_size * 0.2f,
+                    .Offset = offset,
+                    .Size = size,
+                    .Type = type,
+                    .NeedReShape = false,
+                }
+            );
+            runs.push_back(run);
+            char_end += length;
+            offset += size;
+        }
+    }
+
+    // Memory of the final spans and lines of a paragraph, unpacked and packed, and the cost of packing
+    void BM_PackedLines(benchmark::State& state)
+    {
+        using namespace Coplt::LayoutCalc;
+        std::vector<ParagraphSpan> spans;
+        std::vector<u32> runs;
+        std::vector<ParagraphLine> lines;
+        MakeLines(static_cast<i32>(state.range(0)), spans, runs, lines);
+        PackedLines packed{};
+        for (auto _ : state)
+        {
+            packed = PackedLines::Pack(spans, runs, lines);
+            benchmark::DoNotOptimize(packed.m_spans.data());
+        }
+        const auto unpacked_bytes = spans.size() * sizeof(ParagraphSpan) + lines.size() * sizeof(ParagraphLine);
+        state.SetItemsProcessed(state.iterations() * spans.size());
+        state.counters["unpacked_bytes"] = static_cast<double>(unpacked_bytes);
+        state.counters["packed_bytes"] = static_cast<double>(packed.Bytes());
+        state.counters["wide_spans"] = static_cast<double>(packed.m_wide_spans.size());
+    }
+
+    // Sequential decode, what building the ffi line data costs
+    void BM_PackedLinesToLineData(benchmark::State& state)
+    {
+        using namespace Coplt::LayoutCalc;
+        std::vector<ParagraphSpan> spans;
+        std::vector<u32> runs;
+        std::vector<ParagraphLine> lines;
+        MakeLines(static_cast<i32>(state.range(0)), spans, runs, lines);
+        const auto packed = PackedLines::Pack(spans, runs, lines);
+        const std::vector<u32> run_starts(runs.back() + 1), run_nodes(runs.back() + 1);
+        std::vector<LineData> line_datas;
+        std::vector<LineSpanData> span_datas;
+        for (auto _ : state)
+        {
+            packed.ToLineData(WritingDirection::Horizontal, run_starts, run_nodes, line_datas, span_datas);
+            benchmark::DoNotOptimize(span_datas.data());
+        }
+        state.SetItemsProcessed(state.iterations() * spans.size());
+    }
+
+    void ThreadCounts(benchmark::internal::Benchmark* b)
+    {
+        const auto max = static_cast<i64>(std::max(std::thread::hardware_concurrency(), 1u));
+        for (i64 threads = 1; threads < max; threads *= 2) b->Args({1'000, threads});
+        b->Args({1'000, max});
+    }
+}
+
+BENCHMARK(BM_ParallelParagraphs)->Name("TextLayout/ParallelParagraphs")->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_ShapeCacheLabels)->Name("TextLayout/ShapeCacheLabels")->Args({20'000, 260})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PackedLines)->Name("TextLayout/PackedLines")->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PackedLinesToLineData)->Name("TextLayout/PackedLinesToLineData")->Arg(1'000'000)
+    ->Unit(benchmark::kMillisecond);
@@ -19,6 +19,8 @@ pub extern "C" fn coplt_ui_new_atlas_allocator(
             let obj = BucketedAtlasAllocator::new(width, height).make_com();
             unsafe { *output = obj.leak() };
         }
+        // created on the c++ side, a null output tells the caller the type is not served here
+        AtlasAllocatorType::Shelf => unsafe { *output = core::ptr::null_mut() },
     }
 }
 
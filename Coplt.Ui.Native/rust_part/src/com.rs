@@ -102,6 +102,16 @@ pub trait ILib : IUnknown {
     fn CreateFontFallbackBuilder(&mut self, ffb: *mut *mut IFontFallbackBuilder, info: *const FontFallbackBuilderCreateInfo) -> HResult;
     fn CreateLayout(&mut self, layout: *mut *mut ILayout) -> HResult;
     fn SplitTexts(&mut self, ranges: *mut NativeList<TextRange>, chars: *const u16, len: i32) -> HResult;
+    fn WarmUpLikelyLocales(&mut self) -> HResult;
+    fn SplitTextsBatch(&mut self, ranges: *mut NativeList<TextRange>, offsets: *mut NativeList<i32>, inputs: *const Str16, count: i32, parallel: bool) -> HResult;
+    fn GetArenaStats(&mut self, used: *mut u64, peak: *mut u64) -> ();
+    fn SetTextMeasureCache(&mut self, capacity: u32, width_quantum: f32) -> ();
+    fn SetParallelTextLayout(&mut self, enable: bool) -> ();
+    fn SetShapeCacheBudget(&mut self, bytes: u64) -> ();
+    fn GetShapeCacheStats(&mut self, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> ();
+    fn CreatePathBuilder(&mut self, pb: *mut *mut IPathBuilder) -> HResult;
+    fn CreateTessellator(&mut self, tess: *mut *mut ITessellator) -> HResult;
+    fn CreateTessCache(&mut self, fs: *mut IFrameSource, cache: *mut *mut ITessCache) -> HResult;
 }
 
 #[cocom::interface("dac7a459-b942-4a96-b7d6-ee5c74eca806")]
@@ -127,10 +137,31 @@ pub trait IStub : IUnknown {
     fn Some(&mut self, a: NodeType, b: *mut RootData, c: *mut NString) -> ();
 }
 
+#[cocom::interface("9ebb41f9-ee12-4c68-8766-0b4b682c3268")]
+pub trait ITessCache : IUnknown {
+    fn GetFrameSource(&mut self) -> *mut IFrameSource;
+    fn SetExpireFrame(&mut self, FrameCount: u64) -> ();
+    fn SetBudget(&mut self, Bytes: u64) -> ();
+    fn Collect(&mut self) -> ();
+    fn Clear(&mut self) -> ();
+    fn GetStats(&mut self, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> ();
+    fn Fill(&mut self, path: *mut IPath, options: *mut TessFillOptions, mesh: *mut *mut ITessMesh) -> HResult;
+    fn Stroke(&mut self, path: *mut IPath, options: *mut TessStrokeOptions, mesh: *mut *mut ITessMesh) -> HResult;
+}
+
+#[cocom::interface("159c2428-d869-4fb4-a458-842bf871bcba")]
+pub trait ITessMesh : IUnknown {
+    fn GetData(&mut self, vertices: *mut *const f32, vertex_count: *mut i32, indices: *mut *const u32, index_count: *mut i32) -> ();
+}
+
 #[cocom::interface("acf5d52e-a656-4c00-a528-09aa4d86b2b2")]
 pub trait ITessellator : IUnknown {
     fn Fill(&mut self, path: *mut IPath, options: *mut TessFillOptions) -> HResult;
     fn Stroke(&mut self, path: *mut IPath, options: *mut TessStrokeOptions) -> HResult;
+    fn Clear(&mut self) -> ();
+    fn GetMesh(&mut self, vertices: *mut *mut f32, vertex_count: *mut i32, indices: *mut *mut u32, index_count: *mut i32) -> ();
+    fn FillBatch(&mut self, paths: *const *mut IPath, options: *const TessFillOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult;
+    fn StrokeBatch(&mut self, paths: *const *mut IPath, options: *const TessStrokeOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult;
 }
 
 #[cocom::interface("bd0c7402-1de8-4547-860d-c78fd70ff203")]
@@ -153,6 +184,7 @@ pub enum StrKind {
 pub enum AtlasAllocatorType {
     Common = 0,
     Bucketed = 1,
+    Shelf = 2,
 }
 
 #[repr(u8)]
@@ -2430,6 +2462,16 @@ pub mod details {
         pub f_CreateFontFallbackBuilder: unsafe extern "C" fn(this: *const ILib, ffb: *mut *mut IFontFallbackBuilder, info: *const FontFallbackBuilderCreateInfo) -> HResult,
         pub f_CreateLayout: unsafe extern "C" fn(this: *const ILib, layout: *mut *mut ILayout) -> HResult,
         pub f_SplitTexts: unsafe extern "C" fn(this: *const ILib, ranges: *mut NativeList<TextRange>, chars: *const u16, len: i32) -> HResult,
+        pub f_WarmUpLikelyLocales: unsafe extern "C" fn(this: *const ILib) -> HResult,
+        pub f_SplitTextsBatch: unsafe extern "C" fn(this: *const ILib, ranges: *mut NativeList<TextRange>, offsets: *mut NativeList<i32>, inputs: *const Str16, count: i32, parallel: bool) -> HResult,
+        pub f_GetArenaStats: unsafe extern "C" fn(this: *const ILib, used: *mut u64, peak: *mut u64) -> (),
+        pub f_SetTextMeasureCache: unsafe extern "C" fn(this: *const ILib, capacity: u32, width_quantum: f32) -> (),
+        pub f_SetParallelTextLayout: unsafe extern "C" fn(this: *const ILib, enable: bool) -> (),
+        pub f_SetShapeCacheBudget: unsafe extern "C" fn(this: *const ILib, bytes: u64) -> (),
+        pub f_GetShapeCacheStats: unsafe extern "C" fn(this: *const ILib, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> (),
+        pub f_CreatePathBuilder: unsafe extern "C" fn(this: *const ILib, pb: *mut *mut IPathBuilder) -> HResult,
+        pub f_CreateTessellator: unsafe extern "C" fn(this: *const ILib, tess: *mut *mut ITessellator) -> HResult,
+        pub f_CreateTessCache: unsafe extern "C" fn(this: *const ILib, fs: *mut IFrameSource, cache: *mut *mut ITessCache) -> HResult,
     }
 
     impl<T: impls::ILib + impls::Object, O: impls::ObjectBox<Object = T>> VT<T, ILib, O>
@@ -2449,6 +2491,16 @@ pub mod details {
             f_CreateFontFallbackBuilder: Self::f_CreateFontFallbackBuilder,
             f_CreateLayout: Self::f_CreateLayout,
             f_SplitTexts: Self::f_SplitTexts,
+            f_WarmUpLikelyLocales: Self::f_WarmUpLikelyLocales,
+            f_SplitTextsBatch: Self::f_SplitTextsBatch,
+            f_GetArenaStats: Self::f_GetArenaStats,
+            f_SetTextMeasureCache: Self::f_SetTextMeasureCache,
+            f_SetParallelTextLayout: Self::f_SetParallelTextLayout,
+            f_SetShapeCacheBudget: Self::f_SetShapeCacheBudget,
+            f_GetShapeCacheStats: Self::f_GetShapeCacheStats,
+            f_CreatePathBuilder: Self::f_CreatePathBuilder,
+            f_CreateTessellator: Self::f_CreateTessellator,
+            f_CreateTessCache: Self::f_CreateTessCache,
         };
 
         unsafe extern "C" fn f_SetLogger(this: *const ILib, obj: *mut core::ffi::c_void, logger: unsafe extern "C" fn(*mut core::ffi::c_void, LogLevel, StrKind, i32, *mut core::ffi::c_void) -> (), is_enabled: unsafe extern "C" fn(*mut core::ffi::c_void, LogLevel) -> u8, drop: unsafe extern "C" fn(*mut core::ffi::c_void) -> ()) -> () {
@@ -2484,6 +2536,36 @@ pub mod details {
         unsafe extern "C" fn f_SplitTexts(this: *const ILib, ranges: *mut NativeList<TextRange>, chars: *const u16, len: i32) -> HResult {
             unsafe { (*O::GetObject(this as _)).SplitTexts(ranges, chars, len) }
         }
+        unsafe extern "C" fn f_WarmUpLikelyLocales(this: *const ILib) -> HResult {
+            unsafe { (*O::GetObject(this as _)).WarmUpLikelyLocales() }
+        }
+        unsafe extern "C" fn f_SplitTextsBatch(this: *const ILib, ranges: *mut NativeList<TextRange>, offsets: *mut NativeList<i32>, inputs: *const Str16, count: i32, parallel: bool) -> HResult {
+            unsafe { (*O::GetObject(this as _)).SplitTextsBatch(ranges, offsets, inputs, count, parallel) }
+        }
+        unsafe extern "C" fn f_GetArenaStats(this: *const ILib, used: *mut u64, peak: *mut u64) -> () {
+            unsafe { (*O::GetObject(this as _)).GetArenaStats(used, peak) }
+        }
+        unsafe extern "C" fn f_SetTextMeasureCache(this: *const ILib, capacity: u32, width_quantum: f32) -> () {
+            unsafe { (*O::GetObject(this as _)).SetTextMeasureCache(capacity, width_quantum) }
+        }
+        unsafe extern "C" fn f_SetParallelTextLayout(this: *const ILib, enable: bool) -> () {
+            unsafe { (*O::GetObject(this as _)).SetParallelTextLayout(enable) }
+        }
+        unsafe extern "C" fn f_SetShapeCacheBudget(this: *const ILib, bytes: u64) -> () {
+            unsafe { (*O::GetObject(this as _)).SetShapeCacheBudget(bytes) }
+        }
+        unsafe extern "C" fn f_GetShapeCacheStats(this: *const ILib, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> () {
+            unsafe { (*O::GetObject(this as _)).GetShapeCacheStats(hits, misses, evictions, bytes, entries) }
+        }
+        unsafe extern "C" fn f_CreatePathBuilder(this: *const ILib, pb: *mut *mut IPathBuilder) -> HResult {
+            unsafe { (*O::GetObject(this as _)).CreatePathBuilder(pb) }
+        }
+        unsafe extern "C" fn f_CreateTessellator(this: *const ILib, tess: *mut *mut ITessellator) -> HResult {
+            unsafe { (*O::GetObject(this as _)).CreateTessellator(tess) }
+        }
+        unsafe extern "C" fn f_CreateTessCache(this: *const ILib, fs: *mut IFrameSource, cache: *mut *mut ITessCache) -> HResult {
+            unsafe { (*O::GetObject(this as _)).CreateTessCache(fs, cache) }
+        }
     }
 
     impl<T: impls::ILib + impls::Object, O: impls::ObjectBox<Object = T>> Vtbl<O> for ILib
@@ -2712,6 +2794,145 @@ pub mod details {
         }
     }
 
+    #[repr(C)]
+    #[derive(Debug)]
+    pub struct VitualTable_ITessCache {
+        b: <IUnknown as Interface>::VitualTable,
+
+        pub f_GetFrameSource: unsafe extern "C" fn(this: *const ITessCache) -> *mut IFrameSource,
+        pub f_SetExpireFrame: unsafe extern "C" fn(this: *const ITessCache, FrameCount: u64) -> (),
+        pub f_SetBudget: unsafe extern "C" fn(this: *const ITessCache, Bytes: u64) -> (),
+        pub f_Collect: unsafe extern "C" fn(this: *const ITessCache) -> (),
+        pub f_Clear: unsafe extern "C" fn(this: *const ITessCache) -> (),
+        pub f_GetStats: unsafe extern "C" fn(this: *const ITessCache, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> (),
+        pub f_Fill: unsafe extern "C" fn(this: *const ITessCache, path: *mut IPath, options: *mut TessFillOptions, mesh: *mut *mut ITessMesh) -> HResult,
+        pub f_Stroke: unsafe extern "C" fn(this: *const ITessCache, path: *mut IPath, options: *mut TessStrokeOptions, mesh: *mut *mut ITessMesh) -> HResult,
+    }
+
+    impl<T: impls::ITessCache + impls::Object, O: impls::ObjectBox<Object = T>> VT<T, ITessCache, O>
+    where
+        T::Interface: details::QuIn<T::Interface, T, O>,
+    {
+        pub const VTBL: VitualTable_ITessCache = VitualTable_ITessCache {
+            b: <IUnknown as Vtbl<O>>::VTBL,
+            f_GetFrameSource: Self::f_GetFrameSource,
+            f_SetExpireFrame: Self::f_SetExpireFrame,
+            f_SetBudget: Self::f_SetBudget,
+            f_Collect: Self::f_Collect,
+            f_Clear: Self::f_Clear,
+            f_GetStats: Self::f_GetStats,
+            f_Fill: Self::f_Fill,
+            f_Stroke: Self::f_Stroke,
+        };
+
+        unsafe extern "C" fn f_GetFrameSource(this: *const ITessCache) -> *mut IFrameSource {
+            unsafe { (*O::GetObject(this as _)).GetFrameSource() }
+        }
+        unsafe extern "C" fn f_SetExpireFrame(this: *const ITessCache, FrameCount: u64) -> () {
+            unsafe { (*O::GetObject(this as _)).SetExpireFrame(FrameCount) }
+        }
+        unsafe extern "C" fn f_SetBudget(this: *const ITessCache, Bytes: u64) -> () {
+            unsafe { (*O::GetObject(this as _)).SetBudget(Bytes) }
+        }
+        unsafe extern "C" fn f_Collect(this: *const ITessCache) -> () {
+            unsafe { (*O::GetObject(this as _)).Collect() }
+        }
+        unsafe extern "C" fn f_Clear(this: *const ITessCache) -> () {
+            unsafe { (*O::GetObject(this as _)).Clear() }
+        }
+        unsafe extern "C" fn f_GetStats(this: *const ITessCache, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> () {
+            unsafe { (*O::GetObject(this as _)).GetStats(hits, misses, evictions, bytes, entries) }
+        }
+        unsafe extern "C" fn f_Fill(this: *const ITessCache, path: *mut IPath, options: *mut TessFillOptions, mesh: *mut *mut ITessMesh) -> HResult {
+            unsafe { (*O::GetObject(this as _)).Fill(path, options, mesh) }
+        }
+        unsafe extern "C" fn f_Stroke(this: *const ITessCache, path: *mut IPath, options: *mut TessStrokeOptions, mesh: *mut *mut ITessMesh) -> HResult {
+            unsafe { (*O::GetObject(this as _)).Stroke(path, options, mesh) }
+        }
+    }
+
+    impl<T: impls::ITessCache + impls::Object, O: impls::ObjectBox<Object = T>> Vtbl<O> for ITessCache
+    where
+        T::Interface: details::QuIn<T::Interface, T, O>,
+    {
+        const VTBL: <ITessCache as Interface>::VitualTable = VT::<T, ITessCache, O>::VTBL;
+
+        fn vtbl() -> &'static Self::VitualTable {
+            &<Self as Vtbl<O>>::VTBL
+        }
+    }
+
+    impl<T: impls::ITessCache + impls::Object, O: impls::ObjectBox<Object = T>> QuIn<ITessCache, T, O> for ITessCache {
+        #[inline(always)]
+        unsafe fn QueryInterface(
+            this: *mut T,
+            guid: Guid,
+            out: *mut *mut core::ffi::c_void,
+        ) -> HResult {
+            unsafe {
+                static GUID: Guid = ITessCache::GUID;
+                if guid == GUID {
+                    *out = this as _;
+                    O::AddRef(this as _);
+                    return HResultE::Ok.into();
+                }
+                <IUnknown as QuIn<IUnknown, T, O>>::QueryInterface(this, guid, out)
+            }
+        }
+    }
+
+    #[repr(C)]
+    #[derive(Debug)]
+    pub struct VitualTable_ITessMesh {
+        b: <IUnknown as Interface>::VitualTable,
+
+        pub f_GetData: unsafe extern "C" fn(this: *const ITessMesh, vertices: *mut *const f32, vertex_count: *mut i32, indices: *mut *const u32, index_count: *mut i32) -> (),
+    }
+
+    impl<T: impls::ITessMesh + impls::Object, O: impls::ObjectBox<Object = T>> VT<T, ITessMesh, O>
+    where
+        T::Interface: details::QuIn<T::Interface, T, O>,
+    {
+        pub const VTBL: VitualTable_ITessMesh = VitualTable_ITessMesh {
+            b: <IUnknown as Vtbl<O>>::VTBL,
+            f_GetData: Self::f_GetData,
+        };
+
+        unsafe extern "C" fn f_GetData(this: *const ITessMesh, vertices: *mut *const f32, vertex_count: *mut i32, indices: *mut *const u32, index_count: *mut i32) -> () {
+            unsafe { (*O::GetObject(this as _)).GetData(vertices, vertex_count, indices, index_count) }
+        }
+    }
+
+    impl<T: impls::ITessMesh + impls::Object, O: impls::ObjectBox<Object = T>> Vtbl<O> for ITessMesh
+    where
+        T::Interface: details::QuIn<T::Interface, T, O>,
+    {
+        const VTBL: <ITessMesh as Interface>::VitualTable = VT::<T, ITessMesh, O>::VTBL;
+
+        fn vtbl() -> &'static Self::VitualTable {
+            &<Self as Vtbl<O>>::VTBL
+        }
+    }
+
+    impl<T: impls::ITessMesh + impls::Object, O: impls::ObjectBox<Object = T>> QuIn<ITessMesh, T, O> for ITessMesh {
+        #[inline(always)]
+        unsafe fn QueryInterface(
+            this: *mut T,
+            guid: Guid,
+            out: *mut *mut core::ffi::c_void,
+        ) -> HResult {
+            unsafe {
+                static GUID: Guid = ITessMesh::GUID;
+                if guid == GUID {
+                    *out = this as _;
+                    O::AddRef(this as _);
+                    return HResultE::Ok.into();
+                }
+                <IUnknown as QuIn<IUnknown, T, O>>::QueryInterface(this, guid, out)
+            }
+        }
+    }
+
     #[repr(C)]
     #[derive(Debug)]
     pub struct VitualTable_ITessellator {
@@ -2719,6 +2940,10 @@ pub mod details {
 
         pub f_Fill: unsafe extern "C" fn(this: *const ITessellator, path: *mut IPath, options: *mut TessFillOptions) -> HResult,
         pub f_Stroke: unsafe extern "C" fn(this: *const ITessellator, path: *mut IPath, options: *mut TessStrokeOptions) -> HResult,
+        pub f_Clear: unsafe extern "C" fn(this: *const ITessellator) -> (),
+        pub f_GetMesh: unsafe extern "C" fn(this: *const ITessellator, vertices: *mut *mut f32, vertex_count: *mut i32, indices: *mut *mut u32, index_count: *mut i32) -> (),
+        pub f_FillBatch: unsafe extern "C" fn(this: *const ITessellator, paths: *const *mut IPath, options: *const TessFillOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult,
+        pub f_StrokeBatch: unsafe extern "C" fn(this: *const ITessellator, paths: *const *mut IPath, options: *const TessStrokeOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult,
     }
 
     impl<T: impls::ITessellator + impls::Object, O: impls::ObjectBox<Object = T>> VT<T, ITessellator, O>
@@ -2729,6 +2954,10 @@ pub mod details {
             b: <IUnknown as Vtbl<O>>::VTBL,
             f_Fill: Self::f_Fill,
             f_Stroke: Self::f_Stroke,
+            f_Clear: Self::f_Clear,
+            f_GetMesh: Self::f_GetMesh,
+            f_FillBatch: Self::f_FillBatch,
+            f_StrokeBatch: Self::f_StrokeBatch,
         };
 
         unsafe extern "C" fn f_Fill(this: *const ITessellator, path: *mut IPath, options: *mut TessFillOptions) -> HResult {
@@ -2737,6 +2966,18 @@ pub mod details {
         unsafe extern "C" fn f_Stroke(this: *const ITessellator, path: *mut IPath, options: *mut TessStrokeOptions) -> HResult {
             unsafe { (*O::GetObject(this as _)).Stroke(path, options) }
         }
+        unsafe extern "C" fn f_Clear(this: *const ITessellator) -> () {
+            unsafe { (*O::GetObject(this as _)).Clear() }
+        }
+        unsafe extern "C" fn f_GetMesh(this: *const ITessellator, vertices: *mut *mut f32, vertex_count: *mut i32, indices: *mut *mut u32, index_count: *mut i32) -> () {
+            unsafe { (*O::GetObject(this as _)).GetMesh(vertices, vertex_count, indices, index_count) }
+        }
+        unsafe extern "C" fn f_FillBatch(this: *const ITessellator, paths: *const *mut IPath, options: *const TessFillOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult {
+            unsafe { (*O::GetObject(this as _)).FillBatch(paths, options, count, vertex_offsets, index_offsets, parallel) }
+        }
+        unsafe extern "C" fn f_StrokeBatch(this: *const ITessellator, paths: *const *mut IPath, options: *const TessStrokeOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult {
+            unsafe { (*O::GetObject(this as _)).StrokeBatch(paths, options, count, vertex_offsets, index_offsets, parallel) }
+        }
     }
 
     impl<T: impls::ITessellator + impls::Object, O: impls::ObjectBox<Object = T>> Vtbl<O> for ITessellator
@@ -2955,6 +3196,16 @@ pub mod impls {
         fn CreateFontFallbackBuilder(&mut self, ffb: *mut *mut super::IFontFallbackBuilder, info: *const super::FontFallbackBuilderCreateInfo) -> HResult;
         fn CreateLayout(&mut self, layout: *mut *mut super::ILayout) -> HResult;
         fn SplitTexts(&mut self, ranges: *mut super::NativeList<super::TextRange>, chars: *const u16, len: i32) -> HResult;
+        fn WarmUpLikelyLocales(&mut self) -> HResult;
+        fn SplitTextsBatch(&mut self, ranges: *mut super::NativeList<super::TextRange>, offsets: *mut super::NativeList<i32>, inputs: *const super::Str16, count: i32, parallel: bool) -> HResult;
+        fn GetArenaStats(&mut self, used: *mut u64, peak: *mut u64) -> ();
+        fn SetTextMeasureCache(&mut self, capacity: u32, width_quantum: f32) -> ();
+        fn SetParallelTextLayout(&mut self, enable: bool) -> ();
+        fn SetShapeCacheBudget(&mut self, bytes: u64) -> ();
+        fn GetShapeCacheStats(&mut self, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> ();
+        fn CreatePathBuilder(&mut self, pb: *mut *mut super::IPathBuilder) -> HResult;
+        fn CreateTessellator(&mut self, tess: *mut *mut super::ITessellator) -> HResult;
+        fn CreateTessCache(&mut self, fs: *mut super::IFrameSource, cache: *mut *mut super::ITessCache) -> HResult;
     }
 
     pub trait IPath : IUnknown {
@@ -2977,9 +3228,28 @@ pub mod impls {
         fn Some(&mut self, a: super::NodeType, b: *mut super::RootData, c: *mut super::NString) -> ();
     }
 
+    pub trait ITessCache : IUnknown {
+        fn GetFrameSource(&mut self) -> *mut super::IFrameSource;
+        fn SetExpireFrame(&mut self, FrameCount: u64) -> ();
+        fn SetBudget(&mut self, Bytes: u64) -> ();
+        fn Collect(&mut self) -> ();
+        fn Clear(&mut self) -> ();
+        fn GetStats(&mut self, hits: *mut u64, misses: *mut u64, evictions: *mut u64, bytes: *mut u64, entries: *mut u32) -> ();
+        fn Fill(&mut self, path: *mut super::IPath, options: *mut super::TessFillOptions, mesh: *mut *mut super::ITessMesh) -> HResult;
+        fn Stroke(&mut self, path: *mut super::IPath, options: *mut super::TessStrokeOptions, mesh: *mut *mut super::ITessMesh) -> HResult;
+    }
+
+    pub trait ITessMesh : IUnknown {
+        fn GetData(&mut self, vertices: *mut *const f32, vertex_count: *mut i32, indices: *mut *const u32, index_count: *mut i32) -> ();
+    }
+
     pub trait ITessellator : IUnknown {
         fn Fill(&mut self, path: *mut super::IPath, options: *mut super::TessFillOptions) -> HResult;
         fn Stroke(&mut self, path: *mut super::IPath, options: *mut super::TessStrokeOptions) -> HResult;
+        fn Clear(&mut self) -> ();
+        fn GetMesh(&mut self, vertices: *mut *mut f32, vertex_count: *mut i32, indices: *mut *mut u32, index_count: *mut i32) -> ();
+        fn FillBatch(&mut self, paths: *const *mut super::IPath, options: *const super::TessFillOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult;
+        fn StrokeBatch(&mut self, paths: *const *mut super::IPath, options: *const super::TessStrokeOptions, count: i32, vertex_offsets: *mut u32, index_offsets: *mut u32, parallel: bool) -> HResult;
     }
 
     pub trait ITextData : IUnknown {
@@ -15,7 +15,7 @@ use std::{
 
 use dashmap::DashMap;
 
-use crate::{dwrite::FontFace, utils::ManagedHandle};
+use crate::utils::ManagedHandle;
 
 use super::com::*;
 use cocom::{
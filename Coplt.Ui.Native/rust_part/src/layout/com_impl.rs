@@ -4,6 +4,8 @@ use cocom::{ComPtr, HResultE};
 
 #[cfg(target_os = "windows")]
 use crate::dwrite;
+#[cfg(not(target_os = "windows"))]
+use crate::sysfont;
 use crate::{c_available_space, com::*, feb_hr};
 
 #[repr(C)]
@@ -20,6 +22,8 @@ pub struct FontRange {
 pub struct Layout {
     #[cfg(target_os = "windows")]
     pub(crate) inner: dwrite::DwLayout,
+    #[cfg(not(target_os = "windows"))]
+    pub(crate) inner: sysfont::SysLayout,
 }
 
 pub(crate) trait LayoutInner {
@@ -62,6 +62,27 @@ mod font_face_ops {
     }
 }
 
+#[cfg(not(target_os = "windows"))]
+mod font_face_ops {
+    use super::*;
+
+    pub fn get_font_ref(font_face: &'_ ComPtr<IFontFace>) -> &'_ FontRef<'_> {
+        use crate::sysfont::FontFace;
+        let font_face = unsafe { font_face.as_object::<FontFace>() };
+        font_face.font_ref()
+    }
+
+    pub fn get_glyph_type(
+        font_face: &ComPtr<IFontFace>,
+        glyph: u16,
+        not_exists: impl FnOnce() -> GlyphType,
+    ) -> GlyphType {
+        use crate::sysfont::FontFace;
+        let font_face = unsafe { font_face.as_object::<FontFace>() };
+        font_face.get_glyph_type(glyph, not_exists)
+    }
+}
+
 #[derive(Debug, Clone, Copy, Default)]
 struct RootConstants {
     dir: taffy::FlexDirection,
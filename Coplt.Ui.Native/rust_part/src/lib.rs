@@ -72,12 +72,15 @@ mod dwrite;
 mod font_manager;
 mod icu4c;
 mod layout;
-mod unicode_utils;
+#[cfg(not(target_os = "windows"))]
+mod sysfont;
 mod utf16;
 mod utils;
 
 #[cfg(target_os = "windows")]
 use dwrite::FontFace;
+#[cfg(not(target_os = "windows"))]
+use sysfont::FontFace;
 use taffy::{LengthPercentage, LengthPercentageAuto, ResolveOrZero};
 
 mod error_message {
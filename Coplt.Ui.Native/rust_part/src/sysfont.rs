@@ -0,0 +1,1083 @@
+use std::{
+    collections::{HashMap, HashSet},
+    ffi::c_void,
+    mem::MaybeUninit,
+    panic::{RefUnwindSafe, UnwindSafe},
+    path::{Path, PathBuf},
+    ptr::NonNull,
+    sync::{Arc, LazyLock, OnceLock, Weak},
+};
+
+use crate::{
+    c_option,
+    com::*,
+    feb_hr,
+    font_manager::FontManager,
+    layout::{FontRange, SubDocInner},
+    utils::ManagedHandle,
+};
+use cocom::{
+    ComPtr, ComWeak, HResult, HResultE, MakeObject,
+    object::{Object, ObjectPtr},
+};
+use dashmap::DashMap;
+use harfrust::FontRef;
+use read_fonts::{FileRef, TableProvider};
+use skrifa::{MetadataProvider, attribute::Style, string::StringId};
+
+/// Families tried in order when looking for the default ui family
+const DEFAULT_FAMILIES: &[&str] = &[
+    "Noto Sans",
+    "Cantarell",
+    "Ubuntu",
+    "DejaVu Sans",
+    "Liberation Sans",
+    "Roboto",
+    "Helvetica Neue",
+    "Helvetica",
+    "Arial",
+];
+
+const FONT_EXTENSIONS: &[&str] = &["ttf", "otf", "ttc", "otc"];
+
+#[derive(Debug)]
+struct FaceEntry {
+    path: Arc<Path>,
+    index: u32,
+    family: u32,
+    family_names: Vec<(String, String)>,
+    face_names: Vec<(String, String)>,
+    info: NFontInfo,
+    italic: bool,
+    /// sorted, merged, inclusive codepoint ranges, read from the cmap on the first char lookup
+    coverage: OnceLock<Vec<(u32, u32)>>,
+}
+
+impl FaceEntry {
+    fn coverage(&self) -> &[(u32, u32)] {
+        self.coverage.get_or_init(|| {
+            let Ok(data) = FontDb::get().load_data(self) else {
+                return vec![];
+            };
+            let Ok(font) = FontRef::from_index(&data, self.index) else {
+                return vec![];
+            };
+            let mut coverage: Vec<(u32, u32)> = vec![];
+            let mut chars: Vec<u32> = font.charmap().mappings().map(|(c, _)| c).collect();
+            chars.sort_unstable();
+            for c in chars {
+                match coverage.last_mut() {
+                    Some((_, end)) if c <= *end + 1 => *end = (*end).max(c),
+                    _ => coverage.push((c, c)),
+                }
+            }
+            coverage
+        })
+    }
+
+    pub fn has_char(&self, c: u32) -> bool {
+        match self.coverage().binary_search_by(|&(s, e)| {
+            if c < s {
+                std::cmp::Ordering::Greater
+            } else if c > e {
+                std::cmp::Ordering::Less
+            } else {
+                std::cmp::Ordering::Equal
+            }
+        }) {
+            Ok(_) => true,
+            Err(_) => false,
+        }
+    }
+}
+
+#[derive(Debug, Default)]
+struct FamilyEntry {
+    names: Vec<(String, String)>,
+    faces: Vec<u32>,
+}
+
+/// The system font database, scan the fontconfig style font directories once per process on the first lookup,
+/// only the names and attributes of each face are read up front
+#[derive(Debug)]
+pub struct FontDb {
+    faces: Vec<FaceEntry>,
+    families: Vec<FamilyEntry>,
+    name_to_family: HashMap<String, u32>,
+    /// None when no font was found, common on headless machines
+    default_family: Option<u32>,
+    files: DashMap<Arc<Path>, Weak<[u8]>>,
+    system_fallback_cache: DashMap<(u32, StyleKey), Option<u32>>,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct StyleKey {
+    weight: i32,
+    width: i32,
+    italic: bool,
+}
+
+impl StyleKey {
+    pub fn new(weight: FontWeight, width: FontWidth, italic: bool) -> Self {
+        Self {
+            weight: weight as i32,
+            width: (width.Width * 1000.0) as i32,
+            italic,
+        }
+    }
+
+    fn distance(&self, face: &FaceEntry) -> u32 {
+        let weight = (face.info.Weight as i32 - self.weight).unsigned_abs();
+        let width = ((face.info.Width.Width * 1000.0) as i32 - self.width).unsigned_abs();
+        let italic = if face.italic == self.italic {
+            0
+        } else {
+            100000
+        };
+        italic + width * 10 + weight
+    }
+}
+
+static FONT_DB: LazyLock<FontDb> = LazyLock::new(FontDb::load);
+
+impl FontDb {
+    pub fn get() -> &'static FontDb {
+        &FONT_DB
+    }
+
+    fn font_dirs() -> Vec<PathBuf> {
+        let mut dirs = vec![];
+        let home = std::env::var_os("HOME").map(PathBuf::from);
+        match std::env::var_os("XDG_DATA_HOME") {
+            Some(data_home) => dirs.push(PathBuf::from(data_home).join("fonts")),
+            None => {
+                if let Some(home) = &home {
+                    dirs.push(home.join(".local/share/fonts"));
+                }
+            }
+        }
+        if let Some(home) = &home {
+            dirs.push(home.join(".fonts"));
+        }
+        match std::env::var_os("XDG_DATA_DIRS") {
+            Some(data_dirs) => {
+                for dir in std::env::split_paths(&data_dirs) {
+                    dirs.push(dir.join("fonts"));
+                }
+            }
+            None => {
+                dirs.push(PathBuf::from("/usr/local/share/fonts"));
+                dirs.push(PathBuf::from("/usr/share/fonts"));
+            }
+        }
+        #[cfg(target_os = "macos")]
+        {
+            if let Some(home) = &home {
+                dirs.push(home.join("Library/Fonts"));
+            }
+            dirs.push(PathBuf::from("/Library/Fonts"));
+            dirs.push(PathBuf::from("/System/Library/Fonts"));
+        }
+        dirs
+    }
+
+    fn collect_files(dir: &Path, visited: &mut HashSet<PathBuf>, out: &mut Vec<PathBuf>) {
+        let Ok(dir) = dir.canonicalize() else { return };
+        if !visited.insert(dir.clone()) {
+            return;
+        }
+        let Ok(entries) = std::fs::read_dir(&dir) else {
+            return;
+        };
+        let mut entries: Vec<_> = entries.filter_map(|e| e.ok()).map(|e| e.path()).collect();
+        entries.sort();
+        for path in entries {
+            if path.is_dir() {
+                Self::collect_files(&path, visited, out);
+            } else if path
+                .extension()
+                .and_then(|e| e.to_str())
+                .is_some_and(|e| FONT_EXTENSIONS.iter().any(|f| e.eq_ignore_ascii_case(f)))
+            {
+                out.push(path);
+            }
+        }
+    }
+
+    fn load() -> Self {
+        let mut files = vec![];
+        let mut visited = HashSet::new();
+        for dir in Self::font_dirs() {
+            Self::collect_files(&dir, &mut visited, &mut files);
+        }
+
+        let mut db = Self {
+            faces: vec![],
+            families: vec![],
+            name_to_family: HashMap::new(),
+            default_family: None,
+            files: DashMap::new(),
+            system_fallback_cache: DashMap::new(),
+        };
+
+        for path in files {
+            let Ok(data) = std::fs::read(&path) else {
+                continue;
+            };
+            let path: Arc<Path> = path.into();
+            match FileRef::new(&data) {
+                Ok(FileRef::Font(font)) => db.add_face(&path, 0, &font),
+                Ok(FileRef::Collection(collection)) => {
+                    for index in 0..collection.len() {
+                        if let Ok(font) = collection.get(index) {
+                            db.add_face(&path, index, &font);
+                        }
+                    }
+                }
+                Err(_) => {}
+            }
+        }
+
+        db.default_family = DEFAULT_FAMILIES
+            .iter()
+            .find_map(|name| db.find_family(name))
+            .or((!db.families.is_empty()).then_some(0));
+
+        db
+    }
+
+    fn localized_names(font: &FontRef, id: StringId) -> Vec<(String, String)> {
+        font.localized_strings(id)
+            .map(|s| {
+                (
+                    s.language().unwrap_or_default().to_string(),
+                    s.chars().collect::<String>(),
+                )
+            })
+            .filter(|(_, name)| !name.is_empty())
+            .fold(vec![], |mut acc, item| {
+                if !acc.contains(&item) {
+                    acc.push(item);
+                }
+                acc
+            })
+    }
+
+    fn add_face(&mut self, path: &Arc<Path>, index: u32, font: &FontRef) {
+        let mut family_names = Self::localized_names(font, StringId::TYPOGRAPHIC_FAMILY_NAME);
+        if family_names.is_empty() {
+            family_names = Self::localized_names(font, StringId::FAMILY_NAME);
+        }
+        if family_names.is_empty() {
+            return;
+        }
+        let mut face_names = Self::localized_names(font, StringId::TYPOGRAPHIC_SUBFAMILY_NAME);
+        if face_names.is_empty() {
+            face_names = Self::localized_names(font, StringId::SUBFAMILY_NAME);
+        }
+
+        let attributes = font.attributes();
+        let mut flags = FontFlags::None;
+        if font.post().is_ok_and(|post| post.is_fixed_pitch() != 0) {
+            flags |= FontFlags::Monospaced;
+        }
+        if [b"COLR", b"CBDT", b"sbix", b"SVG "]
+            .into_iter()
+            .any(|tag| font.data_for_tag(font_types::Tag::new(tag)).is_some())
+        {
+            flags |= FontFlags::Color;
+        }
+        let info = NFontInfo {
+            Width: FontWidth {
+                Width: attributes.stretch.ratio(),
+            },
+            Weight: weight_from_value(attributes.weight.value()),
+            Flags: flags,
+        };
+        let italic = !matches!(attributes.style, Style::Normal);
+
+        let key = family_names
+            .iter()
+            .find(|(locale, _)| locale.starts_with("en"))
+            .unwrap_or(&family_names[0])
+            .1
+            .to_lowercase();
+        let face_index = self.faces.len() as u32;
+        let family = match self.name_to_family.get(&key) {
+            Some(&family) => family,
+            None => {
+                let family = self.families.len() as u32;
+                self.families.push(FamilyEntry {
+                    names: family_names.clone(),
+                    faces: vec![],
+                });
+                for (_, name) in family_names.iter() {
+                    self.name_to_family
+                        .entry(name.to_lowercase())
+                        .or_insert(family);
+                }
+                family
+            }
+        };
+        self.families[family as usize].faces.push(face_index);
+
+        self.faces.push(FaceEntry {
+            path: path.clone(),
+            index,
+            family,
+            family_names,
+            face_names,
+            info,
+            italic,
+            coverage: OnceLock::new(),
+        });
+    }
+
+    pub fn find_family(&self, name: &str) -> Option<u32> {
+        self.name_to_family.get(&name.to_lowercase()).copied()
+    }
+
+    /// Find the best matching face in family that contains the char
+    pub fn match_face(&self, family: u32, style: StyleKey, c: Option<u32>) -> Option<u32> {
+        self.families
+            .get(family as usize)?
+            .faces
+            .iter()
+            .copied()
+            .filter(|&face| c.is_none_or(|c| self.faces[face as usize].has_char(c)))
+            .min_by_key(|&face| style.distance(&self.faces[face as usize]))
+    }
+
+    /// Default family first, then every family in scan order
+    pub fn match_system(&self, style: StyleKey, c: u32) -> Option<u32> {
+        if let Some(face) = self.system_fallback_cache.get(&(c, style)) {
+            return *face;
+        }
+        // has_char may read font files, so this must not run under the lock of a map shard
+        let face = self
+            .default_family
+            .and_then(|family| self.match_face(family, style, Some(c)))
+            .or_else(|| {
+                (0..self.families.len() as u32)
+                    .find_map(|family| self.match_face(family, style, Some(c)))
+            });
+        self.system_fallback_cache.insert((c, style), face);
+        face
+    }
+
+    pub fn face_id(face: u32) -> u64 {
+        face as u64 + 1
+    }
+
+    fn load_data(&self, face: &FaceEntry) -> anyhow::Result<Arc<[u8]>> {
+        if let Some(data) = self.files.get(&face.path).and_then(|a| a.upgrade()) {
+            return Ok(data);
+        }
+        let data: Arc<[u8]> = std::fs::read(&face.path)?.into();
+        self.files.insert(face.path.clone(), Arc::downgrade(&data));
+        Ok(data)
+    }
+}
+
+fn weight_from_value(value: f32) -> FontWeight {
+    match value as i32 {
+        ..=150 => FontWeight::Thin,
+        151..=250 => FontWeight::ExtraLight,
+        251..=325 => FontWeight::Light,
+        326..=375 => FontWeight::SemiLight,
+        376..=450 => FontWeight::Normal,
+        451..=550 => FontWeight::Medium,
+        551..=650 => FontWeight::SemiBold,
+        651..=750 => FontWeight::Bold,
+        751..=850 => FontWeight::ExtraBold,
+        851..=925 => FontWeight::Black,
+        _ => FontWeight::ExtraBlack,
+    }
+}
+
+fn push_names(
+    names: &[(String, String)],
+    ctx: *mut c_void,
+    add: unsafe extern "C" fn(*mut core::ffi::c_void, *mut u16, i32, *mut u16, i32) -> (),
+) {
+    for (locale, name) in names {
+        let mut locale: Vec<u16> = locale.encode_utf16().collect();
+        let mut name: Vec<u16> = name.encode_utf16().collect();
+        let (locale_len, name_len) = (locale.len() as i32, name.len() as i32);
+        locale.push(0);
+        name.push(0);
+        unsafe {
+            add(
+                ctx,
+                locale.as_mut_ptr(),
+                locale_len,
+                name.as_mut_ptr(),
+                name_len,
+            )
+        };
+    }
+}
+
+#[cocom::object(IFontFace)]
+pub struct FontFace {
+    managed_handle: ManagedHandle,
+    face: u32,
+    frame_source: ComPtr<IFrameSource>,
+    manager: ComWeak<IFontManager>,
+    frame_time: FrameTime,
+    info: NFontInfo,
+    font_ref: FontRef<'static>,
+    data: Arc<[u8]>,
+    glyph_type_cache: DashMap<u16, GlyphType>,
+}
+
+unsafe impl Send for FontFace {}
+unsafe impl Sync for FontFace {}
+impl UnwindSafe for FontFace {}
+impl RefUnwindSafe for FontFace {}
+
+impl FontFace {
+    pub fn new(face: u32, manager: *mut IFontManager) -> anyhow::Result<ObjectPtr<Self>> {
+        let db = FontDb::get();
+        let entry = &db.faces[face as usize];
+        let data = db.load_data(entry)?;
+        // the data is owned by the face, and the arc never moves the heap buffer
+        let font_ref: FontRef<'static> = unsafe {
+            FontRef::from_index(
+                std::mem::transmute::<&[u8], &'static [u8]>(&data),
+                entry.index,
+            )?
+        };
+        unsafe {
+            let frame_source = /*move*/ (*manager).GetFrameSource();
+            let mut frame_time = MaybeUninit::uninit();
+            (*frame_source).Get(frame_time.as_mut_ptr());
+            Ok(Self {
+                managed_handle: Default::default(),
+                face,
+                frame_source: ComPtr::new(NonNull::new_unchecked(/*move*/ frame_source)),
+                manager: ComWeak::downgrade(NonNull::new_unchecked(/*clone*/ manager)),
+                frame_time: frame_time.assume_init(),
+                info: entry.info,
+                font_ref,
+                data,
+                glyph_type_cache: DashMap::new(),
+            }
+            .make_object())
+        }
+    }
+
+    pub fn get(face: u32, manager: *mut IFontManager) -> anyhow::Result<ComPtr<IFontFace>> {
+        unsafe {
+            let ptr_manager = manager;
+            let manager = Object::<FontManager>::GetObject(manager);
+            (*manager).get_or_add(FontDb::face_id(face), || {
+                Ok(FontFace::new(face, ptr_manager)?.to_com())
+            })
+        }
+    }
+
+    pub fn font_ref<'a>(&'a self) -> &'a FontRef<'a> {
+        &self.font_ref
+    }
+
+    pub fn get_glyph_type(
+        &self,
+        glyph_id: u16,
+        not_exists: impl FnOnce() -> GlyphType,
+    ) -> GlyphType {
+        match self.glyph_type_cache.entry(glyph_id) {
+            dashmap::Entry::Occupied(entry) => *entry.get(),
+            dashmap::Entry::Vacant(entry) => {
+                let typ = not_exists();
+                if let GlyphType::Outline | GlyphType::Color = typ {
+                    entry.insert(typ);
+                }
+                typ
+            }
+        }
+    }
+}
+
+impl impls::IFontFace for FontFace {
+    fn SetManagedHandle(
+        &mut self,
+        handle: *mut core::ffi::c_void,
+        on_drop: unsafe extern "C" fn(*mut core::ffi::c_void) -> (),
+    ) -> () {
+        self.managed_handle = ManagedHandle::new(handle, on_drop);
+    }
+
+    fn GetManagedHandle(&mut self) -> *mut core::ffi::c_void {
+        self.managed_handle.0
+    }
+
+    fn get_Id(&self) -> u64 {
+        FontDb::face_id(self.face)
+    }
+
+    fn get_RefCount(&self) -> u32 {
+        unsafe {
+            let obj = Object::<Self>::FromValue(self as *const _ as _);
+            Object::GetStrongCount(obj)
+        }
+    }
+
+    fn get_FrameTime(&self) -> *const crate::com::FrameTime {
+        &self.frame_time
+    }
+
+    fn GetFrameSource(&self) -> *mut crate::com::IFrameSource {
+        unsafe { self.frame_source.ptr().as_mut() }
+    }
+
+    fn GetFontManager(&self) -> *mut crate::com::IFontManager {
+        self.manager.upgrade().map(|a| a.leak()).unwrap_or_default()
+    }
+
+    fn get_Info(&self) -> *const crate::com::NFontInfo {
+        &self.info
+    }
+
+    fn GetData(&self, p_data: *mut *mut u8, size: *mut usize, index: *mut u32) -> () {
+        unsafe {
+            *p_data = self.data.as_ptr() as *mut _;
+            *size = self.data.len();
+            *index = self.font_ref.ttc_index().unwrap_or(u32::MAX)
+        }
+    }
+
+    fn Equals(&self, other: *mut crate::com::IFontFace) -> bool {
+        unsafe {
+            let other = Object::<Self>::GetObject(other);
+            self.face == (*other).face
+        }
+    }
+
+    fn HashCode(&self) -> i32 {
+        self.face as i32
+    }
+
+    fn GetFamilyNames(
+        &self,
+        ctx: *mut core::ffi::c_void,
+        add: unsafe extern "C" fn(*mut core::ffi::c_void, *mut u16, i32, *mut u16, i32) -> (),
+    ) -> cocom::HResult {
+        feb_hr(|| {
+            push_names(
+                &FontDb::get().faces[self.face as usize].family_names,
+                ctx,
+                add,
+            );
+            Ok(HResultE::Ok.into())
+        })
+    }
+
+    fn GetFaceNames(
+        &self,
+        ctx: *mut core::ffi::c_void,
+        add: unsafe extern "C" fn(*mut core::ffi::c_void, *mut u16, i32, *mut u16, i32) -> (),
+    ) -> cocom::HResult {
+        feb_hr(|| {
+            push_names(
+                &FontDb::get().faces[self.face as usize].face_names,
+                ctx,
+                add,
+            );
+            Ok(HResultE::Ok.into())
+        })
+    }
+}
+
+#[cocom::object(IFont)]
+pub struct Font {
+    face: u32,
+    info: NFontInfo,
+}
+
+impl impls::IFont for Font {
+    fn get_Info(&self) -> *const NFontInfo {
+        &self.info
+    }
+
+    fn CreateFace(&self, face: *mut *mut IFontFace, manager: *mut IFontManager) -> HResult {
+        feb_hr(|| unsafe {
+            if face.is_null() || manager.is_null() {
+                return Ok(HResultE::InvalidArg.into());
+            }
+            *face = FontFace::get(self.face, manager)?.leak();
+            Ok(HResultE::Ok.into())
+        })
+    }
+}
+
+#[cocom::object(IFontFamily)]
+pub struct FontFamily {
+    family: u32,
+
+    fonts: Vec<ComPtr<IFont>>,
+    p_fonts: Vec<NFontPair>,
+    has_fonts: bool,
+
+    /// built on first use, cleared ones are built again from the font db
+    names: OnceLock<FamilyNames>,
+}
+
+struct FamilyNames {
+    names: Vec<(Vec<u16>, u32)>,
+    str_names: Vec<FontFamilyNameInfo>,
+    local_names: Vec<Vec<u16>>,
+    str_local_names: Vec<Str16>,
+}
+
+unsafe impl Send for FontFamily {}
+unsafe impl Sync for FontFamily {}
+
+impl FontFamily {
+    pub fn new(family: u32) -> Self {
+        Self {
+            family,
+            fonts: vec![],
+            p_fonts: vec![],
+            has_fonts: false,
+            names: OnceLock::new(),
+        }
+    }
+
+    fn names(&self) -> &FamilyNames {
+        self.names.get_or_init(|| FamilyNames::new(self.family))
+    }
+}
+
+impl FamilyNames {
+    fn new(family: u32) -> Self {
+        let entry = &FontDb::get().families[family as usize];
+        let mut names = Vec::with_capacity(entry.names.len());
+        let mut local_names: Vec<Vec<u16>> = vec![];
+        let mut local_name_mapper = HashMap::new();
+        for (locale, name) in entry.names.iter() {
+            let local_index = *local_name_mapper.entry(locale.as_str()).or_insert_with(|| {
+                local_names.push(locale.encode_utf16().chain([0]).collect());
+                local_names.len() as u32 - 1
+            });
+            names.push((
+                name.encode_utf16().chain([0]).collect::<Vec<u16>>(),
+                local_index,
+            ));
+        }
+        let str_local_names = local_names
+            .iter()
+            .map(|name| Str16 {
+                Data: name.as_ptr(),
+                Size: name.len() as u32 - 1,
+            })
+            .collect();
+        let str_names = names
+            .iter()
+            .map(|(name, local)| FontFamilyNameInfo {
+                Name: Str16 {
+                    Data: name.as_ptr(),
+                    Size: name.len() as u32 - 1,
+                },
+                Local: *local,
+            })
+            .collect();
+        Self {
+            names,
+            str_names,
+            local_names,
+            str_local_names,
+        }
+    }
+}
+
+impl impls::IFontFamily for FontFamily {
+    fn GetLocalNames(&self, length: *mut u32) -> *const Str16 {
+        let names = self.names();
+        unsafe { *length = names.str_local_names.len() as u32 };
+        names.str_local_names.as_ptr()
+    }
+
+    fn GetNames(&self, length: *mut u32) -> *const FontFamilyNameInfo {
+        let names = self.names();
+        unsafe { *length = names.str_names.len() as u32 };
+        names.str_names.as_ptr()
+    }
+
+    fn ClearNativeNamesCache(&mut self) -> () {
+        self.names = OnceLock::new();
+    }
+
+    fn GetFonts(&mut self, length: *mut u32, pair: *mut *const NFontPair) -> HResult {
+        if !self.has_fonts {
+            let db = FontDb::get();
+            let faces = &db.families[self.family as usize].faces;
+            self.fonts.reserve(faces.len());
+            self.p_fonts.reserve(faces.len());
+            for &face in faces {
+                let font = Font {
+                    face,
+                    info: db.faces[face as usize].info,
+                }
+                .make_com();
+                let info = unsafe { &font.as_object::<Font>().info } as *const _ as *mut _;
+                self.p_fonts.push(NFontPair {
+                    Font: font.ptr().as_ptr(),
+                    Info: info,
+                });
+                self.fonts.push(font);
+            }
+            self.has_fonts = true;
+        }
+        unsafe {
+            *length = self.p_fonts.len() as u32;
+            *pair = self.p_fonts.as_ptr();
+        }
+        HResultE::Ok.into()
+    }
+
+    fn ClearNativeFontsCache(&mut self) -> () {
+        self.p_fonts.clear();
+        self.fonts.clear();
+        self.has_fonts = false;
+    }
+}
+
+#[cocom::object(IFontCollection)]
+pub struct FontCollection {
+    families: Vec<ComPtr<IFontFamily>>,
+    /// built on first use, cleared ones are built again from the families
+    p_families: OnceLock<Vec<*mut IFontFamily>>,
+}
+
+unsafe impl Send for FontCollection {}
+unsafe impl Sync for FontCollection {}
+
+impl FontCollection {
+    pub fn new() -> Self {
+        let db = FontDb::get();
+        let families: Vec<_> = (0..db.families.len() as u32)
+            .map(|family| FontFamily::new(family).make_com())
+            .collect();
+        Self {
+            families,
+            p_families: OnceLock::new(),
+        }
+    }
+}
+
+impl impls::IFontCollection for FontCollection {
+    fn GetFamilies(&self, count: *mut u32) -> *const *mut IFontFamily {
+        let p_families = self
+            .p_families
+            .get_or_init(|| self.families.iter().map(|f| f.ptr().as_ptr()).collect());
+        unsafe { *count = p_families.len() as u32 };
+        p_families.as_ptr()
+    }
+
+    fn ClearNativeFamiliesCache(&mut self) -> () {
+        self.p_families = OnceLock::new();
+    }
+
+    /// u32::MAX if the system has no font
+    fn FindDefaultFamily(&mut self) -> u32 {
+        FontDb::get().default_family.unwrap_or(u32::MAX)
+    }
+}
+
+#[derive(Debug, Clone)]
+struct FallbackEntry {
+    locale: Option<String>,
+    family: u32,
+}
+
+#[cocom::object(IFontFallback)]
+#[derive(Debug)]
+pub struct FontFallback {
+    entries: Vec<FallbackEntry>,
+    use_system_fallback: bool,
+}
+
+impl impls::IFontFallback for FontFallback {}
+
+impl FontFallback {
+    pub fn system() -> Self {
+        Self {
+            entries: vec![],
+            use_system_fallback: true,
+        }
+    }
+
+    /// Map a char to a face, custom families first, then the system fallback if enabled
+    pub fn map_char(&self, locale: &str, style: StyleKey, c: u32) -> Option<u32> {
+        let db = FontDb::get();
+        self.entries
+            .iter()
+            .filter(|e| e.locale.as_ref().is_none_or(|l| locale_matches(l, locale)))
+            .find_map(|e| db.match_face(e.family, style, Some(c)))
+            .or_else(|| {
+                if self.use_system_fallback {
+                    db.match_system(style, c)
+                } else {
+                    None
+                }
+            })
+    }
+}
+
+fn locale_matches(pattern: &str, locale: &str) -> bool {
+    let norm = |s: &str| s.replace('_', "-").to_lowercase();
+    let (pattern, locale) = (norm(pattern), norm(locale));
+    locale == pattern || locale.starts_with(&format!("{pattern}-"))
+}
+
+#[cocom::object(IFontFallbackBuilder)]
+#[derive(Debug)]
+pub struct FontFallbackBuilder {
+    entries: Vec<FallbackEntry>,
+    use_system_fallback: bool,
+}
+
+impl FontFallbackBuilder {
+    pub fn new(info: &FontFallbackBuilderCreateInfo) -> Self {
+        Self {
+            entries: vec![],
+            use_system_fallback: !info.DisableSystemFallback,
+        }
+    }
+
+    fn add(&mut self, locale: Option<String>, name: &[u16]) -> bool {
+        let name = String::from_utf16_lossy(name);
+        match FontDb::get().find_family(&name) {
+            Some(family) => {
+                self.entries.push(FallbackEntry { locale, family });
+                true
+            }
+            None => false,
+        }
+    }
+}
+
+impl impls::IFontFallbackBuilder for FontFallbackBuilder {
+    fn Build(&mut self, ff: *mut *mut IFontFallback) -> HResult {
+        feb_hr(|| unsafe {
+            *ff = FontFallback {
+                entries: self.entries.clone(),
+                use_system_fallback: self.use_system_fallback,
+            }
+            .make_com()
+            .leak();
+            Ok(HResultE::Ok.into())
+        })
+    }
+
+    fn Add(&mut self, name: *const u16, length: i32, exists: *mut bool) -> HResult {
+        feb_hr(std::panic::AssertUnwindSafe(|| unsafe {
+            let name = std::slice::from_raw_parts(name, length as usize);
+            *exists = self.add(None, name);
+            Ok(HResultE::Ok.into())
+        }))
+    }
+
+    fn AddLocaled(
+        &mut self,
+        locale: *const LocaleId,
+        name: *const u16,
+        name_length: i32,
+        exists: *mut bool,
+    ) -> HResult {
+        feb_hr(std::panic::AssertUnwindSafe(|| unsafe {
+            let locale = &*locale;
+            let locale = String::from_utf16_lossy(std::slice::from_raw_parts(
+                locale.Name as *const u16,
+                locale.Length,
+            ));
+            let name = std::slice::from_raw_parts(name, name_length as usize);
+            *exists = self.add(Some(locale), name);
+            Ok(HResultE::Ok.into())
+        }))
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn coplt_ui_sys_get_system_font_collection(
+    out: *mut *mut IFontCollection,
+) -> HResult {
+    feb_hr(|| unsafe {
+        *out = FontCollection::new().make_com().leak();
+        Ok(HResultE::Ok.into())
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn coplt_ui_sys_get_system_font_fallback(out: *mut *mut IFontFallback) -> HResult {
+    feb_hr(|| unsafe {
+        *out = FontFallback::system().make_com().leak();
+        Ok(HResultE::Ok.into())
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn coplt_ui_sys_create_font_fallback_builder(
+    info: *const FontFallbackBuilderCreateInfo,
+    out: *mut *mut IFontFallbackBuilder,
+) -> HResult {
+    feb_hr(|| unsafe {
+        *out = FontFallbackBuilder::new(&*info).make_com().leak();
+        Ok(HResultE::Ok.into())
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn coplt_ui_sys_create_layout(out: *mut *mut ILayout) -> HResult {
+    feb_hr(|| unsafe {
+        let layout = crate::layout::Layout::new(SysLayout::new());
+        *out = layout.leak();
+        Ok(HResultE::Ok.into())
+    })
+}
+
+#[derive(Debug)]
+pub struct SysLayout {
+    pub system_font_fallback: FontFallback,
+}
+
+impl SysLayout {
+    pub fn new() -> Self {
+        Self {
+            system_font_fallback: FontFallback::system(),
+        }
+    }
+}
+
+impl crate::layout::Layout {
+    pub fn new(sys: SysLayout) -> ObjectPtr<Self> {
+        Self { inner: sys }.make_object()
+    }
+}
+
+impl crate::layout::LayoutInner for SysLayout {
+    fn analyze_fonts(
+        &mut self,
+        doc: &mut SubDocInner,
+        id: NodeId,
+        paragraph: &mut TextParagraphData,
+        root_style: &StyleData,
+        style: &TextStyleData,
+    ) -> anyhow::Result<()> {
+        let text = &*{ paragraph.m_text };
+
+        let same_style_ranges: &[_] = &*paragraph.same_style_ranges();
+        let locale_ranges: &[_] = &*paragraph.locale_ranges();
+        let font_ranges = paragraph.font_ranges();
+        font_ranges.clear();
+
+        if text.is_empty() {
+            return Ok(());
+        }
+
+        let db = FontDb::get();
+        let fm = doc.ctx().font_manager;
+
+        for (n, ssr) in same_style_ranges.iter().enumerate() {
+            let span_style = c_option!(#val; ssr => FirstSpan)
+                .map(|span| &*span.text_style_data(doc))
+                .unwrap_or(style);
+
+            let font_fallback = span_style
+                .FontFallback()
+                .or(style.FontFallback())
+                .unwrap_or(root_style.FontFallback);
+            let font_fallback = match NonNull::new(font_fallback) {
+                Some(ff) => unsafe { &*Object::<FontFallback>::GetObject(ff.as_ptr()) },
+                None => &self.system_font_fallback,
+            };
+
+            let font_weight = span_style
+                .FontWeight()
+                .or(style.FontWeight())
+                .unwrap_or(root_style.FontWeight);
+            let font_width = span_style
+                .FontWidth()
+                .or(style.FontWidth())
+                .unwrap_or(root_style.FontWidth);
+            let font_italic = span_style
+                .FontItalic()
+                .or(style.FontItalic())
+                .unwrap_or(root_style.FontItalic);
+            let style_key = StyleKey::new(font_weight, font_width, font_italic);
+
+            let mut cur: Option<(u32, u32)> = None;
+            let mut flush = |cur: Option<(u32, u32)>, end: u32| -> anyhow::Result<()> {
+                if let Some((start, face)) = cur {
+                    font_ranges.push(FontRange {
+                        start,
+                        end,
+                        font_face: FontFace::get(face, fm)?,
+                        style_range: n as u32,
+                    });
+                }
+                Ok(())
+            };
+
+            let mut i = ssr.Start as usize;
+            let end = ssr.End as usize;
+            while i < end {
+                let start = i;
+                let c = match char::decode_utf16(text[i..end].iter().copied()).next() {
+                    Some(Ok(c)) => {
+                        i += c.len_utf16();
+                        c as u32
+                    }
+                    _ => {
+                        i += 1;
+                        0xFFFD
+                    }
+                };
+
+                // keep the current font as long as it can render the char
+                if let Some((_, face)) = cur {
+                    if db.faces[face as usize].has_char(c) || is_default_ignorable(c) {
+                        continue;
+                    }
+                }
+
+                let locale = match locale_ranges
+                    .binary_search_by(TextData_LocaleRange::search_pos(start as u32))
+                {
+                    Ok(pos) => {
+                        let locale = &locale_ranges[pos].Locale;
+                        String::from_utf16_lossy(unsafe {
+                            std::slice::from_raw_parts(locale.Name as *const u16, locale.Length)
+                        })
+                    }
+                    Err(_) => String::new(),
+                };
+
+                let face = font_fallback
+                    .map_char(&locale, style_key, c)
+                    .or_else(|| cur.map(|a| a.1))
+                    .or_else(|| {
+                        db.default_family
+                            .and_then(|family| db.match_face(family, style_key, None))
+                    });
+                let Some(face) = face else {
+                    anyhow::bail!("No font available in the system");
+                };
+                if cur.is_some_and(|(_, cur_face)| cur_face == face) {
+                    continue;
+                }
+                flush(cur, start as u32)?;
+                cur = Some((start as u32, face));
+            }
+            flush(cur, ssr.End)?;
+        }
+
+        Ok(())
+    }
+}
+
+fn is_default_ignorable(c: u32) -> bool {
+    matches!(c, 0x00AD | 0x034F | 0x200B..=0x200F | 0x202A..=0x202E | 0x2060..=0x206F | 0xFE00..=0xFE0F | 0xFEFF)
+        || c < 0x20
+}
@@ -0,0 +1,86 @@
+#include "Arena.h"
+
+#include <algorithm>
+
+using namespace Coplt;
+
+namespace
+{
+    std::atomic<u64> s_arena_used{0};
+    std::atomic<u64> s_arena_peak{0};
+
+    void AddGlobalUsed(const u64 size)
+    {
+        const auto used = s_arena_used.fetch_add(size, std::memory_order_relaxed) + size;
+        auto peak = s_arena_peak.load(std::memory_order_relaxed);
+        while (peak < used && !s_arena_peak.compare_exchange_weak(peak, used, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+Arena::~Arena()
+{
+    ReleaseChunks();
+}
+
+Arena::Stats Arena::GlobalStats()
+{
+    return Stats{
+        .Used = s_arena_used.load(std::memory_order_relaxed),
+        .Peak = s_arena_peak.load(std::memory_order_relaxed),
+    };
+}
+
+void Arena::Reset()
+{
+    if (m_chunks > 1)
+    {
+        const auto size = m_reserved;
+        ReleaseChunks();
+        AddChunk(size);
+    }
+    else if (m_chunks == 1)
+    {
+        m_cur = m_end - m_reserved;
+    }
+    m_used = 0;
+}
+
+void* Arena::AllocateSlow(const usize bytes, const usize align)
+{
+    // Every chunk at least doubles the arena, so a round needs O(log n) chunks
+    AddChunk(std::max({bytes + align, m_reserved, MinChunkSize}));
+    return do_allocate(bytes, align);
+}
+
+void Arena::AddChunk(const usize size)
+{
+    const auto chunk = static_cast<Chunk*>(mi_malloc_aligned(sizeof(Chunk) + size, alignof(std::max_align_t)));
+    if (chunk == nullptr) throw std::bad_alloc();
+    chunk->Next = m_chunk_list;
+    m_chunk_list = chunk;
+    m_cur = reinterpret_cast<std::byte*>(chunk) + sizeof(Chunk);
+    m_end = m_cur + size;
+    m_reserved += size;
+    m_chunks++;
+    AddGlobalUsed(size);
+}
+
+void Arena::ReleaseChunks()
+{
+    if (m_chunk_list == nullptr) return;
+    // A round needs O(log n) chunks, so this is a short walk
+    for (auto chunk = m_chunk_list; chunk != nullptr;)
+    {
+        const auto next = chunk->Next;
+        mi_free(chunk);
+        chunk = next;
+    }
+    s_arena_used.fetch_sub(m_reserved, std::memory_order_relaxed);
+    m_chunk_list = nullptr;
+    m_cur = nullptr;
+    m_end = nullptr;
+    m_reserved = 0;
+    m_chunks = 0;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <memory_resource>
+#include <vector>
+#include <mimalloc.h>
+
+#include "Com.h"
+
+namespace Coplt
+{
+    // Bump allocator over a list of mimalloc chunks, everything it hands out is released at once by Reset,
+    // deallocate is a no-op; not thread safe, one arena belongs to one owner at a time, but the owner may be a
+    // different thread in each round since the chunks do not come from a thread bound heap
+    struct Arena final : std::pmr::memory_resource
+    {
+        static constexpr usize MinChunkSize = 4 * 1024;
+
+        struct Stats
+        {
+            // Bytes of chunks currently held by all arenas
+            u64 Used;
+            // High water mark of Used
+            u64 Peak;
+        };
+
+        struct Chunk
+        {
+            Chunk* Next;
+        };
+
+        // Most recent chunk first
+        Chunk* m_chunk_list{};
+        std::byte* m_cur{};
+        std::byte* m_end{};
+        // Bytes handed out since the last reset
+        usize m_used{};
+        // High water mark of m_used
+        usize m_peak{};
+        // Bytes of all chunks, the first chunk after a reset is sized to fit the previous round
+        usize m_reserved{};
+        u32 m_chunks{};
+
+        Arena() = default;
+        ~Arena() override;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Invalidates every allocation, keeps the memory when it all fitted in one chunk,
+        // otherwise coalesces it into a single chunk for the next round
+        void Reset();
+
+        usize Used() const { return m_used; }
+        usize Peak() const { return m_peak; }
+        usize Reserved() const { return m_reserved; }
+
+        static Stats GlobalStats();
+
+    private:
+        void* do_allocate(usize bytes, usize align) override
+        {
+            const auto p = reinterpret_cast<std::byte*>(
+                (reinterpret_cast<usize>(m_cur) + (align - 1)) & ~(align - 1)
+            );
+            if (m_cur == nullptr || p > m_end || bytes > static_cast<usize>(m_end - p)) [[unlikely]]
+                return AllocateSlow(bytes, align);
+            m_cur = p + bytes;
+            m_used += bytes;
+            if (m_used > m_peak) m_peak = m_used;
+            return p;
+        }
+
+        void do_deallocate(void*, usize, usize) override
+        {
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        COPLT_NO_INLINE
+        void* AllocateSlow(usize bytes, usize align);
+        void AddChunk(usize size);
+        void ReleaseChunks();
+    };
+
+    // Forwards to an arena that can be swapped between rounds, so containers bound to it once can be filled from
+    // whichever arena the thread building them owns; only retarget while nothing allocated from it is in use
+    struct ArenaSlot final : std::pmr::memory_resource
+    {
+        Arena* m_arena;
+
+        explicit ArenaSlot(Arena* arena) : m_arena(arena)
+        {
+        }
+
+    private:
+        void* do_allocate(const usize bytes, const usize align) override
+        {
+            return m_arena->allocate(bytes, align);
+        }
+
+        void do_deallocate(void*, usize, usize) override
+        {
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    template <class T>
+    using ArenaVector = std::pmr::vector<T>;
+}
@@ -7,6 +7,6 @@ namespace Coplt
 
 #ifdef _WINDOWS
 #include "dwrite/Backend.h"
+#else
+#include "sys/Backend.h"
 #endif
-
-// todo other system
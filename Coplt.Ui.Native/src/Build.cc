@@ -4,7 +4,17 @@
 #include "Layout.cc"
 #include "TextLayout.cc"
 #include "Text.cc"
+#include "ThreadPool.cc"
+#include "Arena.cc"
+#include "ClusterWidths.cc"
+#include "PackedLines.cc"
+#include "Path.cc"
+#include "ShelfAtlas.cc"
+#include "Tessellator.cc"
+#include "TessCache.cc"
 
 #ifdef _WINDOWS
 #include "dwrite/Build.cc"
+#else
+#include "sys/Build.cc"
 #endif
@@ -0,0 +1,84 @@
+#include "ClusterWidths.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#define COPLT_CLUSTER_WIDTHS_SSE2
+#endif
+
+using namespace Coplt;
+
+void Coplt::ComputeClusterWidths(
+    f32* widths, const f32* advances, const GlyphOffset* offsets,
+    const u16* glyph_props, const u16 cluster_start_mask, const u32 count
+)
+{
+    if (count == 0) return;
+
+    // Glyph widths, the offsets are deinterleaved from their ascender offsets
+    u32 i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= count; i += 8)
+    {
+        const auto o0 = _mm256_loadu_ps(&offsets[i].AdvanceOffset);
+        const auto o1 = _mm256_loadu_ps(&offsets[i + 4].AdvanceOffset);
+        // a0 a1 a4 a5 | a2 a3 a6 a7
+        const auto s = _mm256_shuffle_ps(o0, o1, _MM_SHUFFLE(2, 0, 2, 0));
+        const auto a = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(s), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(widths + i, _mm256_add_ps(_mm256_loadu_ps(advances + i), a));
+    }
+#endif
+#ifdef COPLT_CLUSTER_WIDTHS_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto o0 = _mm_loadu_ps(&offsets[i].AdvanceOffset);
+        const auto o1 = _mm_loadu_ps(&offsets[i + 2].AdvanceOffset);
+        const auto a = _mm_shuffle_ps(o0, o1, _MM_SHUFFLE(2, 0, 2, 0));
+        _mm_storeu_ps(widths + i, _mm_add_ps(_mm_loadu_ps(advances + i), a));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        widths[i] = advances[i] + offsets[i].AdvanceOffset;
+    }
+
+    // Segmented suffix sums from the back, glyph i is closed when glyph i + 1 starts a new cluster
+    const auto closed = [&](const u32 n) { return n + 1 >= count || (glyph_props[n + 1] & cluster_start_mask) != 0; };
+    // At least one glyph is left to the scalar loop so the vector loop never reads past the last prop
+    u32 j = count - 1 - (count - 1) % 4;
+    for (u32 n = count; n-- > j;)
+    {
+        if (!closed(n)) widths[n] += widths[n + 1];
+    }
+#ifdef COPLT_CLUSTER_WIDTHS_SSE2
+    const auto mask = _mm_set1_epi16(static_cast<short>(cluster_start_mask));
+    while (j >= 4)
+    {
+        j -= 4;
+        auto v = _mm_loadu_ps(widths + j);
+        const auto props = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(glyph_props + j + 1));
+        const auto starts16 = _mm_xor_si128(
+            _mm_cmpeq_epi16(_mm_and_si128(props, mask), _mm_setzero_si128()), _mm_set1_epi32(-1)
+        );
+        auto c = _mm_castsi128_ps(_mm_unpacklo_epi16(starts16, starts16));
+
+        // Hillis-Steele over the 4 lanes, lanes shifted in from past the end are open and zero
+        auto vs = _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(v), 4));
+        auto cs = _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(c), 4));
+        v = _mm_add_ps(v, _mm_andnot_ps(c, vs));
+        c = _mm_or_ps(c, cs);
+        vs = _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(v), 8));
+        cs = _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(c), 8));
+        v = _mm_add_ps(v, _mm_andnot_ps(c, vs));
+        c = _mm_or_ps(c, cs);
+
+        // Lanes still open continue into the block after this one, which is already done
+        v = _mm_add_ps(v, _mm_andnot_ps(c, _mm_set1_ps(widths[j + 4])));
+        _mm_storeu_ps(widths + j, v);
+    }
+#else
+    for (u32 n = j; n-- > 0;)
+    {
+        if (!closed(n)) widths[n] += widths[n + 1];
+    }
+#endif
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Com.h"
+
+namespace Coplt
+{
+    // Same layout as DWRITE_GLYPH_OFFSET
+    struct GlyphOffset
+    {
+        f32 AdvanceOffset;
+        f32 AscenderOffset;
+    };
+
+    // For every glyph, the width from it to the end of its cluster: its advance + advance offset plus those of
+    // the following glyphs up to the next one with (glyph_props[i] & cluster_start_mask) set;
+    // at a cluster start this is the width of the whole cluster, so a line breaker can read cluster widths directly
+    void ComputeClusterWidths(
+        f32* widths, const f32* advances, const GlyphOffset* offsets,
+        const u16* glyph_props, u16 cluster_start_mask, u32 count
+    );
+}
@@ -0,0 +1,600 @@
+#pragma once
+
+#include <bit>
+#include <cstring>
+#include <mimalloc.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define COPLT_FLAT_MAP_SSE2
+#endif
+
+#include "Com.h"
+#include "Hash.h"
+#include "Map.h"
+
+namespace Coplt
+{
+    namespace FlatMapDetails
+    {
+        /// <summary>
+        /// Control byte of a slot: Empty and Deleted have the high bit set,
+        /// a full slot stores the low 7 bits of the hash (H2)
+        /// </summary>
+        constexpr i8 CtrlEmpty = -128;
+        constexpr i8 CtrlDeleted = -2;
+
+        constexpr i32 GroupWidth = 16;
+
+        /// Bit i set means the slot i of the group matched
+        using GroupMask = u32;
+
+        struct Group
+        {
+#ifdef COPLT_FLAT_MAP_SSE2
+            __m128i m_ctrl;
+
+            COPLT_FORCE_INLINE
+            explicit Group(const i8* ctrl)
+                : m_ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl)))
+            {
+            }
+
+            COPLT_FORCE_INLINE
+            GroupMask Match(const i8 h2) const
+            {
+                return static_cast<GroupMask>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(h2))));
+            }
+
+            COPLT_FORCE_INLINE
+            GroupMask MatchEmpty() const
+            {
+                return Match(CtrlEmpty);
+            }
+
+            COPLT_FORCE_INLINE
+            GroupMask MatchEmptyOrDeleted() const
+            {
+                return static_cast<GroupMask>(_mm_movemask_epi8(m_ctrl));
+            }
+#else
+            const i8* m_ctrl;
+
+            COPLT_FORCE_INLINE
+            explicit Group(const i8* ctrl) : m_ctrl(ctrl)
+            {
+            }
+
+            COPLT_FORCE_INLINE
+            GroupMask Match(const i8 h2) const
+            {
+                GroupMask mask = 0;
+                for (i32 i = 0; i < GroupWidth; ++i)
+                    mask |= static_cast<GroupMask>(m_ctrl[i] == h2) << i;
+                return mask;
+            }
+
+            COPLT_FORCE_INLINE
+            GroupMask MatchEmpty() const
+            {
+                return Match(CtrlEmpty);
+            }
+
+            COPLT_FORCE_INLINE
+            GroupMask MatchEmptyOrDeleted() const
+            {
+                GroupMask mask = 0;
+                for (i32 i = 0; i < GroupWidth; ++i)
+                    mask |= static_cast<GroupMask>(m_ctrl[i] < 0) << i;
+                return mask;
+            }
+#endif
+        };
+
+        /// Integer and pointer keys use identity hashes, spread the bits before splitting into H1 and H2
+        COPLT_FORCE_INLINE
+        u64 Mix(const i32 hash_code)
+        {
+            const auto h = static_cast<u64>(static_cast<u32>(hash_code)) * 0x9E3779B97F4A7C15ull;
+            return h ^ (h >> 32);
+        }
+
+        COPLT_FORCE_INLINE
+        u64 H1(const u64 hash)
+        {
+            return hash >> 7;
+        }
+
+        COPLT_FORCE_INLINE
+        i8 H2(const u64 hash)
+        {
+            return static_cast<i8>(hash & 0x7F);
+        }
+
+        /// Max load factor is 7/8
+        constexpr i32 GrowthLimit(const i32 cap)
+        {
+            return cap - cap / 8;
+        }
+    }
+
+    template <class TKey, class TValue>
+    struct FlatMapEntry
+    {
+        TKey Key;
+        TValue Value;
+    };
+
+    /// <summary>
+    /// Open addressing hash map with swiss table style control bytes, probed a 16 slots group at a time.
+    /// Same api as <see cref="Map"/> but not ffi compatible, use it for native only lookups.
+    /// </summary>
+    template <class TKey, class TValue, Hash<TKey> THash = DefaultHash<TKey>, Eq<TKey> TEq = DefaultEq<TKey>>
+    struct FlatMap
+    {
+        using Entry = FlatMapEntry<TKey, TValue>;
+        using EntryOutput = MapEntryOutput<TKey, TValue, Entry>;
+
+    private:
+        i8* m_ctrl{};
+        Entry* m_entries{};
+        // Power of two and multiple of GroupWidth, or 0
+        i32 m_cap{};
+        i32 m_count{};
+        i32 m_growth_left{};
+
+    public:
+        TKey* UnsafeKeyAt(i32 index) const
+        {
+            return std::addressof(m_entries[index].Key);
+        }
+
+        TKey* UnsafeKeyAt(u32 index) const
+        {
+            return std::addressof(m_entries[index].Key);
+        }
+
+        TValue* UnsafeAt(i32 index) const
+        {
+            return std::addressof(m_entries[index].Value);
+        }
+
+        TValue* UnsafeAt(u32 index) const
+        {
+            return std::addressof(m_entries[index].Value);
+        }
+
+        i32 Count() const { return m_count; }
+        i32 Capacity() const { return m_cap; }
+
+        FlatMap() = default;
+
+        explicit FlatMap(const i32 capacity)
+        {
+            if (capacity < 0) throw Exception();
+            Reserve(capacity);
+        }
+
+        void Reserve(const i32 capacity)
+        {
+            const auto cap = CapacityFor(capacity);
+            if (cap > m_cap) Resize(cap);
+        }
+
+    private:
+        static i32 CapacityFor(const i32 count)
+        {
+            const auto min = static_cast<u32>(std::max<i64>(FlatMapDetails::GroupWidth, (static_cast<i64>(count) * 8 + 6) / 7));
+            return static_cast<i32>(std::bit_ceil(min));
+        }
+
+        static usize EntriesOffset(const i32 cap)
+        {
+            return (static_cast<usize>(cap) + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+        }
+
+        static constexpr usize Align = std::max<usize>(alignof(Entry), FlatMapDetails::GroupWidth);
+
+        void Allocate(const i32 cap)
+        {
+            const auto offset = EntriesOffset(cap);
+            const auto mem = static_cast<u8*>(mi_malloc_aligned(offset + cap * sizeof(Entry), Align));
+            m_ctrl = reinterpret_cast<i8*>(mem);
+            m_entries = reinterpret_cast<Entry*>(mem + offset);
+            m_cap = cap;
+            m_growth_left = FlatMapDetails::GrowthLimit(cap) - m_count;
+            std::memset(m_ctrl, FlatMapDetails::CtrlEmpty, cap);
+        }
+
+        static bool IsFull(const i8 ctrl)
+        {
+            return ctrl >= 0;
+        }
+
+        u32 GroupMask() const
+        {
+            return static_cast<u32>(m_cap / FlatMapDetails::GroupWidth) - 1;
+        }
+
+        void SetCtrl(const i32 index, const i8 ctrl) const
+        {
+            m_ctrl[index] = ctrl;
+        }
+
+        /// Find the first empty or deleted slot in the probe sequence
+        i32 FindInsertSlot(const u64 hash) const
+        {
+            using namespace FlatMapDetails;
+            const auto group_mask = GroupMask();
+            auto g = static_cast<u32>(H1(hash)) & group_mask;
+            for (u32 step = 1;; ++step)
+            {
+                const Group group(m_ctrl + g * GroupWidth);
+                if (const auto mask = group.MatchEmptyOrDeleted())
+                    return static_cast<i32>(g * GroupWidth + std::countr_zero(mask));
+                // Triangular steps visit every group when the group count is a power of two
+                g = (g + step) & group_mask;
+            }
+        }
+
+        template <class Q, Eq<Q, TKey> QEq>
+        i32 Find(const Q& key, const u64 hash) const
+        {
+            using namespace FlatMapDetails;
+            const auto h2 = H2(hash);
+            const auto group_mask = GroupMask();
+            auto g = static_cast<u32>(H1(hash)) & group_mask;
+            for (u32 step = 1; step <= group_mask + 1; ++step)
+            {
+                const Group group(m_ctrl + g * GroupWidth);
+                for (auto mask = group.Match(h2); mask != 0; mask &= mask - 1)
+                {
+                    const auto i = static_cast<i32>(g * GroupWidth + std::countr_zero(mask));
+                    if (QEq::Equals(key, m_entries[i].Key)) [[likely]] return i;
+                }
+                if (group.MatchEmpty()) [[likely]] return -1;
+                g = (g + step) & group_mask;
+            }
+            return -1;
+        }
+
+        void Resize(const i32 new_cap)
+        {
+            const auto old_ctrl = m_ctrl;
+            const auto old_entries = m_entries;
+            const auto old_cap = m_cap;
+
+            Allocate(new_cap);
+
+            for (i32 i = 0; i < old_cap; ++i)
+            {
+                if (!IsFull(old_ctrl[i])) continue;
+                auto& old = old_entries[i];
+                const auto hash = FlatMapDetails::Mix(THash::GetHashCode(old.Key));
+                const auto index = FindInsertSlot(hash);
+                SetCtrl(index, FlatMapDetails::H2(hash));
+                new(std::addressof(m_entries[index])) Entry(std::move(old));
+                old.~Entry();
+            }
+
+            if (old_ctrl) mi_free(old_ctrl);
+        }
+
+        /// Growth is exhausted, either drop the tombstones at the same size or double the size
+        void Rehash()
+        {
+            if (m_cap == 0) Resize(FlatMapDetails::GroupWidth);
+            else if (m_count * 2 <= FlatMapDetails::GrowthLimit(m_cap)) Resize(m_cap);
+            else Resize(m_cap * 2);
+        }
+
+        /// <summary>
+        /// Single probe for lookup and insert, remembers the first free slot while looking for the key
+        /// </summary>
+        /// <returns>index and whether the key already exists, a new slot is already marked as full</returns>
+        template <class Q, Eq<Q, TKey> QEq>
+        std::pair<i32, bool> FindOrPrepareInsert(const Q& key, const u64 hash)
+        {
+            using namespace FlatMapDetails;
+            const auto h2 = H2(hash);
+            const auto group_mask = GroupMask();
+            auto g = static_cast<u32>(H1(hash)) & group_mask;
+            i32 index = -1;
+            for (u32 step = 1; step <= group_mask + 1; ++step)
+            {
+                const Group group(m_ctrl + g * GroupWidth);
+                for (auto mask = group.Match(h2); mask != 0; mask &= mask - 1)
+                {
+                    const auto i = static_cast<i32>(g * GroupWidth + std::countr_zero(mask));
+                    if (QEq::Equals(key, m_entries[i].Key)) [[likely]] return {i, true};
+                }
+                if (index < 0)
+                {
+                    if (const auto mask = group.MatchEmptyOrDeleted())
+                        index = static_cast<i32>(g * GroupWidth + std::countr_zero(mask));
+                }
+                if (group.MatchEmpty()) [[likely]] break;
+                g = (g + step) & group_mask;
+            }
+
+            if (m_growth_left == 0 && m_ctrl[index] == CtrlEmpty) [[unlikely]]
+            {
+                Rehash();
+                index = FindInsertSlot(hash);
+            }
+            if (m_ctrl[index] == CtrlEmpty) m_growth_left--;
+            SetCtrl(index, h2);
+            m_count++;
+            return {index, false};
+        }
+
+        InsertResult TryInsert(TKey&& key, TValue&& value, bool overwrite)
+        {
+            if (m_ctrl == nullptr) Rehash();
+
+            const auto [index, exists] = FindOrPrepareInsert<TKey, TEq>(key, FlatMapDetails::Mix(THash::GetHashCode(key)));
+            auto& entry = m_entries[index];
+            if (exists)
+            {
+                if (overwrite)
+                {
+                    entry.Value = std::forward<TValue>(value);
+                    return InsertResult::Overwrite;
+                }
+
+                return InsertResult::None;
+            }
+
+            new(std::addressof(entry.Key)) TKey(std::forward<TKey>(key));
+            new(std::addressof(entry.Value)) TValue(std::forward<TValue>(value));
+            return InsertResult::AddNew;
+        }
+
+    public:
+        EntryOutput FindValue(const TKey& key) const
+        {
+            return FindValue<TKey, THash, TEq>(key);
+        }
+
+        template <class Q, Hash<Q> QHash = DefaultHash<Q>, Eq<Q> QEq = DefaultEq<Q, TKey>>
+        EntryOutput FindValue(const Q& key) const
+        {
+            if (!m_ctrl) return EntryOutput();
+
+            const auto i = Find<Q, QEq>(key, FlatMapDetails::Mix(QHash::GetHashCode(key)));
+            if (i < 0) return EntryOutput();
+            return EntryOutput(&m_entries[i], i, true);
+        }
+
+        EntryOutput GetValueRefOrUninitializedValue(TKey&& key)
+        {
+            auto r = GetValueRefOrUninitialized(key);
+            r.SetKey(std::forward<TKey>(key));
+            return r;
+        }
+
+        EntryOutput GetValueRefOrUninitializedValue(const TKey& key)
+        {
+            auto r = GetValueRefOrUninitialized(key);
+            r.SetKey(key);
+            return r;
+        }
+
+        EntryOutput GetValueRefOrUninitialized(const TKey& key)
+        {
+            return GetValueRefOrUninitialized<TKey, THash, TEq>(key);
+        }
+
+        template <class Q, Hash<Q> QHash = DefaultHash<Q>, Eq<Q> QEq = DefaultEq<Q, TKey>>
+        EntryOutput GetValueRefOrUninitialized(const Q& key)
+        {
+            if (m_ctrl == nullptr) Rehash();
+
+            const auto [index, exists] = FindOrPrepareInsert<Q, QEq>(key, FlatMapDetails::Mix(QHash::GetHashCode(key)));
+            return EntryOutput(&m_entries[index], index, exists);
+        }
+
+        bool TryAdd(const TKey& key, TValue&& value)
+        {
+            return TryAdd(TKey(key), std::forward<TValue>(value));
+        }
+
+        bool TryAdd(const TKey& key, const TValue& value)
+        {
+            return TryAdd(TKey(key), TValue(value));
+        }
+
+        bool TryAdd(TKey&& key, const TValue& value)
+        {
+            return TryInsert(std::forward<TKey>(key), TValue(value), false) == InsertResult::AddNew;
+        }
+
+        bool TryAdd(TKey&& key, TValue&& value)
+        {
+            return TryInsert(std::forward<TKey>(key), std::forward<TValue>(value), false) == InsertResult::AddNew;
+        }
+
+        bool Set(const TKey& key, TValue&& value)
+        {
+            return TryInsert(TKey(key), std::forward<TValue>(value), true) == InsertResult::AddNew;
+        }
+
+        bool Set(const TKey& key, const TValue& value)
+        {
+            return TryInsert(TKey(key), TValue(value), true) == InsertResult::AddNew;
+        }
+
+        bool Set(TKey&& key, const TValue& value)
+        {
+            return TryInsert(std::forward<TKey>(key), TValue(value), true) == InsertResult::AddNew;
+        }
+
+        bool Set(TKey&& key, TValue&& value)
+        {
+            return TryInsert(std::forward<TKey>(key), std::forward<TValue>(value), true) == InsertResult::AddNew;
+        }
+
+        bool Contains(const TKey& key)
+        {
+            return FindValue(key);
+        }
+
+        template <class Q, Hash<Q> QHash = DefaultHash<Q>, Eq<Q> QEq = DefaultEq<Q, TKey>>
+        bool Contains(const Q& key)
+        {
+            return FindValue<Q, QHash, QEq>(key);
+        }
+
+        EntryOutput TryGet(const TKey& key)
+        {
+            return FindValue(key);
+        }
+
+        template <class Q, Hash<Q> QHash = DefaultHash<Q>, Eq<Q> QEq = DefaultEq<Q, TKey>>
+        EntryOutput TryGet(const Q& key)
+        {
+            return FindValue<Q, QHash, QEq>(key);
+        }
+
+        std::optional<std::pair<TKey, TValue>> Remove(const TKey& key)
+        {
+            return Remove<TKey, THash, TEq>(key);
+        }
+
+        template <class Q, Hash<Q> QHash = DefaultHash<Q>, Eq<Q> QEq = DefaultEq<Q, TKey>>
+        std::optional<std::pair<TKey, TValue>> Remove(const Q& key)
+        {
+            using namespace FlatMapDetails;
+            if (!m_ctrl) return std::nullopt;
+
+            const auto i = Find<Q, QEq>(key, Mix(QHash::GetHashCode(key)));
+            if (i < 0) return std::nullopt;
+
+            auto& entry = m_entries[i];
+            std::pair<TKey, TValue> r = std::make_pair(TKey(std::move(entry.Key)), TValue(std::move(entry.Value)));
+            entry.Key.~TKey();
+            entry.Value.~TValue();
+
+            // Probing stops at a group that has an empty slot, so if this group still has one,
+            // no probe sequence can pass through it and the slot can go straight back to empty
+            const Group group(m_ctrl + (i & ~(GroupWidth - 1)));
+            if (group.MatchEmpty())
+            {
+                SetCtrl(i, CtrlEmpty);
+                m_growth_left++;
+            }
+            else
+            {
+                SetCtrl(i, CtrlDeleted);
+            }
+            m_count--;
+
+            return std::optional<std::pair<TKey, TValue>>{std::move(r)};
+        }
+
+        struct Enumerator
+        {
+        private:
+            const FlatMap* self;
+            Entry* cur;
+            i32 index;
+
+        public:
+            explicit Enumerator(const FlatMap* self)
+                : self(self), cur(nullptr), index(0)
+            {
+            }
+
+            bool MoveNext()
+            {
+                while (index < self->m_cap)
+                {
+                    const auto i = index++;
+                    if (IsFull(self->m_ctrl[i]))
+                    {
+                        cur = &self->m_entries[i];
+                        return true;
+                    }
+                }
+
+                cur = nullptr;
+                return false;
+            }
+
+            std::pair<TKey*, TValue*> Current()
+            {
+                return std::make_pair(std::addressof(cur->Key), std::addressof(cur->Value));
+            }
+        };
+
+        Enumerator GetEnumerator() const
+        {
+            return Enumerator(this);
+        }
+
+    private:
+        void DestroyAll()
+        {
+            if constexpr (!std::is_trivially_destructible_v<TKey> || !std::is_trivially_destructible_v<TValue>)
+            {
+                auto e = GetEnumerator();
+                while (e.MoveNext())
+                {
+                    auto [key, value] = e.Current();
+                    key->~TKey();
+                    value->~TValue();
+                }
+            }
+        }
+
+    public:
+        void Clear()
+        {
+            if (m_count <= 0) return;
+            DestroyAll();
+            std::memset(m_ctrl, FlatMapDetails::CtrlEmpty, m_cap);
+            m_count = 0;
+            m_growth_left = FlatMapDetails::GrowthLimit(m_cap);
+        }
+
+        ~FlatMap()
+        {
+            if (!m_ctrl) return;
+            DestroyAll();
+            mi_free(m_ctrl);
+            m_ctrl = nullptr;
+            m_entries = nullptr;
+            m_cap = 0;
+            m_count = 0;
+            m_growth_left = 0;
+        }
+
+        FlatMap& swap(FlatMap& other) noexcept
+        {
+            std::swap(m_ctrl, other.m_ctrl);
+            std::swap(m_entries, other.m_entries);
+            std::swap(m_cap, other.m_cap);
+            std::swap(m_count, other.m_count);
+            std::swap(m_growth_left, other.m_growth_left);
+            return *this;
+        }
+
+        FlatMap(const FlatMap& other) = delete;
+        FlatMap& operator=(const FlatMap& other) = delete;
+
+        FlatMap(FlatMap&& other) noexcept
+        {
+            m_ctrl = std::exchange(other.m_ctrl, nullptr);
+            m_entries = std::exchange(other.m_entries, nullptr);
+            m_cap = std::exchange(other.m_cap, 0);
+            m_count = std::exchange(other.m_count, 0);
+            m_growth_left = std::exchange(other.m_growth_left, 0);
+        }
+
+        FlatMap& operator=(FlatMap&& other) noexcept
+        {
+            FlatMap(std::forward<FlatMap>(other)).swap(*this);
+            return *this;
+        }
+    };
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <icu.h>
+#else
+#include <unicode/uchar.h>
+#include <unicode/uloc.h>
+#include <unicode/uscript.h>
+#include <unicode/utf16.h>
+#endif
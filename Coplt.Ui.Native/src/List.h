@@ -1,11 +1,51 @@
 #pragma once
 
+#include <cstring>
 #include <mimalloc.h>
 
 #include "Com.h"
 
 namespace Coplt
 {
+    namespace ListDetails
+    {
+        // Moves n items from src to dst and ends the lifetime of the sources, a plain memmove when T allows it
+        template <class T>
+        void RelocateItems(T* dst, T* src, const i32 n)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                if (n > 0) std::memmove(dst, src, sizeof(T) * n);
+            }
+            else
+            {
+                for (i32 i = 0; i < n; ++i)
+                {
+                    new(dst + i) T(std::move(src[i]));
+                    src[i].~T();
+                }
+            }
+        }
+
+        // Resizes a mimalloc block holding size live items, in place when mimalloc has room behind it
+        template <class T>
+        T* ReallocItems(T* items, const i32 size, const i32 new_cap)
+        {
+            if (mi_expand(items, sizeof(T) * new_cap) != nullptr) return items;
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                return static_cast<T*>(mi_realloc_aligned(items, sizeof(T) * new_cap, alignof(T)));
+            }
+            else
+            {
+                const auto new_items = static_cast<T*>(mi_malloc_aligned(sizeof(T) * new_cap, alignof(T)));
+                RelocateItems(new_items, items, size);
+                mi_free(items);
+                return new_items;
+            }
+        }
+    }
+
     template <class T>
     struct List
     {
@@ -31,7 +71,7 @@ namespace Coplt
             if (capacity <= 0) capacity = DefaultCapacity;
 
             m_cap = capacity;
-            if (capacity) m_items = mi_malloc_aligned(sizeof(T) * capacity, alignof(T));
+            if (capacity) m_items = static_cast<T*>(mi_malloc_aligned(sizeof(T) * capacity, alignof(T)));
         }
 
         List(const List& other) = delete;
@@ -74,25 +114,25 @@ namespace Coplt
         T* At(i32 index)
         {
             if (m_items == nullptr || index < 0 || index >= m_size) throw Exception("Index out of range");
-            return m_items[index];
+            return &m_items[index];
         }
 
         const T* At(i32 index) const
         {
             if (m_items == nullptr || index < 0 || index >= m_size) throw Exception("Index out of range");
-            return m_items[index];
+            return &m_items[index];
         }
 
         T* TryAt(i32 index)
         {
             if (m_items == nullptr || index < 0 || index >= m_size) return nullptr;
-            return m_items[index];
+            return &m_items[index];
         }
 
         const T* TryAt(i32 index) const
         {
             if (m_items == nullptr || index < 0 || index >= m_size) return nullptr;
-            return m_items[index];
+            return &m_items[index];
         }
 
         T* data()
@@ -133,14 +173,14 @@ namespace Coplt
             }
             else if (value != m_cap)
             {
-                if (m_size > 0)
+                if (value == 0)
                 {
-                    m_items = static_cast<T*>(mi_realloc_aligned(m_items, sizeof(T) * value, alignof(T)));
+                    mi_free(m_items);
+                    m_items = nullptr;
                 }
                 else
                 {
-                    mi_free(m_items);
-                    m_items = nullptr;
+                    m_items = ListDetails::ReallocItems(m_items, m_size, value);
                 }
             }
 
@@ -200,9 +240,9 @@ namespace Coplt
             if (!m_size || !m_items) return;
             if constexpr (!std::is_trivially_destructible_v<T>)
             {
-                for (T* item : this)
+                for (T& item : *this)
                 {
-                    item->~T();
+                    item.~T();
                 }
             }
             m_size = 0;
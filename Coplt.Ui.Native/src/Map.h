@@ -30,10 +30,10 @@ namespace Coplt
         TValue Value; // Value of entry
     };
 
-    template <class TKey, class TValue>
+    template <class TKey, class TValue, class TEntry = MapEntry<TKey, TValue>>
     struct MapEntryOutput
     {
-        MapEntry<TKey, TValue>* m_entry;
+        TEntry* m_entry;
         i32 m_index;
         bool m_exists;
         bool m_exists_key;
@@ -119,12 +119,12 @@ namespace Coplt
 
         MapEntryOutput() = default;
 
-        MapEntryOutput(MapEntry<TKey, TValue>* entry, const i32 index, const bool exists)
+        MapEntryOutput(TEntry* entry, const i32 index, const bool exists)
             : m_entry(entry), m_index(index), m_exists(exists), m_exists_key(exists), m_exists_value(exists)
         {
         }
 
-        MapEntryOutput(MapEntry<TKey, TValue>* entry, const i32 index, const bool exists, const bool exists_key, const bool exists_value)
+        MapEntryOutput(TEntry* entry, const i32 index, const bool exists, const bool exists_key, const bool exists_value)
             : m_entry(entry), m_index(index), m_exists(exists), m_exists_key(exists_key), m_exists_value(exists_value)
         {
         }
@@ -213,7 +213,9 @@ namespace Coplt
             m_buckets = static_cast<i32*>(mi_zalloc_aligned(new_size * sizeof(i32), alignof(i32)));
 
             const auto count = m_count;
+            // GetBucket reads both, so they must be updated before rehashing
             m_fast_mode_multiplier = HashHelpers::GetFastModMultiplier(static_cast<u32>(new_size));
+            m_cap = new_size;
             for (i32 i = 0; i < count; i++)
             {
                 Entry& entry = get_m_entries()[i];
@@ -224,8 +226,6 @@ namespace Coplt
                     *bucket = i + 1;
                 }
             }
-
-            m_cap = new_size;
         }
 
         InsertResult TryInsert(TKey&& key, TValue&& value, bool overwrite)
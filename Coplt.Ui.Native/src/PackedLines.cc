@@ -0,0 +1,325 @@
+#include "PackedLines.h"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc;
+
+namespace
+{
+    constexpr u16 NoInfo = std::numeric_limits<u16>::max();
+    // Beyond this the fixed point would overflow or lose the fraction bits f32 has
+    constexpr f32 MaxFixed = 1 << 23;
+
+    bool ToFixed(const f32 value, i32& fixed)
+    {
+        // Also false for nan
+        if (!(std::fabs(value) < MaxFixed)) return false;
+        fixed = static_cast<i32>(std::lround(value * PackedLines::FixedScale));
+        return true;
+    }
+
+    f32 FromFixed(const i32 fixed)
+    {
+        return static_cast<f32>(fixed) / PackedLines::FixedScale;
+    }
+
+    template <class T>
+    bool ToU16(const u32 value, T& out)
+    {
+        if (value > std::numeric_limits<T>::max()) return false;
+        out = static_cast<T>(value);
+        return true;
+    }
+
+    LineSpanType ToLineSpanType(const ParagraphSpanType type)
+    {
+        switch (type)
+        {
+        case ParagraphSpanType::Common:
+            return LineSpanType::Text;
+        case ParagraphSpanType::Space:
+            return LineSpanType::Space;
+        case ParagraphSpanType::NewLine:
+            return LineSpanType::NewLine;
+        case ParagraphSpanType::Block:
+            return LineSpanType::Object;
+        }
+        std::unreachable();
+    }
+}
+
+i32 PackedLines::InfoKey::GetHashCode() const
+{
+    auto hash = static_cast<u64>(Ascent) * 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ Descent) * 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ LineGap) * 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ MinSize) * 0x9E3779B97F4A7C15ull;
+    return static_cast<i32>(hash ^ (hash >> 32));
+}
+
+PackedLines PackedLines::Pack(
+    const std::span<const ParagraphSpan> spans, const std::span<const u32> run_of_span,
+    const std::span<const ParagraphLine> lines
+)
+{
+    if (run_of_span.size() != spans.size()) throw Exception("Argument out of range");
+    PackedLines packed{};
+    packed.m_spans.reserve(spans.size());
+    packed.m_lines.reserve(lines.size());
+    for (usize i = 0; i < spans.size(); ++i) packed.AddSpan(spans[i], run_of_span[i]);
+    for (const auto& line : lines) packed.AddLine(line);
+    return packed;
+}
+
+void PackedLines::Clear()
+{
+    m_spans.clear();
+    m_lines.clear();
+    m_infos.clear();
+    m_wide_spans.clear();
+    m_wide_lines.clear();
+    m_info_map.Clear();
+    m_last_info = NoInfo;
+    m_pack_cursor = {};
+}
+
+u16 PackedLines::InfoIndex(const ParagraphLineInfo& info)
+{
+    const InfoKey key{
+        .Ascent = std::bit_cast<u32>(info.Ascent),
+        .Descent = std::bit_cast<u32>(info.Descent),
+        .LineGap = std::bit_cast<u32>(info.LineGap),
+        .MinSize = std::bit_cast<u32>(info.MinSize),
+    };
+    if (m_last_info != NoInfo && m_last_info_key == key) return m_last_info;
+    auto r = m_info_map.GetValueRefOrUninitializedValue(key);
+    if (!r.Exists())
+    {
+        if (m_infos.size() >= NoInfo)
+        {
+            m_info_map.Remove(key);
+            return NoInfo;
+        }
+        r.SetValue(static_cast<u16>(m_infos.size()));
+        m_infos.push_back(info);
+    }
+    m_last_info_key = key;
+    m_last_info = r.GetValue();
+    return m_last_info;
+}
+
+void PackedLines::AddSpan(const ParagraphSpan& span, const u32 run)
+{
+    auto& cursor = m_pack_cursor;
+    if (run < cursor.Run) throw Exception("Spans must be added in run order");
+    const auto run_step = run - cursor.Run;
+    // A new run counts its chars and glyphs from 0
+    const auto char_base = run_step == 0 ? cursor.CharEnd : 0;
+    const auto glyph_base = run_step == 0 ? cursor.GlyphEnd : 0;
+    const auto line_step = span.NthLine - cursor.SpanNthLine;
+
+    Span packed{
+        .Flags = static_cast<u8>(
+            static_cast<u8>(span.Type) | (span.NeedReShape ? NeedReShapeFlag : 0) | (line_step == 1 ? NextLineFlag : 0)
+        ),
+    };
+    const auto fits = span.Type != ParagraphSpanType::Block
+        && span.NthLine >= cursor.SpanNthLine && line_step <= 1
+        && span.CharStart >= char_base && span.GlyphStart >= glyph_base
+        && ToU16(run_step, packed.RunStep)
+        && ToU16(span.CharStart - char_base, packed.CharGap) && ToU16(span.CharLength, packed.CharLength)
+        && ToU16(span.GlyphStart - glyph_base, packed.GlyphGap) && ToU16(span.GlyphLength, packed.GlyphLength)
+        && ToFixed(span.Offset, packed.Offset) && ToFixed(span.Size, packed.Size)
+        && (packed.Info = InfoIndex(ParagraphLineInfo{.Ascent = span.Ascent, .Descent = span.Descent})) != NoInfo;
+    if (!fits)
+    {
+        packed = Span{
+            .Offset = static_cast<i32>(m_wide_spans.size()),
+            .Flags = WideFlag,
+        };
+        m_wide_spans.push_back(WideSpan{.Span = span, .Run = run});
+    }
+    m_spans.push_back(packed);
+
+    cursor.Run = run;
+    cursor.SpanNthLine = span.NthLine;
+    // Inline blocks have no chars, the next span continues from the span before
+    if (span.Type != ParagraphSpanType::Block || run_step != 0)
+    {
+        cursor.CharEnd = span.Type == ParagraphSpanType::Block ? 0 : span.CharStart + span.CharLength;
+        cursor.GlyphEnd = span.Type == ParagraphSpanType::Block ? 0 : span.GlyphStart + span.GlyphLength;
+    }
+}
+
+void PackedLines::AddLine(const ParagraphLine& line)
+{
+    auto& cursor = m_pack_cursor;
+    Line packed{};
+    const auto fits = line.NthLine >= cursor.LineNthLine && line.SpanStart == cursor.SpanEnd
+        && ToU16(line.NthLine - cursor.LineNthLine, packed.NthLineStep) && ToU16(line.SpanLength, packed.SpanLength)
+        && ToFixed(line.MainOffset, packed.MainOffset) && ToFixed(line.CrossOffset, packed.CrossOffset)
+        && ToFixed(line.MainSize, packed.MainSize) && ToFixed(line.CrossSize, packed.CrossSize)
+        && (packed.Info = InfoIndex(line)) != NoInfo;
+    if (!fits)
+    {
+        packed = Line{
+            .MainOffset = static_cast<i32>(m_wide_lines.size()),
+            .Flags = WideFlag,
+        };
+        m_wide_lines.push_back(line);
+    }
+    m_lines.push_back(packed);
+
+    cursor.LineNthLine = line.NthLine;
+    cursor.SpanEnd = line.SpanStart + line.SpanLength;
+}
+
+usize PackedLines::Bytes() const
+{
+    return m_spans.capacity() * sizeof(Span) + m_lines.capacity() * sizeof(Line)
+        + m_infos.capacity() * sizeof(ParagraphLineInfo) + m_wide_spans.capacity() * sizeof(WideSpan)
+        + m_wide_lines.capacity() * sizeof(ParagraphLine);
+}
+
+ParagraphSpan PackedLines::Reader::NextSpan(u32& run)
+{
+    const auto& packed = m_packed->m_spans[m_span++];
+    auto& cursor = m_cursor;
+    ParagraphSpan span;
+    if (packed.Flags & WideFlag)
+    {
+        const auto& wide = m_packed->m_wide_spans[packed.Offset];
+        span = wide.Span;
+        run = wide.Run;
+        if (span.Type != ParagraphSpanType::Block || run != cursor.Run)
+        {
+            cursor.CharEnd = span.Type == ParagraphSpanType::Block ? 0 : span.CharStart + span.CharLength;
+            cursor.GlyphEnd = span.Type == ParagraphSpanType::Block ? 0 : span.GlyphStart + span.GlyphLength;
+        }
+    }
+    else
+    {
+        run = cursor.Run + packed.RunStep;
+        const auto& info = m_packed->m_infos[packed.Info];
+        span = ParagraphSpan{
+            .NthLine = cursor.SpanNthLine + ((packed.Flags & NextLineFlag) ? 1 : 0),
+            .CharStart = (packed.RunStep == 0 ? cursor.CharEnd : 0) + packed.CharGap,
+            .CharLength = packed.CharLength,
+            .GlyphStart = (packed.RunStep == 0 ? cursor.GlyphEnd : 0) + packed.GlyphGap,
+            .GlyphLength = packed.GlyphLength,
+            .Ascent = info.Ascent,
+            .Descent = info.Descent,
+            .Offset = FromFixed(packed.Offset),
+            .Size = FromFixed(packed.Size),
+            .Type = static_cast<ParagraphSpanType>(packed.Flags & TypeMask),
+            .NeedReShape = (packed.Flags & NeedReShapeFlag) != 0,
+        };
+        cursor.CharEnd = span.CharStart + span.CharLength;
+        cursor.GlyphEnd = span.GlyphStart + span.GlyphLength;
+    }
+    cursor.Run = run;
+    cursor.SpanNthLine = span.NthLine;
+    return span;
+}
+
+ParagraphLine PackedLines::Reader::NextLine()
+{
+    const auto& packed = m_packed->m_lines[m_line++];
+    auto& cursor = m_cursor;
+    ParagraphLine line;
+    if (packed.Flags & WideFlag)
+    {
+        line = m_packed->m_wide_lines[packed.MainOffset];
+    }
+    else
+    {
+        line = ParagraphLine{m_packed->m_infos[packed.Info]};
+        line.NthLine = cursor.LineNthLine + packed.NthLineStep;
+        line.MainOffset = FromFixed(packed.MainOffset);
+        line.CrossOffset = FromFixed(packed.CrossOffset);
+        line.MainSize = FromFixed(packed.MainSize);
+        line.CrossSize = FromFixed(packed.CrossSize);
+        line.SpanStart = cursor.SpanEnd;
+        line.SpanLength = packed.SpanLength;
+    }
+    cursor.LineNthLine = line.NthLine;
+    cursor.SpanEnd = line.SpanStart + line.SpanLength;
+    return line;
+}
+
+void PackedLines::Unpack(
+    std::vector<ParagraphSpan>& spans, std::vector<u32>& run_of_span, std::vector<ParagraphLine>& lines
+) const
+{
+    spans.clear();
+    run_of_span.clear();
+    lines.clear();
+    spans.reserve(m_spans.size());
+    run_of_span.reserve(m_spans.size());
+    lines.reserve(m_lines.size());
+    Reader reader(*this);
+    while (reader.HasSpan())
+    {
+        u32 run;
+        spans.push_back(reader.NextSpan(run));
+        run_of_span.push_back(run);
+    }
+    while (reader.HasLine()) lines.push_back(reader.NextLine());
+}
+
+void PackedLines::ToLineData(
+    const WritingDirection direction, const std::span<const u32> run_starts, const std::span<const u32> run_nodes,
+    std::vector<LineData>& lines, std::vector<LineSpanData>& spans
+) const
+{
+    const auto is_row = direction == WritingDirection::Horizontal;
+    lines.clear();
+    spans.clear();
+    lines.reserve(m_lines.size());
+    spans.reserve(m_spans.size());
+    Reader reader(*this);
+    while (reader.HasSpan())
+    {
+        u32 run;
+        const auto span = reader.NextSpan(run);
+        if (run >= run_starts.size() || run >= run_nodes.size()) throw Exception("Argument out of range");
+        const auto is_block = span.Type == ParagraphSpanType::Block;
+        // Spans are placed on their line by the line offsets
+        const auto cross_size = is_block ? span.CrossSize : span.Ascent + span.Descent;
+        const auto start = is_block ? run_starts[run] : run_starts[run] + span.CharStart;
+        spans.push_back(
+            LineSpanData{
+                .X = is_row ? span.Offset : 0,
+                .Y = is_row ? 0 : span.Offset,
+                .Width = is_row ? span.Size : cross_size,
+                .Height = is_row ? cross_size : span.Size,
+                .BaseLine = is_block ? cross_size : span.Ascent,
+                .NthLine = span.NthLine,
+                .NodeIndex = run_nodes[run],
+                .RunRange = run,
+                .Start = start,
+                .End = is_block ? start : start + span.CharLength,
+                .Type = ToLineSpanType(span.Type),
+            }
+        );
+    }
+    while (reader.HasLine())
+    {
+        const auto line = reader.NextLine();
+        lines.push_back(
+            LineData{
+                .X = is_row ? line.MainOffset : line.CrossOffset,
+                .Y = is_row ? line.CrossOffset : line.MainOffset,
+                .Width = is_row ? line.MainSize : line.CrossSize,
+                .Height = is_row ? line.CrossSize : line.MainSize,
+                .BaseLine = line.Ascent,
+                .NthLine = line.NthLine,
+                .SpanStart = line.SpanStart,
+                .SpanEnd = line.SpanStart + line.SpanLength,
+            }
+        );
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "Com.h"
+#include "FlatMap.h"
+#include "LayoutCommon.h"
+
+namespace Coplt::LayoutCalc
+{
+    // The final spans and lines of a paragraph in about half the memory of ParagraphSpan and ParagraphLine:
+    // char and glyph positions are stored relative to the end of the previous span of the run, offsets and sizes
+    // are fixed point rounded to 1/256, and the ascent, descent and line gap are deduplicated into a table since a
+    // paragraph only uses a few fonts and sizes. Spans and lines that do not fit, inline blocks, very long spans,
+    // huge or non finite sizes, are kept unpacked on the side. Decoding is sequential, see Reader
+    struct PackedLines
+    {
+        // 8 fraction bits, positions up to 2^23 keep their precision
+        static constexpr f32 FixedScale = 256;
+
+        static constexpr u8 TypeMask = 0b11;
+        static constexpr u8 NeedReShapeFlag = 1 << 2;
+        // Offset is the index of the span or line in the wide list
+        static constexpr u8 WideFlag = 1 << 3;
+        // The span is on the line after the one of the previous span
+        static constexpr u8 NextLineFlag = 1 << 4;
+
+        struct Span
+        {
+            // Fixed point, Horizontal is x, Vertical is y
+            i32 Offset;
+            // Fixed point, Horizontal is width, Vertical is height
+            i32 Size;
+            // Chars between the end of the previous span of the run and the start of this one
+            u16 CharGap;
+            u16 CharLength;
+            u16 GlyphGap;
+            u16 GlyphLength;
+            // Ascent and descent in m_infos
+            u16 Info;
+            // Runs started since the previous span
+            u8 RunStep;
+            u8 Flags;
+        };
+
+        struct WideSpan
+        {
+            ParagraphSpan Span;
+            u32 Run;
+        };
+
+        struct Line
+        {
+            // Fixed point, Horizontal is x, Vertical is y
+            i32 MainOffset;
+            i32 CrossOffset;
+            i32 MainSize;
+            i32 CrossSize;
+            u16 Info;
+            // Lines started since the previous line
+            u16 NthLineStep;
+            // The spans of a line directly follow those of the previous line
+            u16 SpanLength;
+            u8 Flags;
+        };
+
+        struct InfoKey
+        {
+            u32 Ascent;
+            u32 Descent;
+            u32 LineGap;
+            u32 MinSize;
+
+            i32 GetHashCode() const;
+            bool operator==(const InfoKey&) const = default;
+        };
+
+        std::vector<Span> m_spans{};
+        std::vector<Line> m_lines{};
+        std::vector<ParagraphLineInfo> m_infos{};
+        std::vector<WideSpan> m_wide_spans{};
+        std::vector<ParagraphLine> m_wide_lines{};
+        FlatMap<InfoKey, u16> m_info_map{};
+        // Spans of a run share their info, most lookups hit the previous one
+        InfoKey m_last_info_key{};
+        u16 m_last_info{0xFFFF};
+
+        // End of the previous span or line, what the next one is stored relative to
+        struct Cursor
+        {
+            u32 Run{};
+            u32 CharEnd{};
+            u32 GlyphEnd{};
+            u32 SpanNthLine{};
+            u32 LineNthLine{};
+            u32 SpanEnd{};
+        };
+
+        Cursor m_pack_cursor{};
+
+        // run_of_span[i] is the run of spans[i], runs must not decrease
+        static PackedLines Pack(
+            std::span<const ParagraphSpan> spans, std::span<const u32> run_of_span, std::span<const ParagraphLine> lines
+        );
+
+        void Clear();
+        // Appends after the spans and lines packed so far
+        void AddSpan(const ParagraphSpan& span, u32 run);
+        void AddLine(const ParagraphLine& line);
+
+        u32 SpanCount() const { return static_cast<u32>(m_spans.size()); }
+        u32 LineCount() const { return static_cast<u32>(m_lines.size()); }
+        // Heap bytes in use, the table map excluded
+        usize Bytes() const;
+
+        struct Reader
+        {
+            const PackedLines* m_packed;
+            u32 m_span{};
+            u32 m_line{};
+            Cursor m_cursor{};
+
+            explicit Reader(const PackedLines& packed) : m_packed(&packed)
+            {
+            }
+
+            bool HasSpan() const { return m_span < m_packed->m_spans.size(); }
+            bool HasLine() const { return m_line < m_packed->m_lines.size(); }
+            // Decodes the next span, run receives its run
+            ParagraphSpan NextSpan(u32& run);
+            ParagraphLine NextLine();
+        };
+
+        void Unpack(
+            std::vector<ParagraphSpan>& spans, std::vector<u32>& run_of_span, std::vector<ParagraphLine>& lines
+        ) const;
+
+        // Fills the ffi line data; run_starts is the first char of every run in the paragraph, run_nodes the node
+        // index of every run
+        void ToLineData(
+            WritingDirection direction, std::span<const u32> run_starts, std::span<const u32> run_nodes,
+            std::vector<LineData>& lines, std::vector<LineSpanData>& spans
+        ) const;
+
+    private:
+        u16 InfoIndex(const ParagraphLineInfo& info);
+    };
+}
@@ -0,0 +1,297 @@
+#include "Path.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#define COPLT_PATH_SSE2
+#endif
+
+using namespace Coplt;
+
+namespace
+{
+    // Grows geometrically, reserving exactly for every batch would reallocate on each one
+    template <class T>
+    void Grow(std::vector<T>& vec, const usize extra)
+    {
+        const auto need = vec.size() + extra;
+        if (need > vec.capacity()) vec.reserve(std::max(need, vec.capacity() * 2));
+    }
+
+    // Quarter turns at most, the cubic approximation error grows fast past that
+    constexpr f32 MaxArcSegmentAngle = std::numbers::pi_v<f32> / 2;
+    constexpr u32 MaxArcSegments = 1024;
+}
+
+AABB2DF Coplt::CalcPointsAABB(const PathPoint* points, const u32 count)
+{
+    if (count == 0) return AABB2DF{};
+
+    auto min_x = points[0].X, min_y = points[0].Y, max_x = min_x, max_y = min_y;
+    u32 i = 0;
+#ifdef COPLT_PATH_SSE2
+    if (count >= 2)
+    {
+        // x y x y, the lanes of a point pair are reduced at the end
+        auto mn = _mm_loadu_ps(&points[0].X);
+        auto mx = mn;
+#ifdef __AVX__
+        if (count >= 4)
+        {
+            auto mn8 = _mm256_loadu_ps(&points[0].X);
+            auto mx8 = mn8;
+            for (i = 4; i + 4 <= count; i += 4)
+            {
+                const auto v = _mm256_loadu_ps(&points[i].X);
+                mn8 = _mm256_min_ps(mn8, v);
+                mx8 = _mm256_max_ps(mx8, v);
+            }
+            mn = _mm_min_ps(_mm256_castps256_ps128(mn8), _mm256_extractf128_ps(mn8, 1));
+            mx = _mm_max_ps(_mm256_castps256_ps128(mx8), _mm256_extractf128_ps(mx8, 1));
+        }
+        else i = 2;
+#else
+        i = 2;
+#endif
+        for (; i + 2 <= count; i += 2)
+        {
+            const auto v = _mm_loadu_ps(&points[i].X);
+            mn = _mm_min_ps(mn, v);
+            mx = _mm_max_ps(mx, v);
+        }
+        mn = _mm_min_ps(mn, _mm_movehl_ps(mn, mn));
+        mx = _mm_max_ps(mx, _mm_movehl_ps(mx, mx));
+        alignas(16) f32 lanes[4];
+        _mm_store_ps(lanes, mn);
+        min_x = lanes[0];
+        min_y = lanes[1];
+        _mm_store_ps(lanes, mx);
+        max_x = lanes[0];
+        max_y = lanes[1];
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        min_x = std::min(min_x, points[i].X);
+        min_y = std::min(min_y, points[i].Y);
+        max_x = std::max(max_x, points[i].X);
+        max_y = std::max(max_y, points[i].Y);
+    }
+    return AABB2DF{.MinX = min_x, .MinY = min_y, .MaxX = max_x, .MaxY = max_y};
+}
+
+Path::Path(const std::span<const PathVerb> verbs, const std::span<const PathPoint> points)
+    : m_verb_count(static_cast<u32>(verbs.size())), m_point_count(static_cast<u32>(points.size())),
+      m_data(std::make_unique_for_overwrite<u8[]>(sizeof(PathPoint) * points.size() + verbs.size()))
+{
+    if (!points.empty()) std::memcpy(m_data.get(), points.data(), sizeof(PathPoint) * points.size());
+    if (!verbs.empty()) std::memcpy(m_data.get() + sizeof(PathPoint) * points.size(), verbs.data(), verbs.size());
+}
+
+u64 Path::ContentHash() const
+{
+    if (const auto hash = m_hash.load(std::memory_order_relaxed); hash != 0) return hash;
+    const auto mix = [](u64 hash, const u64 value)
+    {
+        hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+        return hash ^ (hash >> 32);
+    };
+    const auto data = Data();
+    auto hash = mix(m_point_count, m_verb_count);
+    usize i = 0;
+    for (; i + 8 <= data.size(); i += 8)
+    {
+        u64 word;
+        std::memcpy(&word, data.data() + i, 8);
+        hash = mix(hash, word);
+    }
+    if (i < data.size())
+    {
+        u64 tail = 0;
+        std::memcpy(&tail, data.data() + i, data.size() - i);
+        hash = mix(hash, tail);
+    }
+    // 0 marks not computed yet, racing threads store the same value
+    if (hash == 0) hash = 1;
+    m_hash.store(hash, std::memory_order_relaxed);
+    return hash;
+}
+
+void Path::Impl_CalcAABB(AABB2DF* out_aabb)
+{
+    const auto points = Points();
+    *out_aabb = CalcPointsAABB(points.data(), static_cast<u32>(points.size()));
+}
+
+Rc<Path> PathBuilder::Build()
+{
+    auto path = Rc(new Path(m_verbs, m_points));
+    Clear();
+    return path;
+}
+
+void PathBuilder::Clear()
+{
+    m_verbs.clear();
+    m_points.clear();
+    m_current = {};
+    m_sub_path_start = {};
+    m_in_sub_path = false;
+}
+
+void PathBuilder::Reserve(const u32 endpoints, const u32 ctrl_points)
+{
+    // Every endpoint comes with a verb
+    Grow(m_verbs, endpoints);
+    Grow(m_points, static_cast<usize>(endpoints) + ctrl_points);
+}
+
+void PathBuilder::Batch(const std::span<const PathBuilderCmd> cmds)
+{
+    // Enough unless there are arcs, which take up to 4 cubics each
+    Grow(m_verbs, cmds.size());
+    Grow(m_points, cmds.size() * 3);
+    for (const auto& cmd : cmds)
+    {
+        switch (cmd.Type)
+        {
+        case PathBuilderCmdType::Close:
+            Close();
+            break;
+        case PathBuilderCmdType::MoveTo:
+            MoveTo({cmd.XTo.X, cmd.XTo.Y});
+            break;
+        case PathBuilderCmdType::LineTo:
+            LineTo({cmd.XTo.X, cmd.XTo.Y});
+            break;
+        case PathBuilderCmdType::QuadraticBezierTo:
+        {
+            const auto& c = cmd.QuadraticBezierTo;
+            QuadTo({c.CtrlX, c.CtrlY}, {c.ToX, c.ToY});
+            break;
+        }
+        case PathBuilderCmdType::CubicBezierTo:
+        {
+            const auto& c = cmd.CubicBezierTo;
+            CubicTo({c.Ctrl0X, c.Ctrl0Y}, {c.Ctrl1X, c.Ctrl1Y}, {c.ToX, c.ToY});
+            break;
+        }
+        case PathBuilderCmdType::Arc:
+        {
+            const auto& c = cmd.Arc;
+            Arc({c.CenterX, c.CenterY}, {c.RadiiX, c.RadiiY}, c.SweepAngle, c.XRotation);
+            break;
+        }
+        default:
+            // Batch has no way to report errors, unknown commands are skipped
+            break;
+        }
+    }
+}
+
+void PathBuilder::Arc(const PathPoint center, const PathPoint radii, const f32 sweep_angle, const f32 x_rotation)
+{
+    if (sweep_angle == 0 || radii.X == 0 || radii.Y == 0 || !std::isfinite(sweep_angle)) return;
+    EnsureSubPath();
+
+    const auto cos_r = std::cos(x_rotation), sin_r = std::sin(x_rotation);
+    // The ellipse point and tangent at an angle, rotated by x_rotation
+    const auto at = [&](const f32 angle)
+    {
+        const auto x = radii.X * std::cos(angle), y = radii.Y * std::sin(angle);
+        return PathPoint{center.X + x * cos_r - y * sin_r, center.Y + x * sin_r + y * cos_r};
+    };
+    const auto tangent = [&](const f32 angle)
+    {
+        const auto x = -radii.X * std::sin(angle), y = radii.Y * std::cos(angle);
+        return PathPoint{x * cos_r - y * sin_r, x * sin_r + y * cos_r};
+    };
+
+    // The arc starts at the current point, find its angle on the unrotated ellipse
+    const auto dx = m_current.X - center.X, dy = m_current.Y - center.Y;
+    const auto start = std::atan2((dy * cos_r - dx * sin_r) / radii.Y, (dx * cos_r + dy * sin_r) / radii.X);
+
+    const auto segments = std::min(
+        MaxArcSegments, std::max(1u, static_cast<u32>(std::ceil(std::fabs(sweep_angle) / MaxArcSegmentAngle)))
+    );
+    const auto step = sweep_angle / static_cast<f32>(segments);
+    const auto k = 4.0f / 3.0f * std::tan(step / 4);
+    Grow(m_verbs, segments);
+    Grow(m_points, segments * 3);
+    auto from = m_current;
+    auto from_tangent = tangent(start);
+    for (u32 i = 1; i <= segments; ++i)
+    {
+        const auto angle = start + step * static_cast<f32>(i);
+        const auto to = at(angle);
+        const auto to_tangent = tangent(angle);
+        CubicTo(
+            {from.X + k * from_tangent.X, from.Y + k * from_tangent.Y},
+            {to.X - k * to_tangent.X, to.Y - k * to_tangent.Y},
+            to
+        );
+        from = to;
+        from_tangent = to_tangent;
+    }
+}
+
+HResult PathBuilder::Impl_Build(IPath** path)
+{
+    return feb(
+        [&]
+        {
+            *path = Build().leak();
+            return HResultE::Ok;
+        }
+    );
+}
+
+void PathBuilder::Impl_Reserve(const i32 Endpoints, const i32 CtrlPoints)
+{
+    Reserve(static_cast<u32>(std::max(Endpoints, 0)), static_cast<u32>(std::max(CtrlPoints, 0)));
+}
+
+void PathBuilder::Impl_Batch(PathBuilderCmd const* cmds, const i32 num_cmds)
+{
+    if (num_cmds <= 0) return;
+    Batch(std::span(cmds, static_cast<usize>(num_cmds)));
+}
+
+void PathBuilder::Impl_Close()
+{
+    Close();
+}
+
+void PathBuilder::Impl_MoveTo(const f32 x, const f32 y)
+{
+    MoveTo({x, y});
+}
+
+void PathBuilder::Impl_LineTo(const f32 x, const f32 y)
+{
+    LineTo({x, y});
+}
+
+void PathBuilder::Impl_QuadraticBezierTo(const f32 ctrl_x, const f32 ctrl_y, const f32 to_x, const f32 to_y)
+{
+    QuadTo({ctrl_x, ctrl_y}, {to_x, to_y});
+}
+
+void PathBuilder::Impl_CubicBezierTo(
+    const f32 ctrl0_x, const f32 ctrl0_y, const f32 ctrl1_x, const f32 ctrl1_y, const f32 to_x, const f32 to_y
+)
+{
+    CubicTo({ctrl0_x, ctrl0_y}, {ctrl1_x, ctrl1_y}, {to_x, to_y});
+}
+
+void PathBuilder::Impl_Arc(
+    const f32 center_x, const f32 center_y, const f32 radii_x, const f32 radii_y, const f32 sweep_angle,
+    const f32 x_rotation
+)
+{
+    Arc({center_x, center_y}, {radii_x, radii_y}, sweep_angle, x_rotation);
+}
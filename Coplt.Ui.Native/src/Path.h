@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Com.h"
+
+namespace Coplt
+{
+    enum class PathVerb : u8
+    {
+        // 1 point
+        MoveTo,
+        // 1 point
+        LineTo,
+        // Ctrl and to
+        QuadTo,
+        // Ctrl0, ctrl1 and to
+        CubicTo,
+        // Back to the point of the last MoveTo, no point
+        Close,
+    };
+
+    struct PathPoint
+    {
+        f32 X;
+        f32 Y;
+    };
+
+    COPLT_FORCE_INLINE constexpr u32 PointCountOf(const PathVerb verb)
+    {
+        constexpr u8 counts[] = {1, 1, 2, 3, 0};
+        return counts[static_cast<u8>(verb)];
+    }
+
+    // Min and max over the points, control points included, so the box contains the curves but may be loose
+    AABB2DF CalcPointsAABB(const PathPoint* points, u32 count);
+
+    // Immutable, verbs and points each tightly packed in one allocation shared by both
+    struct Path final : ComImpl<Path, IPath>
+    {
+        u32 m_verb_count{};
+        u32 m_point_count{};
+        // Points, then verbs
+        std::unique_ptr<u8[]> m_data{};
+        // 0 until ContentHash is first asked for
+        mutable std::atomic<u64> m_hash{};
+
+        Path(std::span<const PathVerb> verbs, std::span<const PathPoint> points);
+
+        std::span<const PathPoint> Points() const
+        {
+            return std::span(reinterpret_cast<const PathPoint*>(m_data.get()), m_point_count);
+        }
+
+        std::span<const PathVerb> Verbs() const
+        {
+            return std::span(
+                reinterpret_cast<const PathVerb*>(m_data.get() + sizeof(PathPoint) * m_point_count), m_verb_count
+            );
+        }
+
+        // Points and verbs as one byte range, equal for paths with the same content
+        std::span<const u8> Data() const
+        {
+            return std::span(m_data.get(), sizeof(PathPoint) * m_point_count + m_verb_count);
+        }
+
+        // Of the counts and the data, computed once
+        u64 ContentHash() const;
+
+        COPLT_IMPL_START
+
+        COPLT_FORCE_INLINE
+        void Impl_CalcAABB(AABB2DF* out_aabb);
+
+        COPLT_IMPL_END
+    };
+
+    // Arcs are converted to cubic beziers as they are added, so paths only hold lines and beziers. Drawing without
+    // a MoveTo first starts a sub path at the current point, the origin for a new builder. Build copies into the
+    // path and clears the builder, its buffers are kept for the next path
+    struct PathBuilder final : ComImpl<PathBuilder, IPathBuilder>
+    {
+        std::vector<PathVerb> m_verbs{};
+        std::vector<PathPoint> m_points{};
+        PathPoint m_current{};
+        PathPoint m_sub_path_start{};
+        bool m_in_sub_path{};
+
+        Rc<Path> Build();
+        void Clear();
+
+        void Reserve(u32 endpoints, u32 ctrl_points);
+        void Batch(std::span<const PathBuilderCmd> cmds);
+
+        COPLT_FORCE_INLINE void Close()
+        {
+            if (!m_in_sub_path) return;
+            m_verbs.push_back(PathVerb::Close);
+            m_current = m_sub_path_start;
+            m_in_sub_path = false;
+        }
+
+        COPLT_FORCE_INLINE void MoveTo(const PathPoint to)
+        {
+            m_verbs.push_back(PathVerb::MoveTo);
+            m_points.push_back(to);
+            m_current = m_sub_path_start = to;
+            m_in_sub_path = true;
+        }
+
+        COPLT_FORCE_INLINE void LineTo(const PathPoint to)
+        {
+            EnsureSubPath();
+            m_verbs.push_back(PathVerb::LineTo);
+            m_points.push_back(to);
+            m_current = to;
+        }
+
+        COPLT_FORCE_INLINE void QuadTo(const PathPoint ctrl, const PathPoint to)
+        {
+            EnsureSubPath();
+            m_verbs.push_back(PathVerb::QuadTo);
+            m_points.push_back(ctrl);
+            m_points.push_back(to);
+            m_current = to;
+        }
+
+        COPLT_FORCE_INLINE void CubicTo(const PathPoint ctrl0, const PathPoint ctrl1, const PathPoint to)
+        {
+            EnsureSubPath();
+            m_verbs.push_back(PathVerb::CubicTo);
+            m_points.push_back(ctrl0);
+            m_points.push_back(ctrl1);
+            m_points.push_back(to);
+            m_current = to;
+        }
+
+        // From the current point around center, sweep_angle and x_rotation in radians
+        void Arc(PathPoint center, PathPoint radii, f32 sweep_angle, f32 x_rotation);
+
+        COPLT_IMPL_START
+
+        COPLT_FORCE_INLINE
+        HResult Impl_Build(IPath** path);
+
+        COPLT_FORCE_INLINE
+        void Impl_Reserve(i32 Endpoints, i32 CtrlPoints);
+
+        COPLT_FORCE_INLINE
+        void Impl_Batch(PathBuilderCmd const* cmds, i32 num_cmds);
+
+        COPLT_FORCE_INLINE
+        void Impl_Close();
+
+        COPLT_FORCE_INLINE
+        void Impl_MoveTo(f32 x, f32 y);
+
+        COPLT_FORCE_INLINE
+        void Impl_LineTo(f32 x, f32 y);
+
+        COPLT_FORCE_INLINE
+        void Impl_QuadraticBezierTo(f32 ctrl_x, f32 ctrl_y, f32 to_x, f32 to_y);
+
+        COPLT_FORCE_INLINE
+        void Impl_CubicBezierTo(f32 ctrl0_x, f32 ctrl0_y, f32 ctrl1_x, f32 ctrl1_y, f32 to_x, f32 to_y);
+
+        COPLT_FORCE_INLINE
+        void Impl_Arc(f32 center_x, f32 center_y, f32 radii_x, f32 radii_y, f32 sweep_angle, f32 x_rotation);
+
+        COPLT_IMPL_END
+
+    private:
+        COPLT_FORCE_INLINE void EnsureSubPath()
+        {
+            if (!m_in_sub_path) MoveTo(m_current);
+        }
+    };
+} // namespace Coplt
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <mimalloc.h>
+
+#include "Com.h"
+
+namespace Coplt
+{
+    // FIFO queue over a ring of N inline items, only spills to the heap if more than N items are queued at once
+    template <class T, i32 N>
+    struct RingBuffer
+    {
+        static_assert(N > 0);
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+
+        alignas(T) std::byte m_inline[sizeof(T) * N];
+        T* m_items{reinterpret_cast<T*>(m_inline)};
+        i32 m_cap{N};
+        i32 m_head{};
+        i32 m_size{};
+
+        ~RingBuffer()
+        {
+            if (!IsInline()) mi_free(m_items);
+        }
+
+        RingBuffer()
+        {
+        }
+
+        RingBuffer(const RingBuffer& other) = delete;
+        RingBuffer& operator=(const RingBuffer& other) = delete;
+
+        bool IsInline() const
+        {
+            return m_items == reinterpret_cast<const T*>(m_inline);
+        }
+
+        i32 Count() const
+        {
+            return m_size;
+        }
+
+        i32 Capacity() const
+        {
+            return m_cap;
+        }
+
+        bool IsEmpty() const
+        {
+            return m_size == 0;
+        }
+
+        bool IsFull() const
+        {
+            return m_size == m_cap;
+        }
+
+        // Index 0 is the front
+        T& operator[](const i32 index)
+        {
+            if (static_cast<u32>(index) >= static_cast<u32>(m_size)) throw Exception("Index out of range");
+            return m_items[Wrap(m_head + index)];
+        }
+
+        const T& operator[](const i32 index) const
+        {
+            if (static_cast<u32>(index) >= static_cast<u32>(m_size)) throw Exception("Index out of range");
+            return m_items[Wrap(m_head + index)];
+        }
+
+        T& Front()
+        {
+            return (*this)[0];
+        }
+
+        T& Back()
+        {
+            return (*this)[m_size - 1];
+        }
+
+        void PushBack(const T& value)
+        {
+            if (IsFull()) [[unlikely]] Grow();
+            m_items[Wrap(m_head + m_size)] = value;
+            m_size++;
+        }
+
+        void PopFront()
+        {
+            if (m_size == 0) throw Exception("Ring buffer is empty");
+            m_head = Wrap(m_head + 1);
+            m_size--;
+        }
+
+        void PopFront(const i32 count)
+        {
+            if (static_cast<u32>(count) > static_cast<u32>(m_size)) throw Exception("Argument out of range");
+            m_head = Wrap(m_head + count);
+            m_size -= count;
+        }
+
+        // Keeps the current storage
+        void Clear()
+        {
+            m_head = 0;
+            m_size = 0;
+        }
+
+    private:
+        i32 Wrap(const i32 index) const
+        {
+            return index >= m_cap ? index - m_cap : index;
+        }
+
+        COPLT_NO_INLINE
+        void Grow()
+        {
+            const auto cap = m_cap * 2;
+            const auto items = static_cast<T*>(mi_malloc_aligned(sizeof(T) * cap, alignof(T)));
+            if (items == nullptr) throw std::bad_alloc();
+            const auto first = std::min(m_size, m_cap - m_head);
+            std::memcpy(items, m_items + m_head, sizeof(T) * first);
+            std::memcpy(items + first, m_items, sizeof(T) * (m_size - first));
+            if (!IsInline()) mi_free(m_items);
+            m_items = items;
+            m_cap = cap;
+            m_head = 0;
+        }
+    };
+}
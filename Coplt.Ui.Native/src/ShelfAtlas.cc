@@ -0,0 +1,213 @@
+#include "ShelfAtlas.h"
+
+#include <algorithm>
+#include <bit>
+
+using namespace Coplt;
+
+namespace
+{
+    constexpr i32 ShelfQuantum = 4;
+
+    // Small rects get exact 4px classes, larger ones coarser classes so a row wastes at most about an eighth of it
+    i32 ShelfHeightOf(const i32 height)
+    {
+        const auto align = height <= 32 ? ShelfQuantum : static_cast<i32>(std::bit_ceil(static_cast<u32>(height)) / 8);
+        return (height + align - 1) / align * align;
+    }
+}
+
+ShelfAtlasAllocator::ShelfAtlasAllocator(const i32 width, const i32 height)
+    : m_width(std::max(width, 0)), m_height(std::max(height, 0))
+{
+    Clear();
+}
+
+void ShelfAtlasAllocator::Clear()
+{
+    m_shelves.clear();
+    m_dead_shelves.clear();
+    m_classes.clear();
+    // Classes of heights that are no multiple of the quantum round up
+    m_classes.resize((m_height + ShelfQuantum - 1) / ShelfQuantum + 1);
+    m_bands.clear();
+    if (m_height > 0) m_bands.push_back(Range{.Start = 0, .Size = m_height});
+    m_items.clear();
+    m_dead_items.clear();
+    m_live = 0;
+}
+
+bool ShelfAtlasAllocator::Allocate(const i32 width, const i32 height, u32& id, AABB2DI& rect)
+{
+    if (width <= 0 || height <= 0 || width > m_width || height > m_height) return false;
+    // The last class may be cut short by the atlas
+    const auto shelf_height = std::min(ShelfHeightOf(height), m_height);
+    auto& shelves = m_classes[(shelf_height + ShelfQuantum - 1) / ShelfQuantum];
+
+    // Newest rows first, older ones are usually full
+    u32 shelf_index = InvalidShelf;
+    i32 x = -1;
+    for (auto i = shelves.size(); i-- > 0;)
+    {
+        x = PlaceIn(m_shelves[shelves[i]], width);
+        if (x >= 0)
+        {
+            shelf_index = shelves[i];
+            break;
+        }
+    }
+    if (shelf_index == InvalidShelf)
+    {
+        const auto opened = OpenShelf(shelf_height);
+        if (opened < 0) return false;
+        shelf_index = static_cast<u32>(opened);
+        shelves.push_back(shelf_index);
+        x = PlaceIn(m_shelves[shelf_index], width);
+    }
+
+    auto& shelf = m_shelves[shelf_index];
+    ++shelf.Count;
+    ++m_live;
+    const Item item{.Shelf = shelf_index, .X = x, .Width = width};
+    if (m_dead_items.empty())
+    {
+        id = static_cast<u32>(m_items.size());
+        m_items.push_back(item);
+    }
+    else
+    {
+        id = m_dead_items.back();
+        m_dead_items.pop_back();
+        m_items[id] = item;
+    }
+    rect = AABB2DI{.MinX = x, .MinY = shelf.Y, .MaxX = x + width, .MaxY = shelf.Y + height};
+    return true;
+}
+
+void ShelfAtlasAllocator::Deallocate(const u32 id)
+{
+    if (id >= m_items.size() || m_items[id].Shelf == InvalidShelf) return;
+    auto& item = m_items[id];
+    auto& shelf = m_shelves[item.Shelf];
+    --m_live;
+    if (--shelf.Count == 0) CloseShelf(item.Shelf);
+    else
+    {
+        FreeRange(shelf.Free, Range{.Start = item.X, .Size = item.Width});
+        // A free range touching the cursor goes back to the open end
+        if (const auto& last = shelf.Free.back(); last.Start + last.Size == shelf.Cursor)
+        {
+            shelf.Cursor = last.Start;
+            shelf.Free.pop_back();
+        }
+    }
+    item.Shelf = InvalidShelf;
+    m_dead_items.push_back(id);
+}
+
+i32 ShelfAtlasAllocator::PlaceIn(Shelf& shelf, const i32 width)
+{
+    for (auto it = shelf.Free.begin(); it != shelf.Free.end(); ++it)
+    {
+        if (it->Size < width) continue;
+        const auto x = it->Start;
+        if (it->Size == width) shelf.Free.erase(it);
+        else
+        {
+            it->Start += width;
+            it->Size -= width;
+        }
+        return x;
+    }
+    if (width > m_width - shelf.Cursor) return -1;
+    const auto x = shelf.Cursor;
+    shelf.Cursor += width;
+    return x;
+}
+
+i32 ShelfAtlasAllocator::OpenShelf(const i32 height)
+{
+    // Best fit, so the band of a closed row goes to a row of about its height
+    auto best = m_bands.end();
+    for (auto it = m_bands.begin(); it != m_bands.end(); ++it)
+    {
+        if (it->Size >= height && (best == m_bands.end() || it->Size < best->Size)) best = it;
+    }
+    if (best == m_bands.end()) return -1;
+    const auto y = best->Start;
+    if (best->Size == height) m_bands.erase(best);
+    else
+    {
+        best->Start += height;
+        best->Size -= height;
+    }
+
+    Shelf shelf{.Y = y, .Height = height, .Cursor = 0, .Count = 0};
+    if (m_dead_shelves.empty())
+    {
+        m_shelves.push_back(std::move(shelf));
+        return static_cast<i32>(m_shelves.size() - 1);
+    }
+    const auto index = m_dead_shelves.back();
+    m_dead_shelves.pop_back();
+    // Keeps the capacity of the free list
+    shelf.Free = std::move(m_shelves[index].Free);
+    shelf.Free.clear();
+    m_shelves[index] = std::move(shelf);
+    return static_cast<i32>(index);
+}
+
+void ShelfAtlasAllocator::CloseShelf(const u32 index)
+{
+    const auto& shelf = m_shelves[index];
+    auto& shelves = m_classes[(shelf.Height + ShelfQuantum - 1) / ShelfQuantum];
+    std::erase(shelves, index);
+    FreeRange(m_bands, Range{.Start = shelf.Y, .Size = shelf.Height});
+    m_dead_shelves.push_back(index);
+}
+
+void ShelfAtlasAllocator::FreeRange(std::vector<Range>& ranges, Range range)
+{
+    auto it = std::ranges::lower_bound(ranges, range.Start, {}, &Range::Start);
+    if (it != ranges.begin())
+    {
+        if (const auto prev = it - 1; prev->Start + prev->Size == range.Start)
+        {
+            range.Start = prev->Start;
+            range.Size += prev->Size;
+            it = ranges.erase(prev);
+        }
+    }
+    if (it != ranges.end() && range.Start + range.Size == it->Start)
+    {
+        range.Size += it->Size;
+        it = ranges.erase(it);
+    }
+    ranges.insert(it, range);
+}
+
+void ShelfAtlasAllocator::Impl_Clear()
+{
+    Clear();
+}
+
+bool ShelfAtlasAllocator::Impl_get_IsEmpty()
+{
+    return m_live == 0;
+}
+
+void ShelfAtlasAllocator::Impl_GetSize(i32* out_width, i32* out_height)
+{
+    *out_width = m_width;
+    *out_height = m_height;
+}
+
+bool ShelfAtlasAllocator::Impl_Allocate(const i32 width, const i32 height, u32* out_id, AABB2DI* out_rect)
+{
+    return Allocate(width, height, *out_id, *out_rect);
+}
+
+void ShelfAtlasAllocator::Impl_Deallocate(const u32 id)
+{
+    Deallocate(id);
+}
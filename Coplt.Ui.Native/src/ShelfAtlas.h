@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+
+#include "Com.h"
+
+namespace Coplt
+{
+    // Rows of rects spanning the whole width, each row only takes rects of one height class, so the many small and
+    // similarly sized rects of a glyph atlas pack tightly and are placed with a short scan. Freed ranges in a row are
+    // reused first fit; a row left empty gives its band back to the vertical free space, where rows of any class can
+    // take it again
+    struct ShelfAtlasAllocator final : ComImpl<ShelfAtlasAllocator, IAtlasAllocator>
+    {
+        struct Range
+        {
+            i32 Start;
+            i32 Size;
+        };
+
+        struct Shelf
+        {
+            i32 Y;
+            i32 Height;
+            // Everything right of it is free
+            i32 Cursor;
+            u32 Count;
+            // Freed ranges left of the cursor, sorted and never adjacent
+            std::vector<Range> Free;
+        };
+
+        struct Item
+        {
+            // Dead when InvalidShelf
+            u32 Shelf;
+            i32 X;
+            i32 Width;
+        };
+
+        static constexpr u32 InvalidShelf = 0xFFFF'FFFF;
+
+        i32 m_width;
+        i32 m_height;
+        std::vector<Shelf> m_shelves{};
+        // Indices of released shelves, their slots are reused
+        std::vector<u32> m_dead_shelves{};
+        // Live shelves by height class, most recently opened last
+        std::vector<std::vector<u32>> m_classes{};
+        // Vertical free space, sorted and never adjacent
+        std::vector<Range> m_bands{};
+        // Indexed by allocation id
+        std::vector<Item> m_items{};
+        std::vector<u32> m_dead_items{};
+        u32 m_live{};
+
+        ShelfAtlasAllocator(i32 width, i32 height);
+
+        void Clear();
+        bool Allocate(i32 width, i32 height, u32& id, AABB2DI& rect);
+        // Unknown or already freed ids are ignored
+        void Deallocate(u32 id);
+
+        COPLT_IMPL_START
+
+        COPLT_FORCE_INLINE
+        void Impl_Clear();
+
+        COPLT_FORCE_INLINE
+        bool Impl_get_IsEmpty();
+
+        COPLT_FORCE_INLINE
+        void Impl_GetSize(i32* out_width, i32* out_height);
+
+        COPLT_FORCE_INLINE
+        bool Impl_Allocate(i32 width, i32 height, u32* out_id, AABB2DI* out_rect);
+
+        COPLT_FORCE_INLINE
+        void Impl_Deallocate(u32 id);
+
+        COPLT_IMPL_END
+
+    private:
+        // Into the row, -1 if it does not fit
+        i32 PlaceIn(Shelf& shelf, i32 width);
+        // -1 when the vertical free space has no band tall enough
+        i32 OpenShelf(i32 height);
+        void CloseShelf(u32 index);
+
+        // Inserts and merges with the neighbours
+        static void FreeRange(std::vector<Range>& ranges, Range range);
+    };
+} // namespace Coplt
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <mimalloc.h>
+
+#include "Com.h"
+#include "List.h"
+
+namespace Coplt
+{
+    // List with the first N items stored inline, only spills to the heap once it outgrows them
+    template <class T, i32 N>
+    struct SmallList
+    {
+        static_assert(N > 0);
+
+        alignas(T) std::byte m_inline[sizeof(T) * N];
+        T* m_items{reinterpret_cast<T*>(m_inline)};
+        i32 m_cap{N};
+        i32 m_size{};
+
+        ~SmallList()
+        {
+            Clear();
+            if (!IsInline()) mi_free(m_items);
+        }
+
+        SmallList()
+        {
+        }
+
+        explicit SmallList(const i32 capacity)
+        {
+            if (capacity > N) SetCapacity(capacity);
+        }
+
+        SmallList(const SmallList& other) = delete;
+
+        SmallList(SmallList&& other) noexcept
+        {
+            if (other.IsInline())
+            {
+                ListDetails::RelocateItems(m_items, other.m_items, other.m_size);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            else
+            {
+                m_items = std::exchange(other.m_items, reinterpret_cast<T*>(other.m_inline));
+                m_cap = std::exchange(other.m_cap, N);
+                m_size = std::exchange(other.m_size, 0);
+            }
+        }
+
+        SmallList& operator=(const SmallList& other) = delete;
+
+        SmallList& operator=(SmallList&& other) noexcept
+        {
+            if (this != &other)
+            {
+                this->~SmallList();
+                new(this) SmallList(std::move(other));
+            }
+            return *this;
+        }
+
+        bool IsInline() const
+        {
+            return m_items == reinterpret_cast<const T*>(m_inline);
+        }
+
+        T& operator[](i32 index)
+        {
+            if (index < 0 || index >= m_size) throw Exception("Index out of range");
+            return m_items[index];
+        }
+
+        const T& operator[](i32 index) const
+        {
+            if (index < 0 || index >= m_size) throw Exception("Index out of range");
+            return m_items[index];
+        }
+
+        T* At(i32 index)
+        {
+            if (index < 0 || index >= m_size) throw Exception("Index out of range");
+            return &m_items[index];
+        }
+
+        const T* At(i32 index) const
+        {
+            if (index < 0 || index >= m_size) throw Exception("Index out of range");
+            return &m_items[index];
+        }
+
+        T* TryAt(i32 index)
+        {
+            if (index < 0 || index >= m_size) return nullptr;
+            return &m_items[index];
+        }
+
+        const T* TryAt(i32 index) const
+        {
+            if (index < 0 || index >= m_size) return nullptr;
+            return &m_items[index];
+        }
+
+        T* data()
+        {
+            return m_items;
+        }
+
+        const T* data() const
+        {
+            return m_items;
+        }
+
+        usize size() const
+        {
+            return m_size;
+        }
+
+        i32 Count() const
+        {
+            return m_size;
+        }
+
+        i32 Capacity() const
+        {
+            return m_cap;
+        }
+
+        // Capacities up to N always mean the inline storage
+        void SetCapacity(i32 value)
+        {
+            if (value < m_size) throw Exception("Argument out of range");
+            if (value < N) value = N;
+            if (value == m_cap) return;
+
+            if (value == N)
+            {
+                const auto items = m_items;
+                m_items = reinterpret_cast<T*>(m_inline);
+                ListDetails::RelocateItems(m_items, items, m_size);
+                mi_free(items);
+            }
+            else if (IsInline())
+            {
+                const auto items = static_cast<T*>(mi_malloc_aligned(sizeof(T) * value, alignof(T)));
+                ListDetails::RelocateItems(items, m_items, m_size);
+                m_items = items;
+            }
+            else
+            {
+                m_items = ListDetails::ReallocItems(m_items, m_size, value);
+            }
+
+            m_cap = value;
+        }
+
+        i32 GetNewCapacity(i32 capacity)
+        {
+            auto newCapacity = 2 * static_cast<i64>(m_cap);
+            if (newCapacity > std::numeric_limits<i32>::max()) newCapacity = std::numeric_limits<i32>::max();
+            if (newCapacity < capacity) newCapacity = capacity;
+            return static_cast<i32>(newCapacity);
+        }
+
+        void Grow(const i32 capacity)
+        {
+            SetCapacity(GetNewCapacity(capacity));
+        }
+
+        COPLT_NO_INLINE
+        T* UnsafeAddWithResize()
+        {
+            const auto size = m_size;
+            Grow(size + 1);
+            m_size = size + 1;
+            return &m_items[size];
+        }
+
+        T* UnsafeAdd()
+        {
+            const auto size = m_size;
+            if (static_cast<u32>(size) < static_cast<u32>(m_cap))
+            {
+                m_size = size + 1;
+                return &m_items[size];
+            }
+            else
+            {
+                return UnsafeAddWithResize();
+            }
+        }
+
+        void Add(T&& value)
+        {
+            new(UnsafeAdd()) T(std::forward<T>(value));
+        }
+
+        void Add(const T& value)
+        {
+            new(UnsafeAdd()) T(value);
+        }
+
+        // Keeps the current storage, like List::Clear
+        void Clear()
+        {
+            if (!m_size) return;
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                for (T& item : *this)
+                {
+                    item.~T();
+                }
+            }
+            m_size = 0;
+        }
+
+        T RemoveAt(const i32 index)
+        {
+            if (static_cast<u32>(index) >= static_cast<u32>(m_size)) throw Exception("Index out of range");
+            m_size--;
+            const auto item = &m_items[index];
+            T value = std::move(*item);
+            if constexpr (!std::is_trivially_destructible_v<T>) item->~T();
+            if (index < m_size)
+            {
+                ListDetails::RelocateItems(item, item + 1, m_size - index);
+            }
+            return value;
+        }
+
+        T* begin() const
+        {
+            return m_items;
+        }
+
+        T* end() const
+        {
+            return m_items + m_size;
+        }
+    };
+}
@@ -0,0 +1,309 @@
+#include "TessCache.h"
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+using namespace Coplt;
+
+namespace
+{
+    // Largest power of two not above the tolerance, meshes are only ever finer than asked
+    f32 BucketTolerance(const f32 tolerance)
+    {
+        if (!(tolerance > 0)) return 0;
+        if (!std::isfinite(tolerance)) return tolerance;
+        i32 exp;
+        std::frexp(tolerance, &exp);
+        return std::ldexp(1.0f, exp - 1);
+    }
+
+    Rc<TessMesh> MeshOf(const Tessellator& tess)
+    {
+        return Rc(new TessMesh(tess.m_vertices, tess.m_indices));
+    }
+
+    Rc<TessMesh> ShareMesh(TessMesh* mesh)
+    {
+        mesh->AddRef();
+        return Rc(mesh);
+    }
+}
+
+TessMesh::TessMesh(const std::span<const PathPoint> vertices, const std::span<const u32> indices)
+    : m_vertex_count(static_cast<u32>(vertices.size())), m_index_count(static_cast<u32>(indices.size()))
+{
+    const auto vertex_bytes = sizeof(PathPoint) * vertices.size();
+    const auto index_bytes = sizeof(u32) * indices.size();
+    m_data = std::make_unique<u8[]>(vertex_bytes + index_bytes);
+    if (vertex_bytes > 0) std::memcpy(m_data.get(), vertices.data(), vertex_bytes);
+    if (index_bytes > 0) std::memcpy(m_data.get() + vertex_bytes, indices.data(), index_bytes);
+}
+
+usize TessMesh::Bytes() const
+{
+    return sizeof(TessMesh) + sizeof(PathPoint) * m_vertex_count + sizeof(u32) * m_index_count;
+}
+
+void TessMesh::Impl_GetData(f32 const** vertices, i32* vertex_count, u32 const** indices, i32* index_count)
+{
+    *vertices = reinterpret_cast<const f32*>(Vertices().data());
+    *vertex_count = static_cast<i32>(m_vertex_count);
+    *indices = Indices().data();
+    *index_count = static_cast<i32>(m_index_count);
+}
+
+TessCache::Key TessCache::Key::Of(const TessFillOptions& options)
+{
+    return Key{
+        .ToLerance = BucketTolerance(options.ToLerance),
+        .Kind = 0,
+        .FillRule = static_cast<u8>(options.FillRule),
+        .SweepOrientation = static_cast<u8>(options.SweepOrientation),
+        .HandleIntersections = static_cast<u8>(options.HandleIntersections),
+    };
+}
+
+TessCache::Key TessCache::Key::Of(const TessStrokeOptions& options)
+{
+    return Key{
+        .ToLerance = BucketTolerance(options.ToLerance),
+        .LineWidth = options.LineWidth,
+        .MiterLimit = options.MiterLimit,
+        .Kind = 1,
+        .StartCap = static_cast<u8>(options.StartCap),
+        .EndCap = static_cast<u8>(options.EndCap),
+        .LineJoin = static_cast<u8>(options.LineJoin),
+    };
+}
+
+u64 TessCache::Key::Hash(const u64 path_hash) const
+{
+    const auto mix = [](u64 hash, const u64 value)
+    {
+        hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+        return hash ^ (hash >> 32);
+    };
+    auto hash = mix(path_hash, std::bit_cast<u32>(ToLerance) | static_cast<u64>(std::bit_cast<u32>(LineWidth)) << 32);
+    hash = mix(hash, std::bit_cast<u32>(MiterLimit) | static_cast<u64>(Kind) << 32 | static_cast<u64>(FillRule) << 40
+        | static_cast<u64>(SweepOrientation) << 48 | static_cast<u64>(HandleIntersections) << 56);
+    return mix(hash, StartCap | static_cast<u64>(EndCap) << 8 | static_cast<u64>(LineJoin) << 16);
+}
+
+usize TessCache::Entry::Bytes() const
+{
+    return sizeof(Entry) + PathData.capacity() + Mesh->Bytes();
+}
+
+bool TessCache::Entry::Matches(const Key& key, const Path& path) const
+{
+    if (Options != key || PointCount != path.m_point_count) return false;
+    const auto data = path.Data();
+    return PathData.size() == data.size()
+        && (data.empty() || std::memcmp(PathData.data(), data.data(), data.size()) == 0);
+}
+
+TessCache::TessCache(Rc<IFrameSource>&& frame_source) : m_frame_source(std::move(frame_source))
+{
+}
+
+u64 TessCache::CurrentFrame() const
+{
+    FrameTime ft{};
+    m_frame_source->Get(&ft);
+    return ft.NthFrame;
+}
+
+Rc<TessMesh> TessCache::Fill(const Path& path, const TessFillOptions& options)
+{
+    const auto key = Key::Of(options);
+    return GetOrAdd(
+        key, path, [&](Tessellator& tess)
+        {
+            auto bucketed = options;
+            bucketed.ToLerance = key.ToLerance;
+            tess.Fill(path, bucketed);
+        }
+    );
+}
+
+Rc<TessMesh> TessCache::Stroke(const Path& path, const TessStrokeOptions& options)
+{
+    const auto key = Key::Of(options);
+    return GetOrAdd(
+        key, path, [&](Tessellator& tess)
+        {
+            auto bucketed = options;
+            bucketed.ToLerance = key.ToLerance;
+            tess.Stroke(path, bucketed);
+        }
+    );
+}
+
+template <class F>
+Rc<TessMesh> TessCache::GetOrAdd(const Key& key, const Path& path, F&& tessellate)
+{
+    const auto hash = key.Hash(path.ContentHash());
+    const auto frame = CurrentFrame();
+    {
+        std::lock_guard lock(m_mutex);
+        const auto r = m_map.TryGet(hash);
+        if (r && r.GetValue()->Matches(key, path))
+        {
+            const auto it = r.GetValue();
+            m_lru.splice(m_lru.begin(), m_lru, it);
+            it->LastFrame = frame;
+            ++m_hits;
+            return ShareMesh(it->Mesh.get());
+        }
+        ++m_misses;
+    }
+
+    // Tessellated outside the lock, two threads missing the same path at once just both do the work
+    static thread_local Tessellator s_tess{};
+    s_tess.Clear();
+    tessellate(s_tess);
+    auto mesh = MeshOf(s_tess);
+
+    std::lock_guard lock(m_mutex);
+    if (m_budget == 0) return mesh;
+    Entry entry{
+        .Hash = hash,
+        .Options = key,
+        .PointCount = path.m_point_count,
+        .PathData = std::vector<u8>(path.Data().begin(), path.Data().end()),
+        .Mesh = ShareMesh(mesh.get()),
+        .LastFrame = frame,
+    };
+    const auto bytes = entry.Bytes();
+    if (bytes > m_budget) return mesh;
+    auto r = m_map.GetValueRefOrUninitializedValue(hash);
+    if (r.Exists())
+    {
+        const auto it = r.GetValue();
+        m_bytes -= it->Bytes();
+        *it = std::move(entry);
+        m_lru.splice(m_lru.begin(), m_lru, it);
+    }
+    else
+    {
+        m_lru.push_front(std::move(entry));
+        r.SetValue(m_lru.begin());
+    }
+    m_bytes += bytes;
+    Evict(frame);
+    return mesh;
+}
+
+void TessCache::PopBack()
+{
+    const auto& entry = m_lru.back();
+    m_bytes -= entry.Bytes();
+    m_map.Remove(entry.Hash);
+    m_lru.pop_back();
+    ++m_evictions;
+}
+
+void TessCache::Evict(const u64 frame)
+{
+    while (m_bytes > m_budget && !m_lru.empty() && m_lru.back().LastFrame < frame) PopBack();
+}
+
+void TessCache::SetBudget(const u64 bytes)
+{
+    std::lock_guard lock(m_mutex);
+    m_budget = bytes;
+    while (m_bytes > m_budget && !m_lru.empty()) PopBack();
+}
+
+void TessCache::SetExpireFrame(const u64 frames)
+{
+    std::lock_guard lock(m_mutex);
+    m_expire_frame = frames;
+}
+
+void TessCache::Collect()
+{
+    const auto frame = CurrentFrame();
+    std::lock_guard lock(m_mutex);
+    while (!m_lru.empty() && (frame - m_lru.back().LastFrame >= m_expire_frame || m_bytes > m_budget)) PopBack();
+}
+
+void TessCache::Clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_map.Clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+TessCacheStats TessCache::Stats()
+{
+    std::lock_guard lock(m_mutex);
+    return TessCacheStats{
+        .Hits = m_hits,
+        .Misses = m_misses,
+        .Evictions = m_evictions,
+        .Bytes = m_bytes,
+        .Entries = static_cast<u32>(m_map.Count()),
+    };
+}
+
+IFrameSource* TessCache::Impl_GetFrameSource()
+{
+    return m_frame_source.get();
+}
+
+void TessCache::Impl_SetExpireFrame(const u64 FrameCount)
+{
+    SetExpireFrame(FrameCount);
+}
+
+void TessCache::Impl_SetBudget(const u64 Bytes)
+{
+    SetBudget(Bytes);
+}
+
+void TessCache::Impl_Collect()
+{
+    Collect();
+}
+
+void TessCache::Impl_Clear()
+{
+    Clear();
+}
+
+void TessCache::Impl_GetStats(u64* hits, u64* misses, u64* evictions, u64* bytes, u32* entries)
+{
+    const auto stats = Stats();
+    *hits = stats.Hits;
+    *misses = stats.Misses;
+    *evictions = stats.Evictions;
+    *bytes = stats.Bytes;
+    *entries = stats.Entries;
+}
+
+HResult TessCache::Impl_Fill(IPath* path, TessFillOptions* options, ITessMesh** mesh)
+{
+    return feb(
+        [&]
+        {
+            if (path == nullptr || options == nullptr || mesh == nullptr) return HResultE::InvalidArg;
+            *mesh = Fill(*static_cast<Path*>(path), *options).leak();
+            return HResultE::Ok;
+        }
+    );
+}
+
+HResult TessCache::Impl_Stroke(IPath* path, TessStrokeOptions* options, ITessMesh** mesh)
+{
+    return feb(
+        [&]
+        {
+            if (path == nullptr || options == nullptr || mesh == nullptr) return HResultE::InvalidArg;
+            *mesh = Stroke(*static_cast<Path*>(path), *options).leak();
+            return HResultE::Ok;
+        }
+    );
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "Com.h"
+#include "FlatMap.h"
+#include "Path.h"
+#include "Tessellator.h"
+
+namespace Coplt
+{
+    // Immutable, vertices then indices in one allocation
+    struct TessMesh final : ComImpl<TessMesh, ITessMesh>
+    {
+        u32 m_vertex_count{};
+        u32 m_index_count{};
+        std::unique_ptr<u8[]> m_data{};
+
+        TessMesh(std::span<const PathPoint> vertices, std::span<const u32> indices);
+
+        std::span<const PathPoint> Vertices() const
+        {
+            return std::span(reinterpret_cast<const PathPoint*>(m_data.get()), m_vertex_count);
+        }
+
+        std::span<const u32> Indices() const
+        {
+            return std::span(
+                reinterpret_cast<const u32*>(m_data.get() + sizeof(PathPoint) * m_vertex_count), m_index_count
+            );
+        }
+
+        usize Bytes() const;
+
+        COPLT_IMPL_START
+
+        COPLT_FORCE_INLINE
+        void Impl_GetData(f32 const** vertices, i32* vertex_count, u32 const** indices, i32* index_count);
+
+        COPLT_IMPL_END
+    };
+
+    struct TessCacheStats
+    {
+        u64 Hits;
+        u64 Misses;
+        u64 Evictions;
+        u64 Bytes;
+        u32 Entries;
+    };
+
+    // Meshes of the shapes drawn again and again at the same scale, shared by every caller asking for the same path
+    // content and options. Tolerances are rounded down to a power of two so that small scale changes still hit.
+    // Entries are stamped with the frame of their last use, like the font faces of a font manager: Collect drops the
+    // ones unused for the expire frame count. Past the byte budget the least recently used entries go first, those
+    // used in the current frame only in Collect so that a frame needing more than the budget does not thrash.
+    // Thread safe, misses are tessellated outside the lock
+    struct TessCache final : ComImpl<TessCache, ITessCache>
+    {
+        static constexpr u64 DefaultBudget = 16 * 1024 * 1024;
+        static constexpr u64 DefaultExpireFrame = 180;
+
+        // The options with the tolerance bucketed, those the kind does not use are 0
+        struct Key
+        {
+            f32 ToLerance;
+            f32 LineWidth;
+            f32 MiterLimit;
+            // 0 fill, 1 stroke
+            u8 Kind;
+            u8 FillRule;
+            u8 SweepOrientation;
+            u8 HandleIntersections;
+            u8 StartCap;
+            u8 EndCap;
+            u8 LineJoin;
+
+            static Key Of(const TessFillOptions& options);
+            static Key Of(const TessStrokeOptions& options);
+
+            u64 Hash(u64 path_hash) const;
+            bool operator==(const Key&) const = default;
+        };
+
+        struct Entry
+        {
+            u64 Hash;
+            Key Options;
+            u32 PointCount;
+            // Of the path, to tell hash collisions apart
+            std::vector<u8> PathData;
+            Rc<TessMesh> Mesh;
+            u64 LastFrame;
+
+            usize Bytes() const;
+            bool Matches(const Key& key, const Path& path) const;
+        };
+
+        Rc<IFrameSource> m_frame_source;
+        std::mutex m_mutex{};
+        // Most recently used first, so also in last frame order
+        std::list<Entry> m_lru{};
+        FlatMap<u64, std::list<Entry>::iterator> m_map{};
+        u64 m_bytes{};
+        u64 m_budget{DefaultBudget};
+        u64 m_expire_frame{DefaultExpireFrame};
+        u64 m_hits{};
+        u64 m_misses{};
+        u64 m_evictions{};
+
+        explicit TessCache(Rc<IFrameSource>&& frame_source);
+
+        Rc<TessMesh> Fill(const Path& path, const TessFillOptions& options);
+        Rc<TessMesh> Stroke(const Path& path, const TessStrokeOptions& options);
+
+        // 0 disables the cache and drops every entry
+        void SetBudget(u64 bytes);
+        void SetExpireFrame(u64 frames);
+        void Collect();
+        void Clear();
+        TessCacheStats Stats();
+
+        COPLT_IMPL_START
+
+        COPLT_FORCE_INLINE
+        IFrameSource* Impl_GetFrameSource();
+
+        COPLT_FORCE_INLINE
+        void Impl_SetExpireFrame(u64 FrameCount);
+
+        COPLT_FORCE_INLINE
+        void Impl_SetBudget(u64 Bytes);
+
+        COPLT_FORCE_INLINE
+        void Impl_Collect();
+
+        COPLT_FORCE_INLINE
+        void Impl_Clear();
+
+        COPLT_FORCE_INLINE
+        void Impl_GetStats(u64* hits, u64* misses, u64* evictions, u64* bytes, u32* entries);
+
+        COPLT_FORCE_INLINE
+        HResult Impl_Fill(IPath* path, TessFillOptions* options, ITessMesh** mesh);
+
+        COPLT_FORCE_INLINE
+        HResult Impl_Stroke(IPath* path, TessStrokeOptions* options, ITessMesh** mesh);
+
+        COPLT_IMPL_END
+
+    private:
+        u64 CurrentFrame() const;
+
+        template <class F>
+        Rc<TessMesh> GetOrAdd(const Key& key, const Path& path, F&& tessellate);
+
+        // Least recently used first while over the budget, sparing those used in or after frame
+        void Evict(u64 frame);
+        void PopBack();
+    };
+} // namespace Coplt
@@ -0,0 +1,654 @@
+#include "Tessellator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+using namespace Coplt;
+
+namespace
+{
+    // Below this the segment counts explode for nothing visible
+    constexpr f32 MinTolerance = 1e-3f;
+    constexpr u32 MaxFlattenSegments = 1024;
+    constexpr u32 MaxFanSegments = 256;
+    // Small batches are not worth waking up the pool
+    constexpr i32 MinParallelShapes = 64;
+
+    f32 ClampTolerance(const f32 tolerance)
+    {
+        // Written so that nan also takes the min
+        return tolerance >= MinTolerance ? tolerance : MinTolerance;
+    }
+
+    u32 SegmentCount(const f32 squared)
+    {
+        if (!(squared > 1)) return 1;
+        if (!(squared < static_cast<f32>(MaxFlattenSegments * MaxFlattenSegments))) return MaxFlattenSegments;
+        return static_cast<u32>(std::ceil(std::sqrt(squared)));
+    }
+
+    COPLT_FORCE_INLINE PathPoint Add(const PathPoint a, const PathPoint b) { return {a.X + b.X, a.Y + b.Y}; }
+    COPLT_FORCE_INLINE PathPoint Sub(const PathPoint a, const PathPoint b) { return {a.X - b.X, a.Y - b.Y}; }
+    COPLT_FORCE_INLINE PathPoint Mul(const PathPoint a, const f32 s) { return {a.X * s, a.Y * s}; }
+    COPLT_FORCE_INLINE f32 Dot(const PathPoint a, const PathPoint b) { return a.X * b.X + a.Y * b.Y; }
+    COPLT_FORCE_INLINE f32 Cross(const PathPoint a, const PathPoint b) { return a.X * b.Y - a.Y * b.X; }
+    COPLT_FORCE_INLINE f32 Length(const PathPoint a) { return std::sqrt(Dot(a, a)); }
+
+    COPLT_FORCE_INLINE bool SamePoint(const PathPoint a, const PathPoint b)
+    {
+        return a.X == b.X && a.Y == b.Y;
+    }
+
+    // The ends are exact so that edges meeting at a point agree on it
+    COPLT_FORCE_INLINE f32 XAt(const Tessellator::Edge& edge, const f32 y)
+    {
+        if (y <= edge.Top.Y) return edge.Top.X;
+        if (y >= edge.Bottom.Y) return edge.Bottom.X;
+        return edge.Top.X + (y - edge.Top.Y) * edge.DxDy;
+    }
+}
+
+void Tessellator::Clear()
+{
+    m_vertices.clear();
+    m_indices.clear();
+}
+
+void Tessellator::Flatten(const Path& path, const f32 tolerance)
+{
+    m_points.clear();
+    m_sub_paths.clear();
+
+    const auto points = path.Points();
+    u32 p = 0;
+    PathPoint current{};
+    bool open = false;
+    // A lone MoveTo draws nothing, not even caps
+    bool drawn = false;
+
+    const auto end = [&]
+    {
+        if (open && !drawn)
+        {
+            m_points.resize(m_sub_paths.back().Start);
+            m_sub_paths.pop_back();
+        }
+        open = false;
+    };
+    const auto begin = [&](const PathPoint point)
+    {
+        end();
+        m_sub_paths.push_back({static_cast<u32>(m_points.size()), 1, false});
+        m_points.push_back(point);
+        open = true;
+        drawn = false;
+    };
+    const auto push = [&](const PathPoint point)
+    {
+        drawn = true;
+        if (SamePoint(point, m_points.back())) return;
+        m_points.push_back(point);
+        ++m_sub_paths.back().Count;
+    };
+
+    for (const auto verb : path.Verbs())
+    {
+        switch (verb)
+        {
+        case PathVerb::MoveTo:
+            current = points[p++];
+            begin(current);
+            break;
+        case PathVerb::LineTo:
+            if (!open) begin(current);
+            current = points[p++];
+            push(current);
+            break;
+        case PathVerb::QuadTo:
+        {
+            if (!open) begin(current);
+            const auto p0 = current, p1 = points[p], p2 = points[p + 1];
+            p += 2;
+            // The chord error of a step h is |p0 - 2 p1 + p2| h^2 / 4
+            const auto dd = Length(Add(Sub(p0, Mul(p1, 2)), p2));
+            const auto n = SegmentCount(dd / (4 * tolerance));
+            const auto step = 1.0f / static_cast<f32>(n);
+            for (u32 i = 1; i < n; ++i)
+            {
+                const auto t = static_cast<f32>(i) * step, mt = 1 - t;
+                const auto a = mt * mt, b = 2 * mt * t, c = t * t;
+                push({a * p0.X + b * p1.X + c * p2.X, a * p0.Y + b * p1.Y + c * p2.Y});
+            }
+            push(p2);
+            current = p2;
+            break;
+        }
+        case PathVerb::CubicTo:
+        {
+            if (!open) begin(current);
+            const auto p0 = current, p1 = points[p], p2 = points[p + 1], p3 = points[p + 2];
+            p += 3;
+            // The second derivative is at most 6 times the larger second difference, the chord error of a step h
+            // is at most 3 M h^2 / 4
+            const auto dd = std::max(
+                Length(Add(Sub(p0, Mul(p1, 2)), p2)), Length(Add(Sub(p1, Mul(p2, 2)), p3))
+            );
+            const auto n = SegmentCount(3 * dd / (4 * tolerance));
+            const auto step = 1.0f / static_cast<f32>(n);
+            for (u32 i = 1; i < n; ++i)
+            {
+                const auto t = static_cast<f32>(i) * step, mt = 1 - t;
+                const auto a = mt * mt * mt, b = 3 * mt * mt * t, c = 3 * mt * t * t, d = t * t * t;
+                push({
+                    a * p0.X + b * p1.X + c * p2.X + d * p3.X,
+                    a * p0.Y + b * p1.Y + c * p2.Y + d * p3.Y
+                });
+            }
+            push(p3);
+            current = p3;
+            break;
+        }
+        case PathVerb::Close:
+            if (!open) break;
+            drawn = true;
+            m_sub_paths.back().Closed = true;
+            current = m_points[m_sub_paths.back().Start];
+            end();
+            break;
+        }
+    }
+    end();
+}
+
+void Tessellator::Fill(const Path& path, const TessFillOptions& options)
+{
+    Flatten(path, ClampTolerance(options.ToLerance));
+    // Sweeping along x is sweeping along y with the axes swapped
+    const auto swap = options.SweepOrientation == Orientation::Horizontal;
+    if (swap) for (auto& point : m_points) std::swap(point.X, point.Y);
+    const auto first_vertex = m_vertices.size();
+    FillEdges(options);
+    if (swap)
+    {
+        for (auto i = first_vertex; i < m_vertices.size(); ++i)
+            std::swap(m_vertices[i].X, m_vertices[i].Y);
+    }
+}
+
+void Tessellator::FillEdges(const TessFillOptions& options)
+{
+    m_edges.clear();
+    m_ys.clear();
+    for (const auto& sub_path : m_sub_paths)
+    {
+        // Fewer points enclose nothing
+        if (sub_path.Count < 3) continue;
+        for (u32 i = 0; i < sub_path.Count; ++i)
+        {
+            const auto a = m_points[sub_path.Start + i];
+            const auto b = m_points[sub_path.Start + (i + 1) % sub_path.Count];
+            if (a.Y == b.Y || !std::isfinite(a.X + a.Y + b.X + b.Y)) continue;
+            Edge edge{};
+            if (a.Y < b.Y)
+            {
+                edge.Top = a;
+                edge.Bottom = b;
+                edge.Winding = 1;
+            }
+            else
+            {
+                edge.Top = b;
+                edge.Bottom = a;
+                edge.Winding = -1;
+            }
+            edge.DxDy = (edge.Bottom.X - edge.Top.X) / (edge.Bottom.Y - edge.Top.Y);
+            edge.CachedY = ~0u;
+            m_edges.push_back(edge);
+            m_ys.push_back(edge.Top.Y);
+            m_ys.push_back(edge.Bottom.Y);
+        }
+    }
+    if (m_edges.empty()) return;
+
+    m_edge_order.resize(m_edges.size());
+    for (u32 i = 0; i < m_edge_order.size(); ++i) m_edge_order[i] = i;
+    std::ranges::sort(m_edge_order, [&](const u32 a, const u32 b) { return m_edges[a].Top.Y < m_edges[b].Top.Y; });
+
+    // Without crossings inside a slab the edges keep their order across it
+    if (options.HandleIntersections) FindCrossings();
+    std::ranges::sort(m_ys);
+    m_ys.erase(std::ranges::unique(m_ys).begin(), m_ys.end());
+
+    const auto even_odd = options.FillRule == FillRule::EvenOdd;
+    const auto inside = [&](const i32 winding) { return even_odd ? (winding & 1) != 0 : winding != 0; };
+    const auto emit = [&](const Span& span, const u32 bottom)
+    {
+        auto& left = m_edges[span.Left];
+        auto& right = m_edges[span.Right];
+        const auto tl = EdgeVertex(left, span.Top), tr = EdgeVertex(right, span.Top);
+        const auto bl = EdgeVertex(left, bottom), br = EdgeVertex(right, bottom);
+        // Either end may have narrowed to a point
+        if (m_vertices[tl].X < m_vertices[tr].X) AddTriangle(tl, tr, br);
+        if (m_vertices[bl].X < m_vertices[br].X) AddTriangle(tl, br, bl);
+    };
+
+    m_active.clear();
+    m_spans.clear();
+    usize next = 0;
+    for (u32 k = 0; k + 1 < m_ys.size(); ++k)
+    {
+        const auto y0 = m_ys[k], mid = (y0 + m_ys[k + 1]) * 0.5f;
+        std::erase_if(m_active, [&](const u32 e) { return m_edges[e].Bottom.Y <= y0; });
+        for (; next < m_edge_order.size() && m_edges[m_edge_order[next]].Top.Y <= y0; ++next)
+            m_active.push_back(m_edge_order[next]);
+
+        for (const auto e : m_active)
+        {
+            auto& edge = m_edges[e];
+            edge.SortX = edge.Top.X + (mid - edge.Top.Y) * edge.DxDy;
+        }
+        // Insertion sort, the order barely changes from one slab to the next
+        for (usize i = 1; i < m_active.size(); ++i)
+        {
+            const auto e = m_active[i];
+            const auto x = m_edges[e].SortX;
+            auto j = i;
+            for (; j > 0 && m_edges[m_active[j - 1]].SortX > x; --j) m_active[j] = m_active[j - 1];
+            m_active[j] = e;
+        }
+
+        m_next_spans.clear();
+        i32 winding = 0;
+        u32 left = 0;
+        for (const auto e : m_active)
+        {
+            const auto was_inside = inside(winding);
+            winding += m_edges[e].Winding;
+            const auto now_inside = inside(winding);
+            if (!was_inside && now_inside) left = e;
+            else if (was_inside && !now_inside) m_next_spans.push_back({left, e, k});
+        }
+
+        // Spans with the same edges as one of the previous slab continue it, both lists are in x order so the
+        // matches come in order too, the previous spans left behind end here
+        usize j = 0;
+        for (auto& span : m_next_spans)
+        {
+            for (auto t = j; t < m_spans.size(); ++t)
+            {
+                if (m_spans[t].Left != span.Left || m_spans[t].Right != span.Right) continue;
+                for (; j < t; ++j) emit(m_spans[j], k);
+                span.Top = m_spans[t].Top;
+                j = t + 1;
+                break;
+            }
+        }
+        for (; j < m_spans.size(); ++j) emit(m_spans[j], k);
+        std::swap(m_spans, m_next_spans);
+    }
+    const auto last = static_cast<u32>(m_ys.size() - 1);
+    for (const auto& span : m_spans) emit(span, last);
+}
+
+void Tessellator::FindCrossings()
+{
+    // Every edge against the ones still open at its top
+    m_active.clear();
+    for (const auto e : m_edge_order)
+    {
+        const auto& edge = m_edges[e];
+        std::erase_if(m_active, [&](const u32 a) { return m_edges[a].Bottom.Y <= edge.Top.Y; });
+        for (const auto a : m_active)
+        {
+            const auto& other = m_edges[a];
+            const auto y0 = edge.Top.Y, y1 = std::min(edge.Bottom.Y, other.Bottom.Y);
+            const auto d0 = XAt(edge, y0) - XAt(other, y0), d1 = XAt(edge, y1) - XAt(other, y1);
+            if ((d0 < 0 && d1 > 0) || (d0 > 0 && d1 < 0))
+                m_ys.push_back(y0 + (y1 - y0) * (d0 / (d0 - d1)));
+        }
+        m_active.push_back(e);
+    }
+}
+
+u32 Tessellator::EdgeVertex(Edge& edge, const u32 y)
+{
+    if (edge.CachedY == y) return edge.CachedVertex;
+    const auto at = m_ys[y];
+    edge.CachedY = y;
+    edge.CachedVertex = AddVertex({XAt(edge, at), at});
+    return edge.CachedVertex;
+}
+
+void Tessellator::Stroke(const Path& path, const TessStrokeOptions& options)
+{
+    const auto half = options.LineWidth * 0.5f;
+    if (!(half > 0) || !std::isfinite(half)) return;
+    const auto tolerance = ClampTolerance(options.ToLerance);
+    Flatten(path, tolerance);
+    for (const auto& sub_path : m_sub_paths) StrokeSubPath(sub_path, options, tolerance);
+}
+
+void Tessellator::StrokeSubPath(const SubPath& sub_path, const TessStrokeOptions& options, const f32 tolerance)
+{
+    const auto half = options.LineWidth * 0.5f;
+    const auto* points = m_points.data() + sub_path.Start;
+    auto count = sub_path.Count;
+    auto closed = sub_path.Closed;
+    if (closed && count > 1 && SamePoint(points[count - 1], points[0])) --count;
+
+    if (count == 1)
+    {
+        // A zero length sub path only shows its caps
+        const auto cap = options.StartCap != LineCap::Butt ? options.StartCap : options.EndCap;
+        const auto p = points[0];
+        if (cap == LineCap::Square)
+        {
+            const auto a = AddVertex({p.X - half, p.Y - half}), b = AddVertex({p.X + half, p.Y - half});
+            const auto c = AddVertex({p.X + half, p.Y + half}), d = AddVertex({p.X - half, p.Y + half});
+            AddTriangle(a, b, c);
+            AddTriangle(a, c, d);
+        }
+        else if (cap == LineCap::Round)
+        {
+            const auto center = AddVertex(p);
+            const auto from = AddVertex({p.X + half, p.Y});
+            Fan(p, center, from, from, 2 * std::numbers::pi_v<f32>, half, tolerance);
+        }
+        return;
+    }
+
+    const auto join = [&](
+        const PathPoint at, const PathPoint d0, const PathPoint d1, const u32 end_left, const u32 end_right,
+        const u32 start_left, const u32 start_right
+    )
+    {
+        const auto cross = Cross(d0, d1), dot = Dot(d0, d1);
+        if (std::fabs(cross) < 1e-6f && dot > 0) return;
+        // Turning towards the left normal puts the gap on the right
+        const auto outer_right = cross > 0;
+        const auto from = outer_right ? end_right : end_left;
+        const auto to = outer_right ? start_right : start_left;
+        const auto center = AddVertex(at);
+        switch (options.LineJoin)
+        {
+        case LineJoin::Round:
+        {
+            const auto angle = std::atan2(std::fabs(cross), dot);
+            Fan(at, center, from, to, outer_right ? angle : -angle, half, tolerance);
+            return;
+        }
+        case LineJoin::Miter:
+        case LineJoin::MiterClip:
+        {
+            const auto s = outer_right ? -half : half;
+            const PathPoint o0{-d0.Y * s, d0.X * s}, o1{-d1.Y * s, d1.X * s};
+            const auto limit = std::max(options.MiterLimit, 1.0f);
+            // 1 + cos of the turn, the miter is sqrt(2 / denom) times half the width
+            const auto denom = 1 + dot;
+            if (denom > 1e-6f && 2 / denom <= limit * limit)
+            {
+                const auto miter = AddVertex(Add(at, Mul(Add(o0, o1), 1 / denom)));
+                AddTriangle(center, from, miter);
+                AddTriangle(center, miter, to);
+                return;
+            }
+            if (options.LineJoin == LineJoin::Miter) break;
+            // Cut the miter at limit times half the width from the point, across the bisector
+            const auto bisector = denom > 1e-6f ? Mul(Add(o0, o1), 1 / (half * std::sqrt(2 * denom))) : d0;
+            const auto reach = limit * half - Dot(o0, bisector);
+            const auto ahead = Dot(d0, bisector);
+            if (reach <= 0 || ahead <= 0) break;
+            const auto t = reach / ahead;
+            const auto c0 = AddVertex(Add(Add(at, o0), Mul(d0, t)));
+            const auto c1 = AddVertex(Sub(Add(at, o1), Mul(d1, t)));
+            AddTriangle(center, from, c0);
+            AddTriangle(center, c0, c1);
+            AddTriangle(center, c1, to);
+            return;
+        }
+        case LineJoin::Bevel:
+            break;
+        }
+        AddTriangle(center, from, to);
+    };
+
+    const auto segments = closed ? count : count - 1;
+    u32 first_left = 0, first_right = 0, end_left = 0, end_right = 0;
+    PathPoint first_dir{}, prev_dir{};
+    for (u32 i = 0; i < segments; ++i)
+    {
+        auto a = points[i], b = points[(i + 1) % count];
+        const auto d = Mul(Sub(b, a), 1 / Length(Sub(b, a)));
+        const PathPoint n{-d.Y * half, d.X * half};
+        if (!closed && i == 0 && options.StartCap == LineCap::Square) a = Sub(a, Mul(d, half));
+        if (!closed && i == segments - 1 && options.EndCap == LineCap::Square) b = Add(b, Mul(d, half));
+        const auto sl = AddVertex(Add(a, n)), sr = AddVertex(Sub(a, n));
+        const auto er = AddVertex(Sub(b, n)), el = AddVertex(Add(b, n));
+        AddTriangle(sl, sr, er);
+        AddTriangle(sl, er, el);
+        if (i == 0)
+        {
+            first_left = sl;
+            first_right = sr;
+            first_dir = d;
+        }
+        else join(points[i], prev_dir, d, end_left, end_right, sl, sr);
+        end_left = el;
+        end_right = er;
+        prev_dir = d;
+    }
+
+    if (closed)
+    {
+        join(points[0], prev_dir, first_dir, end_left, end_right, first_left, first_right);
+        return;
+    }
+    // Half turns through the back and the front of the ends
+    if (options.StartCap == LineCap::Round)
+        Fan(points[0], AddVertex(points[0]), first_right, first_left, -std::numbers::pi_v<f32>, half, tolerance);
+    if (options.EndCap == LineCap::Round)
+    {
+        const auto end = points[count - 1];
+        Fan(end, AddVertex(end), end_left, end_right, -std::numbers::pi_v<f32>, half, tolerance);
+    }
+}
+
+void Tessellator::Fan(
+    const PathPoint center, const u32 center_vertex, const u32 from, const u32 to, const f32 sweep, const f32 radius,
+    const f32 tolerance
+)
+{
+    // The chord of a step a is off the circle by radius (1 - cos(a / 2)), a quarter turn at most
+    const auto max_step = std::min(
+        2 * std::acos(std::max(1 - tolerance / radius, -1.0f)), std::numbers::pi_v<f32> / 2
+    );
+    const auto steps = std::clamp(
+        static_cast<u32>(std::ceil(std::fabs(sweep) / max_step)), 1u, MaxFanSegments
+    );
+    const auto step = sweep / static_cast<f32>(steps);
+    const auto cos_s = std::cos(step), sin_s = std::sin(step);
+    auto v = Sub(m_vertices[from], center);
+    auto prev = from;
+    for (u32 i = 1; i < steps; ++i)
+    {
+        v = {v.X * cos_s - v.Y * sin_s, v.X * sin_s + v.Y * cos_s};
+        const auto next = AddVertex(Add(center, v));
+        AddTriangle(center_vertex, prev, next);
+        prev = next;
+    }
+    AddTriangle(center_vertex, prev, to);
+}
+
+template <class F>
+void Tessellator::Batch(
+    const i32 count, ThreadPool* pool, u32* vertex_offsets, u32* index_offsets, F&& tessellate
+)
+{
+    if (pool == nullptr || count < MinParallelShapes || pool->Concurrency() < 2)
+    {
+        for (i32 i = 0; i < count; ++i)
+        {
+            vertex_offsets[i] = static_cast<u32>(m_vertices.size());
+            index_offsets[i] = static_cast<u32>(m_indices.size());
+            tessellate(*this, i);
+        }
+        vertex_offsets[count] = static_cast<u32>(m_vertices.size());
+        index_offsets[count] = static_cast<u32>(m_indices.size());
+        return;
+    }
+
+    const auto workers = static_cast<usize>(std::min(count, pool->Concurrency()));
+    while (m_workers.size() < workers) m_workers.push_back(Rc(new Tessellator()));
+    for (usize w = 0; w < workers; ++w) m_workers[w]->Clear();
+    m_batch_shapes.resize(count);
+    pool->ParallelForWorkers(
+        count, [&](const i32 worker, const i32 i)
+        {
+            auto& tess = *m_workers[worker].get();
+            const auto vertex_start = static_cast<u32>(tess.m_vertices.size());
+            const auto index_start = static_cast<u32>(tess.m_indices.size());
+            tessellate(tess, i);
+            m_batch_shapes[i] = BatchShape{
+                .Worker = static_cast<u32>(worker),
+                .VertexStart = vertex_start,
+                .VertexCount = static_cast<u32>(tess.m_vertices.size()) - vertex_start,
+                .IndexStart = index_start,
+                .IndexCount = static_cast<u32>(tess.m_indices.size()) - index_start,
+            };
+        }
+    );
+
+    // Laid out in shape order, which worker took a shape does not show in the result
+    auto vertex_offset = static_cast<u32>(m_vertices.size());
+    auto index_offset = static_cast<u32>(m_indices.size());
+    for (i32 i = 0; i < count; ++i)
+    {
+        vertex_offsets[i] = vertex_offset;
+        index_offsets[i] = index_offset;
+        vertex_offset += m_batch_shapes[i].VertexCount;
+        index_offset += m_batch_shapes[i].IndexCount;
+    }
+    vertex_offsets[count] = vertex_offset;
+    index_offsets[count] = index_offset;
+    m_vertices.resize(vertex_offset);
+    m_indices.resize(index_offset);
+    pool->ParallelForWorkers(
+        count, [&](i32, const i32 i)
+        {
+            const auto& shape = m_batch_shapes[i];
+            const auto& tess = *m_workers[shape.Worker].get();
+            if (shape.VertexCount > 0)
+                std::memcpy(
+                    m_vertices.data() + vertex_offsets[i], tess.m_vertices.data() + shape.VertexStart,
+                    sizeof(PathPoint) * shape.VertexCount
+                );
+            const auto src = tess.m_indices.data() + shape.IndexStart;
+            const auto dst = m_indices.data() + index_offsets[i];
+            const auto rebase = vertex_offsets[i] - shape.VertexStart;
+            for (u32 k = 0; k < shape.IndexCount; ++k) dst[k] = src[k] + rebase;
+        }
+    );
+}
+
+void Tessellator::FillBatch(
+    const IPath* const* paths, const TessFillOptions* options, const i32 count, ThreadPool* pool,
+    u32* vertex_offsets, u32* index_offsets
+)
+{
+    Batch(
+        count, pool, vertex_offsets, index_offsets, [&](Tessellator& tess, const i32 i)
+        {
+            tess.Fill(*static_cast<const Path*>(paths[i]), options[i]);
+        }
+    );
+}
+
+void Tessellator::StrokeBatch(
+    const IPath* const* paths, const TessStrokeOptions* options, const i32 count, ThreadPool* pool,
+    u32* vertex_offsets, u32* index_offsets
+)
+{
+    Batch(
+        count, pool, vertex_offsets, index_offsets, [&](Tessellator& tess, const i32 i)
+        {
+            tess.Stroke(*static_cast<const Path*>(paths[i]), options[i]);
+        }
+    );
+}
+
+HResult Tessellator::Impl_Fill(IPath* path, TessFillOptions* options)
+{
+    return feb(
+        [&]
+        {
+            if (path == nullptr || options == nullptr) return HResultE::InvalidArg;
+            Fill(*static_cast<Path*>(path), *options);
+            return HResultE::Ok;
+        }
+    );
+}
+
+HResult Tessellator::Impl_Stroke(IPath* path, TessStrokeOptions* options)
+{
+    return feb(
+        [&]
+        {
+            if (path == nullptr || options == nullptr) return HResultE::InvalidArg;
+            Stroke(*static_cast<Path*>(path), *options);
+            return HResultE::Ok;
+        }
+    );
+}
+
+void Tessellator::Impl_Clear()
+{
+    Clear();
+}
+
+void Tessellator::Impl_GetMesh(f32** vertices, i32* vertex_count, u32** indices, i32* index_count)
+{
+    *vertices = reinterpret_cast<f32*>(m_vertices.data());
+    *vertex_count = static_cast<i32>(m_vertices.size());
+    *indices = m_indices.data();
+    *index_count = static_cast<i32>(m_indices.size());
+}
+
+HResult Tessellator::Impl_FillBatch(
+    IPath* const* paths, TessFillOptions const* options, const i32 count, u32* vertex_offsets, u32* index_offsets,
+    const bool parallel
+)
+{
+    return feb(
+        [&]
+        {
+            if (count < 0 || vertex_offsets == nullptr || index_offsets == nullptr) return HResultE::InvalidArg;
+            if (count > 0 && (paths == nullptr || options == nullptr)) return HResultE::InvalidArg;
+            if (std::find(paths, paths + count, nullptr) != paths + count) return HResultE::InvalidArg;
+            FillBatch(
+                paths, options, count, parallel ? &ThreadPool::Shared() : nullptr, vertex_offsets, index_offsets
+            );
+            return HResultE::Ok;
+        }
+    );
+}
+
+HResult Tessellator::Impl_StrokeBatch(
+    IPath* const* paths, TessStrokeOptions const* options, const i32 count, u32* vertex_offsets, u32* index_offsets,
+    const bool parallel
+)
+{
+    return feb(
+        [&]
+        {
+            if (count < 0 || vertex_offsets == nullptr || index_offsets == nullptr) return HResultE::InvalidArg;
+            if (count > 0 && (paths == nullptr || options == nullptr)) return HResultE::InvalidArg;
+            if (std::find(paths, paths + count, nullptr) != paths + count) return HResultE::InvalidArg;
+            StrokeBatch(
+                paths, options, count, parallel ? &ThreadPool::Shared() : nullptr, vertex_offsets, index_offsets
+            );
+            return HResultE::Ok;
+        }
+    );
+}
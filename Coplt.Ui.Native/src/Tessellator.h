@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+
+#include "Com.h"
+#include "Path.h"
+#include "ThreadPool.h"
+
+namespace Coplt
+{
+    // Fill and Stroke append indexed triangles to one mesh that is kept until Clear, so several paths can go into a
+    // single draw. Curves are flattened to within the tolerance first. The mesh and the scratch buffers keep their
+    // capacity across calls
+    struct Tessellator final : ComImpl<Tessellator, ITessellator>
+    {
+        struct SubPath
+        {
+            u32 Start;
+            u32 Count;
+            bool Closed;
+        };
+
+        // Top has the smaller y, horizontal edges are dropped
+        struct Edge
+        {
+            PathPoint Top;
+            PathPoint Bottom;
+            f32 DxDy;
+            // +1 going down, -1 going up
+            i32 Winding;
+            // X in the middle of the current slab
+            f32 SortX;
+            // The last vertex made on this edge, neighbouring trapezoids share it
+            u32 CachedY;
+            u32 CachedVertex;
+        };
+
+        // A run of inside between two edges, from the slab boundary Top down
+        struct Span
+        {
+            u32 Left;
+            u32 Right;
+            u32 Top;
+        };
+
+        // Where a shape of a parallel batch landed in the mesh of its worker
+        struct BatchShape
+        {
+            u32 Worker;
+            u32 VertexStart;
+            u32 VertexCount;
+            u32 IndexStart;
+            u32 IndexCount;
+        };
+
+        std::vector<PathPoint> m_vertices{};
+        std::vector<u32> m_indices{};
+
+        std::vector<PathPoint> m_points{};
+        std::vector<SubPath> m_sub_paths{};
+        std::vector<Edge> m_edges{};
+        std::vector<u32> m_edge_order{};
+        std::vector<f32> m_ys{};
+        std::vector<u32> m_active{};
+        std::vector<Span> m_spans{};
+        std::vector<Span> m_next_spans{};
+
+        // One per pool thread, their meshes keep their capacity across batches
+        std::vector<Rc<Tessellator>> m_workers{};
+        std::vector<BatchShape> m_batch_shapes{};
+
+        void Clear();
+        // Trapezoids between the sorted edge end and crossing ys, adjacent ones with the same edges are merged
+        void Fill(const Path& path, const TessFillOptions& options);
+        // A quad per segment plus joins on the outer side of turns and caps on open sub paths
+        void Stroke(const Path& path, const TessStrokeOptions& options);
+
+        // Appends the shapes in order as one Fill or Stroke each would, the mesh does not depend on the thread count.
+        // Shapes are claimed one at a time by the pool threads, each into the mesh of its worker, then copied into
+        // place with rebased indices. The offsets get count + 1 entries, shape i is [offsets[i], offsets[i + 1]).
+        // Serial when pool is null
+        void FillBatch(
+            const IPath* const* paths, const TessFillOptions* options, i32 count, ThreadPool* pool,
+            u32* vertex_offsets, u32* index_offsets
+        );
+        void StrokeBatch(
+            const IPath* const* paths, const TessStrokeOptions* options, i32 count, ThreadPool* pool,
+            u32* vertex_offsets, u32* index_offsets
+        );
+
+        COPLT_IMPL_START
+
+        COPLT_FORCE_INLINE
+        HResult Impl_Fill(IPath* path, TessFillOptions* options);
+
+        COPLT_FORCE_INLINE
+        HResult Impl_Stroke(IPath* path, TessStrokeOptions* options);
+
+        COPLT_FORCE_INLINE
+        void Impl_Clear();
+
+        COPLT_FORCE_INLINE
+        void Impl_GetMesh(f32** vertices, i32* vertex_count, u32** indices, i32* index_count);
+
+        COPLT_FORCE_INLINE
+        HResult Impl_FillBatch(
+            IPath* const* paths, TessFillOptions const* options, i32 count, u32* vertex_offsets, u32* index_offsets,
+            bool parallel
+        );
+
+        COPLT_FORCE_INLINE
+        HResult Impl_StrokeBatch(
+            IPath* const* paths, TessStrokeOptions const* options, i32 count, u32* vertex_offsets, u32* index_offsets,
+            bool parallel
+        );
+
+        COPLT_IMPL_END
+
+    private:
+        template <class F>
+        void Batch(i32 count, ThreadPool* pool, u32* vertex_offsets, u32* index_offsets, F&& tessellate);
+
+        // Into m_points and m_sub_paths, consecutive duplicate points are dropped
+        void Flatten(const Path& path, f32 tolerance);
+
+        void FillEdges(const TessFillOptions& options);
+        void FindCrossings();
+        u32 EdgeVertex(Edge& edge, u32 y);
+
+        void StrokeSubPath(const SubPath& sub_path, const TessStrokeOptions& options, f32 tolerance);
+        // Triangle fan around center from the vertex from to the vertex to, turning by sweep
+        void Fan(PathPoint center, u32 center_vertex, u32 from, u32 to, f32 sweep, f32 radius, f32 tolerance);
+
+        COPLT_FORCE_INLINE u32 AddVertex(const PathPoint point)
+        {
+            m_vertices.push_back(point);
+            return static_cast<u32>(m_vertices.size() - 1);
+        }
+
+        COPLT_FORCE_INLINE void AddTriangle(const u32 a, const u32 b, const u32 c)
+        {
+            m_indices.push_back(a);
+            m_indices.push_back(b);
+            m_indices.push_back(c);
+        }
+    };
+} // namespace Coplt
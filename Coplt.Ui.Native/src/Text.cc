@@ -1,111 +1,332 @@
 #include "Text.h"
 
+#include <atomic>
+#include <bit>
 #include <format>
+#include <mutex>
+#include <vector>
 
-#include <icu.h>
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#define COPLT_TEXT_SSE2
+#endif
+
+#include "Icu.h"
+#include "ThreadPool.h"
 
 using namespace Coplt;
 
 namespace Coplt::UnicodeUtils
 {
-    extern "C" usize coplt_ui_unicode_utils_script_to_locale(
-        u32 script,
-        Func<usize, u32> create
-    );
-
-    char16 const* LikelyLocale(const UScriptCode script)
+    namespace
     {
-        return reinterpret_cast<char16 const*>(coplt_ui_unicode_utils_script_to_locale(
-            static_cast<u32>(script), [](u32 sc)
+        // Larger than the ~200 scripts icu knows about, out of range codes fall back to USCRIPT_UNKNOWN
+        constexpr i32 ScriptTableSize = 256;
+        // lang (< 16) + '_' + country (< 16) + '\0'
+        constexpr usize MaxLocaleLength = 34;
+
+        // Every lookup after the first for a script is a single acquire load,
+        // misses are serialized by a mutex and publish the entry once it is fully written
+        struct LikelyLocaleTable
+        {
+            std::atomic<u16 const*> m_published[ScriptTableSize]{};
+            u16 m_locales[ScriptTableSize][MaxLocaleLength]{};
+            std::mutex m_mutex{};
+        };
+
+        LikelyLocaleTable s_likely_locales{};
+
+        void ComputeLikelyLocale(const UScriptCode script, u16* locale)
+        {
+            const auto src = std::format("und_{}", uscript_getShortName(script));
+            char dst[64];
+            UErrorCode e{};
+            uloc_addLikelySubtags(src.data(), dst, std::size(dst), &e);
+            if (e > 0) [[unlikely]]
+                throw Exception(std::format("LikelyLocale failed: {}", u_errorName(e)));
+
+            char lang[16];
+            const auto lang_len = uloc_getLanguage(dst, lang, std::size(lang), &e);
+            if (e > 0) [[unlikely]]
+                throw Exception(std::format("LikelyLocale failed: {}", u_errorName(e)));
+
+            char country[16];
+            const auto country_len = uloc_getCountry(dst, country, std::size(country), &e);
+            if (e > 0) [[unlikely]]
+                throw Exception(std::format("LikelyLocale failed: {}", u_errorName(e)));
+
+            locale[lang_len + country_len + 1] = 0;
+            locale[lang_len] = '_';
+            for (auto i = 0; i < lang_len; ++i)
             {
-                const auto script = static_cast<UScriptCode>(sc);
-                const auto src = std::format("und_{}", uscript_getShortName(script));
-                char dst[64];
-                UErrorCode e{};
-                uloc_addLikelySubtags(src.data(), dst, std::size(dst), &e);
-                if (e > 0) [[unlikely]]
-                    throw Exception(std::format("LikelyLocale failed: {}", u_errorName(e)));
-
-                char lang[16];
-                const auto lang_len = uloc_getLanguage(dst, lang, std::size(lang), &e);
-                if (e > 0) [[unlikely]]
-                    throw Exception(std::format("LikelyLocale failed: {}", u_errorName(e)));
-
-                char country[16];
-                const auto country_len = uloc_getCountry(dst, country, std::size(country), &e);
-                if (e > 0) [[unlikely]]
-                    throw Exception(std::format("LikelyLocale failed: {}", u_errorName(e)));
-
-                // ReSharper disable once CppDFAMemoryLeak
-                const auto locale = new u16[lang_len + country_len + 2];
-                locale[lang_len + country_len + 1] = 0;
-                locale[lang_len] = '_';
-                for (auto i = 0u; i < lang_len; ++i)
-                {
-                    locale[i] = lang[i];
-                }
-                for (auto i = 0; i < country_len; ++i)
-                {
-                    locale[lang_len + 1 + i] = country[i];
-                }
-                return reinterpret_cast<usize>(locale);
+                locale[i] = lang[i];
             }
-        ));
+            for (auto i = 0; i < country_len; ++i)
+            {
+                locale[lang_len + 1 + i] = country[i];
+            }
+        }
+
+        COPLT_NO_INLINE
+        u16 const* LikelyLocaleSlow(const UScriptCode script)
+        {
+            auto& table = s_likely_locales;
+            std::lock_guard lock(table.m_mutex);
+            auto& slot = table.m_published[script];
+            if (const auto locale = slot.load(std::memory_order_relaxed)) return locale;
+            const auto locale = table.m_locales[script];
+            ComputeLikelyLocale(script, locale);
+            slot.store(locale, std::memory_order_release);
+            return locale;
+        }
+    }
+
+    char16 const* LikelyLocale(UScriptCode script)
+    {
+        if (static_cast<u32>(script) >= static_cast<u32>(ScriptTableSize)) [[unlikely]]
+            script = USCRIPT_UNKNOWN;
+        const auto locale = s_likely_locales.m_published[script].load(std::memory_order_acquire);
+        if (locale != nullptr) [[likely]] return reinterpret_cast<char16 const*>(locale);
+        return reinterpret_cast<char16 const*>(LikelyLocaleSlow(script));
+    }
+
+    void WarmUpLikelyLocales()
+    {
+        const auto count = std::min(u_getIntPropertyMaxValue(UCHAR_SCRIPT) + 1, ScriptTableSize);
+        for (auto i = 0; i < count; ++i)
+        {
+            LikelyLocale(static_cast<UScriptCode>(i));
+        }
     }
 }
 
-void Coplt::SplitTexts(List<TextRange>& out, const char16* str, const i32 len)
+namespace
 {
-    if (len == 0) return;
+    struct CharClass
+    {
+        UScriptCode Script;
+        UCharCategory Category;
+    };
 
-    auto cur_script = USCRIPT_INVALID_CODE;
-    auto cur_category = U_UNASSIGNED;
-    i32 cur_i = 0;
-    i32 i = 0;
-    UChar32 c;
-    while (i < len)
+    CharClass ClassifyChar(const UChar32 c)
     {
-        const auto li = i;
-        U16_NEXT(str, i, len, c);
         UErrorCode e{};
         const auto script = uscript_getScript(c, &e);
         if (e > 0) [[unlikely]]
         {
             throw Exception(std::format("GetScript failed: {}", u_errorName(e)));
         }
-        const auto category = static_cast<UCharCategory>(u_charType(c));
-        if (script != cur_script || category != cur_category)
+        return CharClass{script, static_cast<UCharCategory>(u_charType(c))};
+    }
+
+    // icu's answer for every ascii code unit, so ascii text never has to call into icu
+    struct AsciiClassTable
+    {
+        CharClass m_classes[128];
+
+        AsciiClassTable()
         {
-            if (li != 0)
+            for (auto c = 0; c < 128; ++c)
             {
-                out.Add(
-                    TextRange{
-                        .Start = cur_i,
-                        .Length = li - cur_i,
-                        .Script = static_cast<ScriptCode>(cur_script),
-                        .Category = static_cast<CharCategory>(cur_category),
-                        .ScriptIsRtl = static_cast<bool>(uscript_isRightToLeft(cur_script)),
-                        .Locale = UnicodeUtils::LikelyLocale(cur_script),
-                    }
-                );
-                cur_i = li;
+                m_classes[c] = ClassifyChar(c);
             }
-            cur_script = script;
-            cur_category = category;
         }
+    };
+
+    const AsciiClassTable& GetAsciiClassTable()
+    {
+        static const AsciiClassTable s_table{};
+        return s_table;
     }
+
+    // Length of the leading run of ascii code units
+    i32 AsciiPrefixLength(const char16* str, const i32 len)
+    {
+        i32 i = 0;
+#ifdef __AVX2__
+        for (; i + 16 <= len; i += 16)
+        {
+            const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+            const auto ascii = _mm256_cmpeq_epi16(_mm256_and_si256(v, _mm256_set1_epi16(-0x80)), _mm256_setzero_si256());
+            const auto mask = ~static_cast<u32>(_mm256_movemask_epi8(ascii));
+            if (mask != 0) return i + std::countr_zero(mask) / 2;
+        }
+#endif
+#ifdef COPLT_TEXT_SSE2
+        for (; i + 8 <= len; i += 8)
+        {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+            const auto ascii = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(-0x80)), _mm_setzero_si128());
+            const auto mask = ~static_cast<u32>(_mm_movemask_epi8(ascii)) & 0xFFFF;
+            if (mask != 0) return i + std::countr_zero(mask) / 2;
+        }
+#endif
+        for (; i < len; ++i)
+        {
+            if (str[i] >= 0x80) break;
+        }
+        return i;
+    }
+
+    // Length of the leading run of a-z, they all share one class so whole words can be skipped at once
+    i32 LowerPrefixLength(const char16* str, const i32 len)
+    {
+        i32 i = 0;
+#ifdef COPLT_TEXT_SSE2
+        for (; i + 8 <= len; i += 8)
+        {
+            const auto v = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i)), _mm_set1_epi16('a'));
+            const auto lower = _mm_and_si128(
+                _mm_cmpgt_epi16(v, _mm_set1_epi16(-1)),
+                _mm_cmplt_epi16(v, _mm_set1_epi16(26))
+            );
+            const auto mask = ~static_cast<u32>(_mm_movemask_epi8(lower)) & 0xFFFF;
+            if (mask != 0) return i + std::countr_zero(mask) / 2;
+        }
+#endif
+        for (; i < len; ++i)
+        {
+            if (str[i] < 'a' || str[i] > 'z') break;
+        }
+        return i;
+    }
+}
+
+void Coplt::SplitTexts(List<TextRange>& out, const char16* str, const i32 len)
+{
+    if (len == 0) return;
+
+    const auto& ascii = GetAsciiClassTable().m_classes;
+    auto cur_script = USCRIPT_INVALID_CODE;
+    auto cur_category = U_UNASSIGNED;
+    i32 cur_i = 0;
+
+    const auto emit = [&](const i32 end)
     {
         out.Add(
             TextRange{
                 .Start = cur_i,
-                .Length = len - cur_i,
+                .Length = end - cur_i,
                 .Script = static_cast<ScriptCode>(cur_script),
                 .Category = static_cast<CharCategory>(cur_category),
                 .ScriptIsRtl = static_cast<bool>(uscript_isRightToLeft(cur_script)),
                 .Locale = UnicodeUtils::LikelyLocale(cur_script),
             }
         );
+    };
+    const auto next = [&](const i32 li, const CharClass cls)
+    {
+        if (cls.Script != cur_script || cls.Category != cur_category)
+        {
+            if (li != 0)
+            {
+                emit(li);
+                cur_i = li;
+            }
+            cur_script = cls.Script;
+            cur_category = cls.Category;
+        }
+    };
+
+    i32 i = 0;
+    while (i < len)
+    {
+        if (str[i] < 0x80)
+        {
+            const auto end = i + AsciiPrefixLength(str + i, len - i);
+            while (i < end)
+            {
+                next(i, ascii[str[i]]);
+                ++i;
+                // The only ascii lowercase letters are a-z
+                if (cur_category == U_LOWERCASE_LETTER) i += LowerPrefixLength(str + i, end - i);
+            }
+            continue;
+        }
+        const auto li = i;
+        UChar32 c;
+        U16_NEXT(str, i, len, c);
+        next(li, ClassifyChar(c));
+    }
+    emit(len);
+}
+
+void Coplt::SplitTextsBatch(
+    List<TextRange>& out, List<i32>& offsets, const Str16* inputs, const i32 count, const bool parallel
+)
+{
+    if (count <= 0)
+    {
+        offsets.Add(out.Count());
+        return;
+    }
+
+    // Small batches are not worth waking up the pool
+    constexpr u64 MinParallelChars = 16 * 1024;
+    u64 total = 0;
+    for (i32 i = 0; i < count; ++i) total += inputs[i].Size;
+
+    auto& pool = ThreadPool::Shared();
+    if (!parallel || count < 2 || total < MinParallelChars || pool.Concurrency() < 2)
+    {
+        for (i32 i = 0; i < count; ++i)
+        {
+            offsets.Add(out.Count());
+            SplitTexts(out, inputs[i].Data, static_cast<i32>(inputs[i].Size));
+        }
+        offsets.Add(out.Count());
+        return;
+    }
+
+    // Contiguous chunks of roughly equal char count, a few per thread so uneven inputs still balance
+    const auto chunk_count = std::min(count, pool.Concurrency() * 4);
+    const auto chunk_chars = (total + chunk_count - 1) / chunk_count;
+    std::vector<i32> chunk_starts;
+    chunk_starts.reserve(chunk_count + 1);
+    chunk_starts.push_back(0);
+    u64 acc = 0;
+    for (i32 i = 0; i < count; ++i)
+    {
+        acc += inputs[i].Size;
+        if (acc >= chunk_chars * chunk_starts.size() && static_cast<i32>(chunk_starts.size()) < chunk_count)
+            chunk_starts.push_back(i + 1);
+    }
+    if (chunk_starts.back() != count) chunk_starts.push_back(count);
+    const auto chunks = static_cast<i32>(chunk_starts.size()) - 1;
+
+    struct Chunk
+    {
+        List<TextRange> m_ranges{};
+        std::vector<i32> m_counts{};
+    };
+    std::vector<Chunk> results(chunks);
+    pool.ParallelFor(chunks, [&](const i32 c)
+    {
+        auto& chunk = results[c];
+        chunk.m_counts.reserve(chunk_starts[c + 1] - chunk_starts[c]);
+        for (auto i = chunk_starts[c]; i < chunk_starts[c + 1]; ++i)
+        {
+            const auto before = chunk.m_ranges.Count();
+            SplitTexts(chunk.m_ranges, inputs[i].Data, static_cast<i32>(inputs[i].Size));
+            chunk.m_counts.push_back(chunk.m_ranges.Count() - before);
+        }
+    });
+
+    i32 ranges = 0;
+    for (const auto& chunk : results) ranges += chunk.m_ranges.Count();
+    if (out.Capacity() < out.Count() + ranges) out.SetCapacity(out.Count() + ranges);
+    if (offsets.Capacity() < offsets.Count() + count + 1) offsets.SetCapacity(offsets.Count() + count + 1);
+    for (const auto& chunk : results)
+    {
+        auto offset = out.Count();
+        for (const auto n : chunk.m_counts)
+        {
+            offsets.Add(offset);
+            offset += n;
+        }
+        for (const auto& range : chunk.m_ranges) out.Add(range);
     }
+    offsets.Add(out.Count());
 }
 
 extern "C" const char* coplt_ui_get_user_ui_default_locale_impl(usize* len);
@@ -6,9 +6,16 @@ namespace Coplt
 {
     void SplitTexts(List<TextRange>& out, const char16* str, i32 len);
 
+    // Appends the ranges of every input to out, offsets receives count + 1 entries so that
+    // the ranges of input i are out[offsets[i]..offsets[i + 1]]
+    void SplitTextsBatch(List<TextRange>& out, List<i32>& offsets, const Str16* inputs, i32 count, bool parallel);
+
     namespace UnicodeUtils
     {
-        char16 const* LikelyLocale(const UScriptCode script);
+        char16 const* LikelyLocale(UScriptCode script);
+
+        // Fills the likely locale of every known script up front, so that text analysis never hits icu for it
+        void WarmUpLikelyLocales();
     }
 
     extern "C" COPLT_EXPORT const char* coplt_ui_get_user_ui_default_locale(usize* len);
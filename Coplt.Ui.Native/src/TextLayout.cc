@@ -1,16 +1,184 @@
 #include "TextLayout.h"
-#include "TextLayout.h"
+
+#include <cmath>
 
 #include "Algorithm.h"
 
 #include "Layout.h"
 
+using namespace Coplt;
+using namespace Coplt::LayoutCalc;
 using namespace Coplt::LayoutCalc::Texts;
 
 BaseTextLayoutStorage::BaseTextLayoutStorage()
 {
 }
 
+std::optional<LayoutOutput> TextLayoutCache::GetOutput(const LayoutInputs& inputs)
+{
+    switch (inputs.RunMode)
+    {
+    case LayoutRunMode::PerformLayout:
+        {
+            if (!HasFlags(Flags, LayoutCacheFlags::Final)) return std::nullopt;
+            const auto& entry = Final;
+            const auto cached_size = GetSize(entry.Output);
+            const auto input_known_size = GetKnownSize(inputs);
+            const auto cache_known_size = GetKnownSize(entry);
+            const auto input_available_space = GetAvailableSpace(inputs);
+            const auto cache_available_space = GetAvailableSpace(entry);
+
+            if (
+                (input_known_size.Width == cache_known_size.Width || input_known_size.Width == cached_size.Width)
+                && (input_known_size.Height == cache_known_size.Height || input_known_size.Height == cached_size.Height)
+                && (input_known_size.Width.has_value() || IsRoughlyEqual(
+                    cache_available_space.Width, input_available_space.Width
+                ))
+                && (input_known_size.Height.has_value() || IsRoughlyEqual(
+                    cache_available_space.Height, input_available_space.Height
+                ))
+            )
+                return entry.Output;
+        }
+    case LayoutRunMode::ComputeSize:
+        {
+            if ((Flags & ~LayoutCacheFlags::Final) == 0) return std::nullopt;
+            for (u16 i = 0; i < 9; ++i)
+            {
+                if (!HasFlags(Flags, static_cast<LayoutCacheFlags>(1 << (i + 1)))) continue;
+                const auto& entry = Measure[i];
+                const auto size = entry.Size();
+                const auto input_known_size = GetKnownSize(inputs);
+                const auto cache_known_size = GetKnownSize(entry);
+                const auto input_available_space = GetAvailableSpace(inputs);
+                const auto cache_available_space = GetAvailableSpace(entry);
+                if (
+                    (input_known_size.Width == cache_known_size.Width || input_known_size.Width == size.Width)
+                    && (input_known_size.Height == cache_known_size.Height || input_known_size.Height == size.Height)
+                    && (input_known_size.Width.has_value() || IsRoughlyEqual(
+                        cache_available_space.Width, input_available_space.Width
+                    ))
+                    && (input_known_size.Height.has_value() || IsRoughlyEqual(
+                        cache_available_space.Height, input_available_space.Height
+                    ))
+                )
+                    return LayoutOutputFromOuterSize(size);
+            }
+            break;
+        }
+    case LayoutRunMode::PerformHiddenLayout:
+        break;
+    }
+    return std::nullopt;
+}
+
+void TextLayoutCache::StoreFinal(const LayoutInputs& inputs, LayoutOutput output)
+{
+    Flags |= LayoutCacheFlags::Final;
+    Final = {
+        {
+            .KnownWidth = inputs.KnownWidth,
+            .KnownHeight = inputs.KnownHeight,
+            .AvailableSpaceWidthValue = inputs.AvailableSpaceWidthValue,
+            .AvailableSpaceHeightValue = inputs.AvailableSpaceHeightValue,
+            .HasKnownWidth = inputs.HasKnownWidth,
+            .HasKnownHeight = inputs.HasKnownHeight,
+            .AvailableSpaceWidth = inputs.AvailableSpaceWidth,
+            .AvailableSpaceHeight = inputs.AvailableSpaceHeight,
+        },
+        .Output = output,
+    };
+}
+
+void TextLayoutCache::StoreMeasure(const LayoutInputs& inputs, const f32 width, const f32 height)
+{
+    const auto i = ComputeCacheSlot(
+        inputs.HasKnownWidth, inputs.HasKnownHeight,
+        inputs.AvailableSpaceWidth, inputs.AvailableSpaceHeight
+    );
+    Flags |= static_cast<LayoutCacheFlags>(1 << (i + 1));
+    Measure[i] = TextLayoutCache_Measure
+    {
+        {
+            .KnownWidth = inputs.KnownWidth,
+            .KnownHeight = inputs.KnownHeight,
+            .AvailableSpaceWidthValue = inputs.AvailableSpaceWidthValue,
+            .AvailableSpaceHeightValue = inputs.AvailableSpaceHeightValue,
+            .HasKnownWidth = inputs.HasKnownWidth,
+            .HasKnownHeight = inputs.HasKnownHeight,
+            .AvailableSpaceWidth = inputs.AvailableSpaceWidth,
+            .AvailableSpaceHeight = inputs.AvailableSpaceHeight,
+        },
+        .Width = width,
+        .Height = height,
+    };
+}
+
+void TextLayoutCache::Clear()
+{
+    Flags = LayoutCacheFlags::Empty;
+}
+
+f32 TextMeasureCache::KeyOf(const TextMeasureCacheOptions& options, const f32 space)
+{
+    if (options.WidthQuantum <= 0 || std::isinf(space)) return space;
+    return std::floor(space / options.WidthQuantum) * options.WidthQuantum;
+}
+
+const TextMeasureCache::Entry* TextMeasureCache::Find(const f32 key)
+{
+    for (u32 i = 0; i < m_count; ++i)
+    {
+        auto& entry = m_entries[i];
+        if (entry.Space != key) continue;
+        entry.LastUse = ++m_tick;
+        return &entry;
+    }
+    return nullptr;
+}
+
+void TextMeasureCache::Store(
+    const TextMeasureCacheOptions& options, const f32 key, const LayoutOutput& output, const u32 line_count
+)
+{
+    const auto capacity = std::min(options.Capacity, MaxCapacity);
+    if (capacity == 0) return;
+    Entry* slot = nullptr;
+    for (u32 i = 0; i < m_count; ++i)
+    {
+        if (m_entries[i].Space == key)
+        {
+            slot = &m_entries[i];
+            break;
+        }
+    }
+    if (slot == nullptr)
+    {
+        if (m_count < capacity) slot = &m_entries[m_count++];
+        else
+        {
+            // Evict the least recently used, also trims the cache if the capacity was lowered
+            m_count = capacity;
+            slot = &m_entries[0];
+            for (u32 i = 1; i < m_count; ++i)
+            {
+                if (m_entries[i].LastUse < slot->LastUse) slot = &m_entries[i];
+            }
+        }
+    }
+    *slot = Entry{
+        .Space = key,
+        .LineCount = line_count,
+        .LastUse = ++m_tick,
+        .Output = output,
+    };
+}
+
+void TextMeasureCache::Clear()
+{
+    m_count = 0;
+}
+
 i32 BaseTextLayoutStorage::SearchItem(const u32 Paragraph, const u32 Position) const
 {
     return -1;
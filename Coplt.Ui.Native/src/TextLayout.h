@@ -5,6 +5,7 @@
 
 #include "Com.h"
 #include "LayoutCommon.h"
+#include "SmallList.h"
 
 namespace Coplt::LayoutCalc::Texts
 {
@@ -32,13 +33,24 @@ namespace Coplt::LayoutCalc::Texts
 
     struct Paragraph
     {
-        std::vector<TextScopeRange> ScopeRanges{};
+        // Most paragraphs have one style scope, a few have a handful
+        SmallList<TextScopeRange, 4> ScopeRanges{};
         u32 ItemStart;
         u32 ItemLength;
         u32 LogicTextLength;
         TextParagraphType Type;
     };
 
+    // Chars [Start, Start + OldLength) of a paragraph were replaced by NewLength chars; edits of one paragraph are
+    // given against its previous text and must not overlap
+    struct TextEdit
+    {
+        u32 Paragraph;
+        u32 Start;
+        u32 OldLength;
+        u32 NewLength;
+    };
+
     struct BaseTextLayoutStorage
     {
         std::vector<Paragraph> m_paragraphs{};
@@ -52,6 +64,71 @@ namespace Coplt::LayoutCalc::Texts
         i32 SearchItem(u32 Paragraph, u32 Position) const;
     };
 
+    struct TextLayoutCache_Final : CacheEntryBase
+    {
+        LayoutOutput Output;
+        // todo other data
+    };
+
+    struct TextLayoutCache_Measure : CacheEntryBase
+    {
+        f32 Width;
+        f32 Height;
+
+        Size<f32> Size() const
+        {
+            return {.Width = Width, .Height = Height};
+        }
+    };
+
+    struct TextLayoutCache
+    {
+        TextLayoutCache_Final Final;
+        TextLayoutCache_Measure Measure[9];
+        LayoutCacheFlags Flags;
+
+        std::optional<LayoutOutput> GetOutput(const LayoutInputs& inputs);
+
+        void StoreFinal(const LayoutInputs& inputs, LayoutOutput output);
+        void StoreMeasure(const LayoutInputs& inputs, f32 width, f32 height);
+        void Clear();
+    };
+
+    struct TextMeasureCacheOptions
+    {
+        // Entries per paragraph, 0 disables the cache
+        u32 Capacity{};
+        // Widths are rounded down to a multiple of this and measured at the rounded width, so the widths of one step
+        // share an entry; 0 keeps them exact
+        f32 WidthQuantum{};
+    };
+
+    // The last few ComputeSize results of a paragraph keyed by its main axis space; TextLayoutCache only has one slot
+    // per constraint kind, so flex and grid probing min-content, max-content and several definite widths thrash it
+    struct TextMeasureCache
+    {
+        static constexpr u32 MaxCapacity = 16;
+
+        struct Entry
+        {
+            f32 Space;
+            u32 LineCount;
+            u32 LastUse;
+            LayoutOutput Output;
+        };
+
+        Entry m_entries[MaxCapacity];
+        u32 m_count{};
+        u32 m_tick{};
+
+        // The space to measure at and to key the entry by, inf for max-content
+        static f32 KeyOf(const TextMeasureCacheOptions& options, f32 space);
+
+        const Entry* Find(f32 key);
+        void Store(const TextMeasureCacheOptions& options, f32 key, const LayoutOutput& output, u32 line_count);
+        void Clear();
+    };
+
     template <class Self>
     struct BaseTextLayout : ComImpl<Self, ITextLayout>, BaseTextLayoutStorage
     {
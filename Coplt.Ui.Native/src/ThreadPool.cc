@@ -0,0 +1,103 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+using namespace Coplt;
+
+ThreadPool::Job::Job(const Body body, void* ctx, const i32 count)
+    : m_body(body), m_ctx(ctx), m_count(count)
+{
+}
+
+bool ThreadPool::Job::Exhausted() const
+{
+    return m_next.load(std::memory_order_relaxed) >= m_count;
+}
+
+void ThreadPool::Job::Run()
+{
+    for (;;)
+    {
+        const auto i = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= m_count) return;
+        try
+        {
+            m_body(m_ctx, i);
+        }
+        catch (...)
+        {
+            std::lock_guard lock(m_error_mutex);
+            if (!m_error) m_error = std::current_exception();
+        }
+        if (m_done.fetch_add(1, std::memory_order_acq_rel) + 1 == m_count)
+            m_done.notify_all();
+    }
+}
+
+ThreadPool::ThreadPool(const i32 threads)
+{
+    m_threads.reserve(threads);
+    for (i32 i = 0; i < threads; ++i)
+    {
+        m_threads.emplace_back([this] { WorkerMain(); });
+    }
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    // Intentionally leaked, joining in a static destructor can deadlock while the library is being unloaded
+    static ThreadPool* s_pool = new ThreadPool(
+        static_cast<i32>(std::max(std::thread::hardware_concurrency(), 1u) - 1)
+    );
+    return *s_pool;
+}
+
+i32 ThreadPool::Concurrency() const
+{
+    return static_cast<i32>(m_threads.size()) + 1;
+}
+
+void ThreadPool::Dispatch(const Body body, void* ctx, const i32 count)
+{
+    if (count <= 0) return;
+    if (count == 1 || m_threads.empty())
+    {
+        for (i32 i = 0; i < count; ++i) body(ctx, i);
+        return;
+    }
+
+    const auto job = std::make_shared<Job>(body, ctx, count);
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(job);
+    }
+    m_cv.notify_all();
+
+    job->Run();
+    for (auto done = job->m_done.load(std::memory_order_acquire); done < count;
+         done = job->m_done.load(std::memory_order_acquire))
+    {
+        job->m_done.wait(done, std::memory_order_acquire);
+    }
+
+    if (job->m_error) std::rethrow_exception(job->m_error);
+}
+
+void ThreadPool::WorkerMain()
+{
+    for (;;)
+    {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [&] { return !m_jobs.empty(); });
+            job = m_jobs.front();
+            if (job->Exhausted())
+            {
+                m_jobs.pop_front();
+                continue;
+            }
+        }
+        job->Run();
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Com.h"
+
+namespace Coplt
+{
+    // Fork-join pool for data parallel work inside a single native call
+    struct ThreadPool
+    {
+        using Body = void(*)(void* ctx, i32 index);
+
+        struct Job
+        {
+            Body m_body;
+            void* m_ctx;
+            i32 m_count;
+            std::atomic<i32> m_next{0};
+            std::atomic<i32> m_done{0};
+            std::mutex m_error_mutex{};
+            std::exception_ptr m_error{};
+
+            explicit Job(Body body, void* ctx, i32 count);
+
+            bool Exhausted() const;
+            void Run();
+        };
+
+        std::vector<std::thread> m_threads{};
+        std::mutex m_mutex{};
+        std::condition_variable m_cv{};
+        std::deque<std::shared_ptr<Job>> m_jobs{};
+
+        explicit ThreadPool(i32 threads);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Lives until process exit, worker threads are never joined
+        static ThreadPool& Shared();
+
+        // Worker threads plus the calling thread
+        i32 Concurrency() const;
+
+        // Calls body(i) for every i in [0, count) and blocks until all are done,
+        // the calling thread takes part, the first exception thrown is rethrown here
+        template <class F>
+        void ParallelFor(const i32 count, F&& body)
+        {
+            Dispatch(
+                [](void* ctx, const i32 index) { (*static_cast<std::remove_reference_t<F>*>(ctx))(index); },
+                const_cast<void*>(static_cast<const void*>(std::addressof(body))), count
+            );
+        }
+
+        // Calls body(worker, i) for every i in [0, count), items are claimed one at a time so uneven items balance;
+        // worker is in [0, min(count, Concurrency())) and never used by two threads at once, so it can index
+        // per thread state such as arenas
+        template <class F>
+        void ParallelForWorkers(const i32 count, F&& body)
+        {
+            if (count <= 0) return;
+            std::atomic<i32> next{0};
+            ParallelFor(
+                std::min(count, Concurrency()), [&](const i32 worker)
+                {
+                    for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+                         i = next.fetch_add(1, std::memory_order_relaxed))
+                    {
+                        body(worker, i);
+                    }
+                }
+            );
+        }
+
+    private:
+        void Dispatch(Body body, void* ctx, i32 count);
+        void WorkerMain();
+    };
+}
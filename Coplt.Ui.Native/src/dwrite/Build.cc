@@ -9,4 +9,7 @@
 #include "Font.cc"
 #include "FontFace.cc"
 #include "Layout.cc"
+#include "GlyphBuffer.cc"
+#include "FontMetricsCache.cc"
+#include "ShapeCache.cc"
 #include "TextLayout.cc"
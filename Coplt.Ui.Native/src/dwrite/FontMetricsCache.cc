@@ -0,0 +1,124 @@
+#include "FontMetricsCache.h"
+
+#include <bit>
+#include <mutex>
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc::Texts;
+
+namespace
+{
+    std::mutex s_caches_mutex{};
+    FlatMap<IFontManager*, FontMetricsCache*> s_caches{};
+
+    void COPLT_CDECL OnManagerDrop(void* data)
+    {
+        const auto cache = static_cast<FontMetricsCache*>(data);
+        {
+            std::lock_guard lock(s_caches_mutex);
+            // The manager is going away, its address may be reused by the next one
+            for (auto e = s_caches.GetEnumerator(); e.MoveNext();)
+            {
+                const auto [manager, value] = e.Current();
+                if (*value != cache) continue;
+                s_caches.Remove(*manager);
+                break;
+            }
+        }
+        delete cache;
+    }
+
+    void COPLT_CDECL OnFaceExpired(void* data, IFontFace*, const u64 id)
+    {
+        static_cast<FontMetricsCache*>(data)->Remove(id);
+    }
+
+    u64 LineInfoKey(const f32 font_size, const WritingDirection direction)
+    {
+        return static_cast<u64>(std::bit_cast<u32>(font_size)) << 1 | static_cast<u64>(direction);
+    }
+}
+
+FontMetrics FontMetrics::Of(IDWriteFontFace5* face)
+{
+    DWRITE_FONT_METRICS1 metrics{};
+    if (face != nullptr) face->GetMetrics(&metrics);
+    return FontMetrics{
+        .Ascent = static_cast<f32>(metrics.ascent),
+        .Descent = static_cast<f32>(metrics.descent),
+        .LineGap = static_cast<f32>(metrics.lineGap),
+        .DesignUnitsPerEm = static_cast<f32>(metrics.designUnitsPerEm),
+        .GlyphBoxLeft = static_cast<f32>(metrics.glyphBoxLeft),
+        .GlyphBoxRight = static_cast<f32>(metrics.glyphBoxRight),
+    };
+}
+
+ParagraphLineInfo FontMetrics::Scale(const f32 font_size, const WritingDirection direction) const
+{
+    ParagraphLineInfo info{};
+    // No metrics, e.g. the face could not be loaded
+    if (DesignUnitsPerEm == 0) return info;
+    const auto scale = font_size / DesignUnitsPerEm;
+    if (direction == WritingDirection::Horizontal)
+    {
+        info.Ascent = Ascent * scale;
+        info.Descent = Descent * scale;
+        info.LineGap = LineGap * scale;
+    }
+    else
+    {
+        // todo: not sure, need test
+        info.LineGap = LineGap * scale;
+        const auto glyph_box_size = GlyphBoxRight - GlyphBoxLeft;
+        info.Ascent = info.Descent = glyph_box_size * scale * 0.5f;
+    }
+    info.MinSize = info.Ascent + info.Descent;
+    return info;
+}
+
+FontMetricsCache& FontMetricsCache::Of(IFontManager* manager)
+{
+    std::lock_guard lock(s_caches_mutex);
+    auto r = s_caches.GetValueRefOrUninitializedValue(manager);
+    if (r.Exists()) return *r.GetValue();
+    const auto cache = new FontMetricsCache();
+    r.SetValue(cache);
+    manager->SetAssocUpdate(cache, &OnManagerDrop, nullptr, &OnFaceExpired);
+    return *cache;
+}
+
+const ParagraphLineInfo& FontMetricsCache::Get(
+    const u64 face_id, IDWriteFontFace5* face, const f32 font_size, const WritingDirection direction
+)
+{
+    const auto key = LineInfoKey(font_size, direction);
+    {
+        std::shared_lock lock(m_mutex);
+        if (const auto r = m_faces.TryGet(face_id))
+        {
+            if (const auto info = r.GetValue()->m_line_infos.TryGet(key)) return *info.GetValue();
+        }
+    }
+
+    std::lock_guard lock(m_mutex);
+    auto face_r = m_faces.GetValueRefOrUninitializedValue(face_id);
+    // Only the first size of a face reads the metrics, other sizes just scale them
+    if (!face_r.Exists()) face_r.SetValue(std::make_unique<Face>())->Metrics = FontMetrics::Of(face);
+    auto& entry = *face_r.GetValue();
+    auto info_r = entry.m_line_infos.GetValueRefOrUninitializedValue(key);
+    if (!info_r.Exists())
+        info_r.SetValue(std::make_unique<ParagraphLineInfo>(entry.Metrics.Scale(font_size, direction)));
+    return *info_r.GetValue();
+}
+
+void FontMetricsCache::Remove(const u64 face_id)
+{
+    std::lock_guard lock(m_mutex);
+    m_faces.Remove(face_id);
+}
+
+u32 FontMetricsCache::Count()
+{
+    std::shared_lock lock(m_mutex);
+    return static_cast<u32>(m_faces.Count());
+}
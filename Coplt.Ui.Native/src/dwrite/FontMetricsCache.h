@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <shared_mutex>
+#include <dwrite_3.h>
+
+#include "../Com.h"
+#include "../FlatMap.h"
+#include "../LayoutCommon.h"
+
+namespace Coplt::LayoutCalc::Texts
+{
+    // Design unit metrics of a face, what line heights are derived from
+    struct FontMetrics
+    {
+        f32 Ascent;
+        f32 Descent;
+        f32 LineGap;
+        f32 DesignUnitsPerEm;
+        f32 GlyphBoxLeft;
+        f32 GlyphBoxRight;
+
+        static FontMetrics Of(IDWriteFontFace5* face);
+
+        ParagraphLineInfo Scale(f32 font_size, WritingDirection direction) const;
+    };
+
+    // Metrics of the faces of one font manager keyed by face id, with the line info of every font size and writing
+    // direction a face is used at memoized, so runs sharing a face and size do not fetch and scale the metrics again.
+    // Attached to the font manager through an assoc update, entries go when their face expires and the cache goes
+    // with the manager. Thread safe
+    struct FontMetricsCache
+    {
+        struct Face
+        {
+            FontMetrics Metrics;
+            // Keyed by font size bits and writing direction, boxed so returned references survive rehashing
+            FlatMap<u64, std::unique_ptr<ParagraphLineInfo>> m_line_infos{};
+        };
+
+        std::shared_mutex m_mutex{};
+        FlatMap<u64, std::unique_ptr<Face>> m_faces{};
+
+        // Creates the cache of the manager on first use
+        static FontMetricsCache& Of(IFontManager* manager);
+
+        // face is only read on the first use of the face id; the reference stays valid until the face expires
+        const ParagraphLineInfo& Get(u64 face_id, IDWriteFontFace5* face, f32 font_size, WritingDirection direction);
+        void Remove(u64 face_id);
+        u32 Count();
+    };
+}
@@ -0,0 +1,180 @@
+#include "GlyphBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <bit>
+#include <mimalloc.h>
+
+#include "../ClusterWidths.h"
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc::Texts;
+
+static_assert(sizeof(GlyphOffset) == sizeof(DWRITE_GLYPH_OFFSET));
+static_assert(offsetof(GlyphOffset, AdvanceOffset) == offsetof(DWRITE_GLYPH_OFFSET, advanceOffset));
+static_assert(sizeof(DWRITE_SHAPING_GLYPH_PROPERTIES) == sizeof(u16));
+
+namespace
+{
+    constexpr u16 ClusterStartMask = std::bit_cast<u16>(DWRITE_SHAPING_GLYPH_PROPERTIES{.isClusterStart = 1});
+
+    constexpr usize AlignColumn(const usize offset)
+    {
+        return (offset + GlyphBuffer::ColumnAlign - 1) & ~(GlyphBuffer::ColumnAlign - 1);
+    }
+
+    template <class T>
+    T* Column(std::byte* block, usize& offset, const u32 cap)
+    {
+        const auto column = reinterpret_cast<T*>(block + offset);
+        offset = AlignColumn(offset + sizeof(T) * cap);
+        return column;
+    }
+
+    template <class T>
+    void CopyColumn(T* dst, const T* src, const u32 count)
+    {
+        if (count > 0) std::memcpy(dst, src, sizeof(T) * count);
+    }
+}
+
+GlyphBuffer::~GlyphBuffer()
+{
+    mi_free(m_block);
+}
+
+GlyphBuffer::GlyphBuffer(GlyphBuffer&& other) noexcept
+    : m_block(std::exchange(other.m_block, nullptr)),
+      m_char_cap(std::exchange(other.m_char_cap, 0)),
+      m_glyph_cap(std::exchange(other.m_glyph_cap, 0)),
+      m_char_count(std::exchange(other.m_char_count, 0)),
+      m_glyph_count(std::exchange(other.m_glyph_count, 0)),
+      m_cluster_map(std::exchange(other.m_cluster_map, nullptr)),
+      m_text_props(std::exchange(other.m_text_props, nullptr)),
+      m_glyph_indices(std::exchange(other.m_glyph_indices, nullptr)),
+      m_glyph_props(std::exchange(other.m_glyph_props, nullptr)),
+      m_glyph_advances(std::exchange(other.m_glyph_advances, nullptr)),
+      m_glyph_offsets(std::exchange(other.m_glyph_offsets, nullptr)),
+      m_cluster_widths(std::exchange(other.m_cluster_widths, nullptr))
+{
+}
+
+GlyphBuffer& GlyphBuffer::operator=(GlyphBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->~GlyphBuffer();
+        new(this) GlyphBuffer(std::move(other));
+    }
+    return *this;
+}
+
+void GlyphBuffer::Clear()
+{
+    m_char_count = 0;
+    m_glyph_count = 0;
+}
+
+void GlyphBuffer::Reserve(const u32 chars, const u32 glyphs)
+{
+    const auto need_chars = m_char_count + chars;
+    const auto need_glyphs = m_glyph_count + glyphs;
+    if (need_chars <= m_char_cap && need_glyphs <= m_glyph_cap) [[likely]] return;
+    Realloc(
+        need_chars <= m_char_cap ? m_char_cap : std::max({need_chars, m_char_cap * 2, 64u}),
+        need_glyphs <= m_glyph_cap ? m_glyph_cap : std::max({need_glyphs, m_glyph_cap * 2, 64u})
+    );
+}
+
+u32 GlyphBuffer::AddChars(const u32 count)
+{
+    Reserve(count, 0);
+    const auto start = m_char_count;
+    m_char_count += count;
+    return start;
+}
+
+u32 GlyphBuffer::AddGlyphs(const u32 count)
+{
+    Reserve(0, count);
+    const auto start = m_glyph_count;
+    m_glyph_count += count;
+    return start;
+}
+
+void GlyphBuffer::PopGlyphs(const u32 count)
+{
+    if (count > m_glyph_count) throw Exception("Argument out of range");
+    m_glyph_count -= count;
+}
+
+void GlyphBuffer::AppendFrom(
+    const GlyphBuffer& src, const u32 char_start, const u32 char_count, const u32 glyph_start, const u32 glyph_count
+)
+{
+    if (char_start + char_count > src.m_char_count || glyph_start + glyph_count > src.m_glyph_count)
+        throw Exception("Argument out of range");
+    const auto chars = AddChars(char_count);
+    const auto glyphs = AddGlyphs(glyph_count);
+    CopyColumn(m_cluster_map + chars, src.m_cluster_map + char_start, char_count);
+    CopyColumn(m_text_props + chars, src.m_text_props + char_start, char_count);
+    CopyColumn(m_glyph_indices + glyphs, src.m_glyph_indices + glyph_start, glyph_count);
+    CopyColumn(m_glyph_props + glyphs, src.m_glyph_props + glyph_start, glyph_count);
+    CopyColumn(m_glyph_advances + glyphs, src.m_glyph_advances + glyph_start, glyph_count);
+    CopyColumn(m_glyph_offsets + glyphs, src.m_glyph_offsets + glyph_start, glyph_count);
+    CopyColumn(m_cluster_widths + glyphs, src.m_cluster_widths + glyph_start, glyph_count);
+}
+
+void GlyphBuffer::ComputeClusterWidths(const u32 start, const u32 count)
+{
+    if (start + count > m_glyph_count) throw Exception("Argument out of range");
+    Coplt::ComputeClusterWidths(
+        m_cluster_widths + start, m_glyph_advances + start,
+        reinterpret_cast<const GlyphOffset*>(m_glyph_offsets + start),
+        reinterpret_cast<const u16*>(m_glyph_props + start), ClusterStartMask, count
+    );
+}
+
+void GlyphBuffer::Realloc(const u32 char_cap, const u32 glyph_cap)
+{
+    usize size = 0;
+    size = AlignColumn(size + sizeof(u16) * char_cap);
+    size = AlignColumn(size + sizeof(DWRITE_SHAPING_TEXT_PROPERTIES) * char_cap);
+    size = AlignColumn(size + sizeof(u16) * glyph_cap);
+    size = AlignColumn(size + sizeof(DWRITE_SHAPING_GLYPH_PROPERTIES) * glyph_cap);
+    size = AlignColumn(size + sizeof(f32) * glyph_cap);
+    size = AlignColumn(size + sizeof(DWRITE_GLYPH_OFFSET) * glyph_cap);
+    size = AlignColumn(size + sizeof(f32) * glyph_cap);
+
+    const auto block = static_cast<std::byte*>(mi_malloc_aligned(size, ColumnAlign));
+    if (block == nullptr) throw std::bad_alloc();
+
+    usize offset = 0;
+    const auto cluster_map = Column<u16>(block, offset, char_cap);
+    const auto text_props = Column<DWRITE_SHAPING_TEXT_PROPERTIES>(block, offset, char_cap);
+    const auto glyph_indices = Column<u16>(block, offset, glyph_cap);
+    const auto glyph_props = Column<DWRITE_SHAPING_GLYPH_PROPERTIES>(block, offset, glyph_cap);
+    const auto glyph_advances = Column<f32>(block, offset, glyph_cap);
+    const auto glyph_offsets = Column<DWRITE_GLYPH_OFFSET>(block, offset, glyph_cap);
+    const auto cluster_widths = Column<f32>(block, offset, glyph_cap);
+
+    CopyColumn(cluster_map, m_cluster_map, m_char_count);
+    CopyColumn(text_props, m_text_props, m_char_count);
+    CopyColumn(glyph_indices, m_glyph_indices, m_glyph_count);
+    CopyColumn(glyph_props, m_glyph_props, m_glyph_count);
+    CopyColumn(glyph_advances, m_glyph_advances, m_glyph_count);
+    CopyColumn(glyph_offsets, m_glyph_offsets, m_glyph_count);
+    CopyColumn(cluster_widths, m_cluster_widths, m_glyph_count);
+    mi_free(m_block);
+
+    m_block = block;
+    m_char_cap = char_cap;
+    m_glyph_cap = glyph_cap;
+    m_cluster_map = cluster_map;
+    m_text_props = text_props;
+    m_glyph_indices = glyph_indices;
+    m_glyph_props = glyph_props;
+    m_glyph_advances = glyph_advances;
+    m_glyph_offsets = glyph_offsets;
+    m_cluster_widths = cluster_widths;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <span>
+#include <dwrite_3.h>
+
+#include "../Com.h"
+
+namespace Coplt::LayoutCalc::Texts
+{
+    // Shaping output of all runs in a paragraph, the per char and per glyph columns are laid out
+    // back to back in one block so a run's glyphs can be streamed column by column;
+    // Clear keeps the block, so a rebuild that fits the previous capacity does not allocate
+    struct GlyphBuffer
+    {
+        static constexpr usize ColumnAlign = 64;
+
+        std::byte* m_block{};
+        u32 m_char_cap{};
+        u32 m_glyph_cap{};
+        u32 m_char_count{};
+        u32 m_glyph_count{};
+
+        // per char
+        u16* m_cluster_map{};
+        DWRITE_SHAPING_TEXT_PROPERTIES* m_text_props{};
+        // per glyph
+        u16* m_glyph_indices{};
+        DWRITE_SHAPING_GLYPH_PROPERTIES* m_glyph_props{};
+        f32* m_glyph_advances{};
+        DWRITE_GLYPH_OFFSET* m_glyph_offsets{};
+        // Filled by ComputeClusterWidths once a run is placed, see Coplt::ComputeClusterWidths
+        f32* m_cluster_widths{};
+
+        GlyphBuffer() = default;
+        ~GlyphBuffer();
+
+        GlyphBuffer(const GlyphBuffer&) = delete;
+        GlyphBuffer& operator=(const GlyphBuffer&) = delete;
+
+        GlyphBuffer(GlyphBuffer&& other) noexcept;
+        GlyphBuffer& operator=(GlyphBuffer&& other) noexcept;
+
+        u32 CharCount() const { return m_char_count; }
+        u32 GlyphCount() const { return m_glyph_count; }
+
+        void Clear();
+
+        // Makes room for chars more chars and glyphs more glyphs, may move every column
+        void Reserve(u32 chars, u32 glyphs);
+
+        // Appends uninitialized entries and returns the index of the first one
+        u32 AddChars(u32 count);
+        u32 AddGlyphs(u32 count);
+        // Gives back the unused tail of the last AddGlyphs, e.g. after shaping produced fewer glyphs than reserved
+        void PopGlyphs(u32 count);
+
+        // Appends the chars [char_start, char_start + char_count) and glyphs [glyph_start, glyph_start + glyph_count)
+        // of another buffer with every column, cluster maps are run relative so they copy as is
+        void AppendFrom(const GlyphBuffer& src, u32 char_start, u32 char_count, u32 glyph_start, u32 glyph_count);
+
+        // Derives m_cluster_widths for the glyphs [start, start + count) from their props, advances and offsets
+        void ComputeClusterWidths(u32 start, u32 count);
+
+    private:
+        void Realloc(u32 char_cap, u32 glyph_cap);
+    };
+}
@@ -16,14 +16,26 @@ Layout::Layout(Rc<LibUi> lib, Rc<IDWriteTextAnalyzer1>& text_analyzer, Rc<IDWrit
 {
 }
 
+namespace Coplt::LayoutCalc
+{
+    namespace
+    {
+        Rc<IDWriteTextAnalyzer1> CreateTextAnalyzer(const LibUi& lib)
+        {
+            Rc<IDWriteTextAnalyzer> analyzer;
+            if (const auto hr = lib.m_backend->m_dw_factory->CreateTextAnalyzer(analyzer.put()); FAILED(hr))
+                throw ComException(hr, "Failed to create text analyzer");
+            Rc<IDWriteTextAnalyzer1> analyzer1;
+            if (const auto hr = analyzer->QueryInterface(analyzer1.put()); FAILED(hr))
+                throw ComException(hr, "Failed to create text analyzer");
+            return analyzer1;
+        }
+    }
+}
+
 Rc<Layout> LayoutCalc::CreateLayout(Rc<LibUi> lib)
 {
-    Rc<IDWriteTextAnalyzer> analyzer;
-    if (const auto hr = lib->m_backend->m_dw_factory->CreateTextAnalyzer(analyzer.put()); FAILED(hr))
-        throw ComException(hr, "Failed to create text analyzer");
-    Rc<IDWriteTextAnalyzer1> analyzer1;
-    if (const auto hr = analyzer->QueryInterface(analyzer1.put()); FAILED(hr))
-        throw ComException(hr, "Failed to create text analyzer");
+    auto analyzer1 = CreateTextAnalyzer(*lib);
 
     Rc<IDWriteFontFallback> font_fallback;
     if (const auto hr = lib->m_backend->m_dw_factory->GetSystemFontFallback(font_fallback.put()); FAILED(hr))
@@ -36,6 +48,18 @@ Rc<Layout> LayoutCalc::CreateLayout(Rc<LibUi> lib)
     return Rc(new Layout(std::move(lib), analyzer1, font_fallback1));
 }
 
+void Layout::EnsureWorkerTextAnalyzers(const i32 workers)
+{
+    while (static_cast<i32>(m_worker_text_analyzers.size()) + 1 < workers)
+        m_worker_text_analyzers.push_back(CreateTextAnalyzer(*m_lib));
+}
+
+IDWriteTextAnalyzer1* Layout::WorkerTextAnalyzer(const i32 worker) const
+{
+    if (worker == 0) return m_text_analyzer.get();
+    return m_worker_text_analyzers[worker - 1].get();
+}
+
 HResult Layout::Impl_Calc(NLayoutContext* ctx)
 {
     return feb(
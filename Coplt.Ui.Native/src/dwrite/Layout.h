@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <vector>
 #include <dwrite_3.h>
 #include "../Com.h"
 #include "../Layout.h"
@@ -17,6 +18,8 @@ namespace Coplt::LayoutCalc
         Rc<LibUi> m_lib;
         Rc<IDWriteTextAnalyzer1> m_text_analyzer;
         Rc<IDWriteFontFallback1> m_system_font_fallback;
+        // Analyzers of workers 1.. of a parallel text layout rebuild, worker 0 is the calling thread and uses m_text_analyzer
+        std::vector<Rc<IDWriteTextAnalyzer1>> m_worker_text_analyzers{};
 
         explicit Layout(Rc<LibUi> lib, Rc<IDWriteTextAnalyzer1>& analyzer, Rc<IDWriteFontFallback1>& font_fallback);
 
@@ -28,5 +31,9 @@ namespace Coplt::LayoutCalc
         COPLT_IMPL_END
 
         HResult Calc(NLayoutContext* ctx);
+
+        // Must be called before fanning out, the analyzers are created on the calling thread
+        void EnsureWorkerTextAnalyzers(i32 workers);
+        IDWriteTextAnalyzer1* WorkerTextAnalyzer(i32 worker) const;
     };
 } // namespace Coplt
@@ -0,0 +1,238 @@
+#include "ShapeCache.h"
+
+#include <bit>
+#include <cstring>
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc::Texts;
+
+static_assert(sizeof(char16) == sizeof(u16));
+static_assert(sizeof(DWRITE_SHAPING_TEXT_PROPERTIES) == sizeof(u16));
+static_assert(sizeof(DWRITE_SHAPING_GLYPH_PROPERTIES) == sizeof(u16));
+static_assert(sizeof(DWRITE_GLYPH_OFFSET) == 2 * sizeof(f32));
+
+namespace
+{
+    constexpr u64 HashMul = 0x9E3779B97F4A7C15ull;
+
+    u64 Mix(u64 hash, const u64 value)
+    {
+        hash = (hash ^ value) * HashMul;
+        return hash ^ (hash >> 32);
+    }
+
+    u32 StrLength(const char16* str)
+    {
+        if (str == nullptr) return 0;
+        u32 len = 0;
+        while (str[len] != 0) ++len;
+        return len;
+    }
+
+    template <class T>
+    void CopyTo(T* dst, const void* src, const u32 count)
+    {
+        if (count > 0) std::memcpy(dst, src, sizeof(T) * count);
+    }
+}
+
+usize ShapeCache::Entry::Bytes() const
+{
+    return sizeof(Entry) + m_u16.capacity() * sizeof(u16) + m_f32.capacity() * sizeof(f32);
+}
+
+bool ShapeCache::Entry::Matches(const std::span<const char16> text, const ShapeCacheKey& key) const
+{
+    if (
+        Length != text.size() || Font.get() != key.Font || FontSize != key.FontSize
+        || Script.script != key.Script.script || Script.shapes != key.Script.shapes
+        || Features != key.Features || IsRtl != key.IsRtl
+    )
+        return false;
+    if (std::memcmp(m_u16.data(), text.data(), sizeof(u16) * Length) != 0) return false;
+    const auto locale_length = StrLength(key.Locale);
+    return LocaleLength == locale_length
+        && (locale_length == 0 || std::memcmp(m_u16.data() + Length, key.Locale, sizeof(u16) * locale_length) == 0);
+}
+
+ShapeCache& ShapeCache::Shared()
+{
+    // Intentionally leaked, entries hold font faces that must not be released while the library is being unloaded
+    static ShapeCache* s_cache = new ShapeCache();
+    return *s_cache;
+}
+
+void ShapeCache::SetBudget(const u64 bytes)
+{
+    m_budget.store(bytes, std::memory_order_relaxed);
+    for (auto& shard : m_shards)
+    {
+        std::lock_guard lock(shard.m_mutex);
+        Evict(shard, bytes / ShardCount);
+    }
+}
+
+ShapeCacheStats ShapeCache::Stats()
+{
+    ShapeCacheStats stats{
+        .Hits = m_hits.load(std::memory_order_relaxed),
+        .Misses = m_misses.load(std::memory_order_relaxed),
+        .Evictions = m_evictions.load(std::memory_order_relaxed),
+    };
+    for (auto& shard : m_shards)
+    {
+        std::lock_guard lock(shard.m_mutex);
+        stats.Bytes += shard.m_bytes;
+        stats.Entries += static_cast<u32>(shard.m_map.Count());
+    }
+    return stats;
+}
+
+void ShapeCache::Clear()
+{
+    for (auto& shard : m_shards)
+    {
+        std::lock_guard lock(shard.m_mutex);
+        shard.m_map.Clear();
+        shard.m_lru.clear();
+        shard.m_bytes = 0;
+    }
+}
+
+u64 ShapeCache::Hash(const std::span<const char16> text, const ShapeCacheKey& key)
+{
+    auto hash = Mix(text.size(), reinterpret_cast<usize>(key.Font));
+    hash = Mix(hash, std::bit_cast<u32>(key.FontSize));
+    hash = Mix(hash, key.Script.script | static_cast<u64>(key.Script.shapes) << 16 | static_cast<u64>(key.IsRtl) << 48);
+    hash = Mix(hash, key.Features);
+    usize i = 0;
+    for (; i + 4 <= text.size(); i += 4)
+    {
+        u64 chunk;
+        std::memcpy(&chunk, text.data() + i, sizeof(chunk));
+        hash = Mix(hash, chunk);
+    }
+    for (; i < text.size(); ++i) hash = Mix(hash, static_cast<u16>(text[i]));
+    if (key.Locale != nullptr)
+    {
+        for (auto c = key.Locale; *c != 0; ++c) hash = Mix(hash, static_cast<u16>(*c));
+    }
+    return hash;
+}
+
+u64 ShapeCache::HashFeatures(const std::span<const DWRITE_FONT_FEATURE> features)
+{
+    auto hash = Mix(0, features.size());
+    for (const auto& feature : features)
+        hash = Mix(hash, static_cast<u64>(feature.nameTag) | static_cast<u64>(feature.parameter) << 32);
+    return hash;
+}
+
+ShapeCache::Shard& ShapeCache::ShardOf(const u64 hash)
+{
+    // The low bits pick the slot inside the shard map
+    return m_shards[(hash >> 56) % ShardCount];
+}
+
+i32 ShapeCache::TryAppend(
+    const u64 hash, const std::span<const char16> text, const ShapeCacheKey& key, GlyphBuffer& dst
+)
+{
+    auto& shard = ShardOf(hash);
+    std::lock_guard lock(shard.m_mutex);
+    const auto r = shard.m_map.TryGet(hash);
+    if (!r || !r.GetValue()->Matches(text, key))
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    const auto it = r.GetValue();
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+
+    const auto& entry = *it;
+    const auto chars = dst.AddChars(entry.Length);
+    const auto glyphs = dst.AddGlyphs(entry.GlyphCount);
+    auto u16s = entry.m_u16.data() + entry.Length + entry.LocaleLength;
+    CopyTo(dst.m_cluster_map + chars, u16s, entry.Length);
+    CopyTo(dst.m_text_props + chars, u16s += entry.Length, entry.Length);
+    CopyTo(dst.m_glyph_indices + glyphs, u16s += entry.Length, entry.GlyphCount);
+    CopyTo(dst.m_glyph_props + glyphs, u16s += entry.GlyphCount, entry.GlyphCount);
+    auto f32s = entry.m_f32.data();
+    CopyTo(dst.m_glyph_advances + glyphs, f32s, entry.GlyphCount);
+    CopyTo(dst.m_glyph_offsets + glyphs, f32s += entry.GlyphCount, entry.GlyphCount);
+    CopyTo(dst.m_cluster_widths + glyphs, f32s += 2 * entry.GlyphCount, entry.GlyphCount);
+    return static_cast<i32>(entry.GlyphCount);
+}
+
+void ShapeCache::Store(
+    const u64 hash, const std::span<const char16> text, const ShapeCacheKey& key,
+    const GlyphBuffer& src, const u32 char_start, const u32 glyph_start, const u32 glyph_count
+)
+{
+    const auto budget = m_budget.load(std::memory_order_relaxed) / ShardCount;
+    if (budget == 0 || text.size() > MaxRunLength) return;
+    if (char_start + text.size() > src.m_char_count || glyph_start + glyph_count > src.m_glyph_count)
+        throw Exception("Argument out of range");
+
+    // Built outside the lock, shaping the same run on two threads at once just stores it twice
+    const auto length = static_cast<u32>(text.size());
+    const auto locale_length = StrLength(key.Locale);
+    if (key.Font != nullptr) key.Font->AddRef();
+    Entry entry{
+        .Hash = hash,
+        .Font = Rc(key.Font),
+        .FontSize = key.FontSize,
+        .Script = key.Script,
+        .Features = key.Features,
+        .IsRtl = key.IsRtl,
+        .Length = length,
+        .LocaleLength = locale_length,
+        .GlyphCount = glyph_count,
+    };
+    entry.m_u16.resize(3 * length + locale_length + 2 * glyph_count);
+    entry.m_f32.resize(4 * glyph_count);
+    auto u16s = entry.m_u16.data();
+    CopyTo(u16s, text.data(), length);
+    CopyTo(u16s += length, key.Locale, locale_length);
+    CopyTo(u16s += locale_length, src.m_cluster_map + char_start, length);
+    CopyTo(u16s += length, src.m_text_props + char_start, length);
+    CopyTo(u16s += length, src.m_glyph_indices + glyph_start, glyph_count);
+    CopyTo(u16s += glyph_count, src.m_glyph_props + glyph_start, glyph_count);
+    auto f32s = entry.m_f32.data();
+    CopyTo(f32s, src.m_glyph_advances + glyph_start, glyph_count);
+    CopyTo(f32s += glyph_count, src.m_glyph_offsets + glyph_start, 2 * glyph_count);
+    CopyTo(f32s += 2 * glyph_count, src.m_cluster_widths + glyph_start, glyph_count);
+    const auto bytes = entry.Bytes();
+    if (bytes > budget) return;
+
+    auto& shard = ShardOf(hash);
+    std::lock_guard lock(shard.m_mutex);
+    auto r = shard.m_map.GetValueRefOrUninitializedValue(hash);
+    if (r.Exists())
+    {
+        const auto it = r.GetValue();
+        shard.m_bytes -= it->Bytes();
+        *it = std::move(entry);
+        shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it);
+    }
+    else
+    {
+        shard.m_lru.push_front(std::move(entry));
+        r.SetValue(shard.m_lru.begin());
+    }
+    shard.m_bytes += bytes;
+    Evict(shard, budget);
+}
+
+void ShapeCache::Evict(Shard& shard, const u64 budget)
+{
+    while (shard.m_bytes > budget && !shard.m_lru.empty())
+    {
+        const auto& entry = shard.m_lru.back();
+        shard.m_bytes -= entry.Bytes();
+        shard.m_map.Remove(entry.Hash);
+        shard.m_lru.pop_back();
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
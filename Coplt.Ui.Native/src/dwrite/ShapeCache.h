@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <span>
+#include <vector>
+#include <dwrite_3.h>
+
+#include "../Com.h"
+#include "../FlatMap.h"
+#include "GlyphBuffer.h"
+
+namespace Coplt::LayoutCalc::Texts
+{
+    // What the glyphs of a run depend on besides its text
+    struct ShapeCacheKey
+    {
+        IDWriteFontFace5* Font;
+        f32 FontSize;
+        DWRITE_SCRIPT_ANALYSIS Script;
+        const char16* Locale;
+        // Hash of the typographic features the run is shaped with
+        u64 Features;
+        bool IsRtl;
+    };
+
+    struct ShapeCacheStats
+    {
+        u64 Hits;
+        u64 Misses;
+        u64 Evictions;
+        // Bytes held by entries, kept under the budget
+        u64 Bytes;
+        u32 Entries;
+    };
+
+    // Shaping output of short runs shared by every text layout in the process, so labels repeated across many nodes
+    // ("OK", column headers, list items) are shaped once; least recently used entries are evicted once the bytes
+    // held exceed the budget. Thread safe, the entries are spread over shards each with its own lock and part of
+    // the budget, so parallel rebuilds rarely contend
+    struct ShapeCache
+    {
+        static constexpr u32 ShardCount = 16;
+        // Longer runs rarely repeat and would push out many short ones
+        static constexpr u32 MaxRunLength = 256;
+        static constexpr u64 DefaultBudget = 16 * 1024 * 1024;
+
+        struct Entry
+        {
+            u64 Hash;
+            Rc<IDWriteFontFace5> Font;
+            f32 FontSize;
+            DWRITE_SCRIPT_ANALYSIS Script;
+            u64 Features;
+            bool IsRtl;
+            u32 Length;
+            u32 LocaleLength;
+            u32 GlyphCount;
+            // Text, locale, cluster map and text props per char, glyph indices and props per glyph
+            std::vector<u16> m_u16;
+            // Advances, offsets and cluster widths per glyph
+            std::vector<f32> m_f32;
+
+            usize Bytes() const;
+            bool Matches(std::span<const char16> text, const ShapeCacheKey& key) const;
+        };
+
+        struct Shard
+        {
+            std::mutex m_mutex{};
+            // Most recently used first
+            std::list<Entry> m_lru{};
+            FlatMap<u64, std::list<Entry>::iterator> m_map{};
+            u64 m_bytes{};
+        };
+
+        Shard m_shards[ShardCount];
+        std::atomic<u64> m_budget{DefaultBudget};
+        std::atomic<u64> m_hits{};
+        std::atomic<u64> m_misses{};
+        std::atomic<u64> m_evictions{};
+
+        // Lives until process exit, like the shared thread pool
+        static ShapeCache& Shared();
+
+        // 0 disables the cache and drops every entry, a lower budget evicts right away
+        void SetBudget(u64 bytes);
+        ShapeCacheStats Stats();
+        void Clear();
+
+        bool Enabled() const { return m_budget.load(std::memory_order_relaxed) != 0; }
+
+        static u64 Hash(std::span<const char16> text, const ShapeCacheKey& key);
+        static u64 HashFeatures(std::span<const DWRITE_FONT_FEATURE> features);
+
+        // Appends the cached glyphs of the run to dst and returns the glyph count, or -1 if the run is not cached
+        i32 TryAppend(u64 hash, std::span<const char16> text, const ShapeCacheKey& key, GlyphBuffer& dst);
+        // Caches the run shaped into src at the given chars and glyphs, replaces an entry with the same hash
+        void Store(
+            u64 hash, std::span<const char16> text, const ShapeCacheKey& key,
+            const GlyphBuffer& src, u32 char_start, u32 glyph_start, u32 glyph_count
+        );
+
+    private:
+        Shard& ShardOf(u64 hash);
+        void Evict(Shard& shard, u64 budget);
+    };
+}
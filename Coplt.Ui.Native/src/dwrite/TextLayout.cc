@@ -2,13 +2,17 @@
 
 #include <span>
 #include <print>
+#include <algorithm>
+#include <fmt/xchar.h>
 
 #include <icu.h>
 
 #include "../Algorithm.h"
 #include "../Text.h"
 #include "../Layout.h"
+#include "../ThreadPool.h"
 #include "Layout.h"
+#include "ShapeCache.h"
 #include "Error.h"
 #include "BaseFontFallback.h"
 #include "Utils.h"
@@ -17,7 +21,19 @@
 using namespace Coplt::LayoutCalc::Texts;
 
 ParagraphData::ParagraphData(TextLayout* text_layout)
-    : m_text_layout(text_layout)
+    : m_text_layout(text_layout),
+      m_arena(std::make_unique<ArenaSlot>(&text_layout->m_arena)),
+      m_chars(m_arena.get()),
+      m_char_metas(m_arena.get()),
+      m_script_ranges(m_arena.get()),
+      m_bidi_ranges(m_arena.get()),
+      m_line_breakpoints(m_arena.get()),
+      m_font_ranges(m_arena.get()),
+      m_font_ranges_tmp(m_arena.get()),
+      m_same_style_ranges(m_arena.get()),
+      m_runs(m_arena.get()),
+      m_prev_runs(m_arena.get()),
+      m_break_index(m_arena.get())
 {
 }
 
@@ -26,10 +42,125 @@ const LoggerData& ParagraphData::Logger() const
     return m_layout->m_lib->m_logger;
 }
 
+namespace
+{
+    template <class T>
+    void ReleaseArenaVector(ArenaVector<T>& vec)
+    {
+        ArenaVector<T>(vec.get_allocator()).swap(vec);
+    }
+
+    // The features every run is shaped with until styles can choose them
+    constexpr DWRITE_FONT_FEATURE DefaultFontFeatures[] = {
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_REQUIRED_LIGATURES,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_CONTEXTUAL_ALTERNATES,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_STANDARD_LIGATURES,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_CONTEXTUAL_LIGATURES,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_LOCALIZED_FORMS,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_GLYPH_COMPOSITION_DECOMPOSITION,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_MARK_POSITIONING,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_MARK_TO_MARK_POSITIONING,
+            .parameter = 1,
+        },
+        DWRITE_FONT_FEATURE{
+            .nameTag = DWRITE_FONT_FEATURE_TAG_KERNING,
+            .parameter = 1,
+        },
+    };
+
+    u64 DefaultFontFeaturesHash()
+    {
+        static const auto s_hash = ShapeCache::HashFeatures(DefaultFontFeatures);
+        return s_hash;
+    }
+}
+
+BreakIndex::BreakIndex(std::pmr::memory_resource* arena)
+    : m_cluster_ends(arena),
+      m_cluster_chars(arena),
+      m_breaks(arena),
+      m_space_breaks(arena),
+      m_new_lines(arena),
+      m_next_events(arena)
+{
+}
+
+void BreakIndex::Release()
+{
+    ReleaseArenaVector(m_cluster_ends);
+    ReleaseArenaVector(m_cluster_chars);
+    ReleaseArenaVector(m_breaks);
+    ReleaseArenaVector(m_space_breaks);
+    ReleaseArenaVector(m_new_lines);
+    ReleaseArenaVector(m_next_events);
+}
+
+void ParagraphData::ReleaseScratch()
+{
+    ReleaseArenaVector(m_chars);
+    ReleaseArenaVector(m_char_metas);
+    ReleaseArenaVector(m_script_ranges);
+    ReleaseArenaVector(m_bidi_ranges);
+    ReleaseArenaVector(m_line_breakpoints);
+    ReleaseArenaVector(m_font_ranges);
+    ReleaseArenaVector(m_font_ranges_tmp);
+    ReleaseArenaVector(m_same_style_ranges);
+    ReleaseArenaVector(m_runs);
+    ReleaseArenaVector(m_prev_runs);
+    m_break_index.Release();
+    m_intrinsic_sizes = {};
+}
+
 void ParagraphData::ReBuild()
 {
     if (!m_src) m_src = Rc(new TextAnalysisSource(this));
     if (!m_sink) m_sink = Rc(new TextAnalysisSink(this));
+    // m_paragraph_datas may have reallocated since the last rebuild
+    m_src->m_paragraph_data = this;
+    m_sink->m_paragraph_data = this;
+
+    m_line_breakpoints.reserve(GetParagraph().LogicTextLength);
+    m_glyphs.Clear();
+
+    m_cache.Clear();
+    m_measure_cache.Clear();
+    m_final_spans.clear();
+    m_final_span_runs.clear();
+    m_final_lines.clear();
+    m_packed_lines.Clear();
+    m_line_count = 0;
+    m_lazy_lines = nullptr;
+}
+
+void ParagraphData::ReBuildEdited(const u32 start, const u32 old_length, const u32 new_length)
+{
+    // Keep the previous shaping around while the new one is built, swapping keeps both blocks across edits
+    std::swap(m_glyphs, m_prev_glyphs);
+    m_prev_runs.clear();
+    for (const auto& run : m_runs) m_prev_runs.push_back(GetShapedRunKey(run));
+
     m_chars.clear();
     m_char_metas.clear();
     m_script_ranges.clear();
@@ -40,16 +171,12 @@ void ParagraphData::ReBuild()
     m_same_style_ranges.clear();
     m_runs.clear();
 
-    m_cluster_map.clear();
-    m_text_props.clear();
-    m_glyph_indices.clear();
-    m_glyph_props.clear();
-    m_glyph_advances.clear();
-    m_glyph_offsets.clear();
-
-    m_cache.Clear();
-    m_final_spans.clear();
-    m_final_lines.clear();
+    ReBuild();
+    Analyze();
+    AnalyzeGlyphsEdited(start, start + new_length, start + old_length);
+    BuildBreakIndex();
+    ComputeIntrinsicSizes();
+    // AnalyzeGlyphsCarets();
 }
 
 std::vector<Paragraph>& ParagraphData::GetTextLayoutParagraphs() const
@@ -110,33 +237,113 @@ void TextLayout::ReBuild(Layout* layout, CtxNodeRef node)
 {
     m_node = node;
     m_layout = layout;
-    m_paragraph_datas.resize(m_paragraphs.size(), ParagraphData(this));
-    for (int i = 0; i < m_paragraphs.size(); ++i)
+    for (auto& data : m_paragraph_datas) data.ReleaseScratch();
+    m_arena.Reset();
+    for (const auto& arena : m_worker_arenas) arena->Reset();
+    if (m_paragraph_datas.size() > m_paragraphs.size())
+        m_paragraph_datas.erase(m_paragraph_datas.begin() + m_paragraphs.size(), m_paragraph_datas.end());
+    // Constructed in place, copies of a paragraph data would not be bound to the arena
+    while (m_paragraph_datas.size() < m_paragraphs.size()) m_paragraph_datas.emplace_back(this);
+
+    // Paragraphs only read the document and write their own data, so they can be built in any order on any thread;
+    // small documents are not worth waking up the pool
+    constexpr usize MinParallelParagraphs = 16;
+    const auto count = static_cast<i32>(m_paragraphs.size());
+    auto& pool = ThreadPool::Shared();
+    if (!layout->m_lib->m_parallel_text_layout || m_paragraphs.size() < MinParallelParagraphs || pool.Concurrency() < 2)
     {
-        auto& paragraph = m_paragraphs[i];
+        for (i32 i = 0; i < count; ++i) ReBuildParagraph(i, 0);
+    }
+    else
+    {
+        const auto workers = std::min(count, pool.Concurrency());
+        layout->EnsureWorkerTextAnalyzers(workers);
+        while (static_cast<i32>(m_worker_arenas.size()) + 1 < workers)
+            m_worker_arenas.push_back(std::make_unique<Arena>());
+        pool.ParallelForWorkers(count, [&](const i32 worker, const i32 i) { ReBuildParagraph(i, worker); });
+    }
+
+    m_arena_used_after_rebuild = ArenaUsed();
+    m_node = {};
+}
+
+void TextLayout::ReBuildParagraph(const u32 index, const i32 worker)
+{
+    const auto& paragraph = m_paragraphs[index];
+    if (paragraph.Type == TextParagraphType::Block) return;
+    auto& data = m_paragraph_datas[index];
+    data.m_index = index;
+    data.m_layout = m_layout;
+    data.m_analyzer = m_layout->WorkerTextAnalyzer(worker);
+    // Its vectors were released above, so they can move to this worker's arena
+    data.m_arena->m_arena = &WorkerArena(worker);
+    data.ReBuild();
+    data.Analyze();
+    data.AnalyzeGlyphsFirst();
+    data.BuildBreakIndex();
+    data.ComputeIntrinsicSizes();
+    // data.AnalyzeGlyphsCarets();
+}
+
+Arena& TextLayout::WorkerArena(const i32 worker)
+{
+    if (worker == 0) return m_arena;
+    return *m_worker_arenas[worker - 1];
+}
+
+usize TextLayout::ArenaUsed() const
+{
+    auto used = m_arena.Used();
+    for (const auto& arena : m_worker_arenas) used += arena->Used();
+    return used;
+}
+
+void TextLayout::ReBuild(Layout* layout, CtxNodeRef node, const std::span<const TextEdit> edits)
+{
+    // Untouched paragraphs keep their analysis, so the arena can not be reset; an edit that grows a paragraph
+    // leaves its old vectors behind, and a full rebuild compacts them once they add up
+    if (
+        layout != m_layout || m_paragraph_datas.size() != m_paragraphs.size()
+        || ArenaUsed() > 2 * m_arena_used_after_rebuild + Arena::MinChunkSize
+    )
+    {
+        ReBuild(layout, node);
+        return;
+    }
+
+    // One range per paragraph covering all of its edits, in the coordinates of its previous text
+    SmallList<TextEdit, 4> merged{};
+    for (const auto& edit : edits)
+    {
+        if (edit.Paragraph >= m_paragraphs.size())
+        {
+            ReBuild(layout, node);
+            return;
+        }
+        const auto it = std::ranges::find(merged, edit.Paragraph, &TextEdit::Paragraph);
+        if (it == merged.end())
+        {
+            merged.Add(edit);
+            continue;
+        }
+        const auto start = std::min(it->Start, edit.Start);
+        const auto old_end = std::max(it->Start + it->OldLength, edit.Start + edit.OldLength);
+        const auto growth = static_cast<i64>(it->NewLength) - it->OldLength + edit.NewLength - edit.OldLength;
+        it->Start = start;
+        it->OldLength = old_end - start;
+        it->NewLength = static_cast<u32>(it->OldLength + growth);
+    }
+
+    m_node = node;
+    for (const auto& edit : merged)
+    {
+        const auto& paragraph = m_paragraphs[edit.Paragraph];
         if (paragraph.Type == TextParagraphType::Block) continue;
-        auto& data = m_paragraph_datas[i];
-        data.m_index = i;
+        auto& data = m_paragraph_datas[edit.Paragraph];
+        data.m_index = edit.Paragraph;
         data.m_layout = layout;
-        data.ReBuild();
-        // data.CollectChars();
-        if (const auto hr = layout->m_text_analyzer->AnalyzeScript(
-            data.m_src.get(), 0, paragraph.LogicTextLength, data.m_sink.get()
-        ); FAILED(hr))
-            throw ComException(hr, "Failed to analyze script");
-        if (const auto hr = layout->m_text_analyzer->AnalyzeBidi(
-            data.m_src.get(), 0, paragraph.LogicTextLength, data.m_sink.get()
-        ); FAILED(hr))
-            throw ComException(hr, "Failed to analyze bidi");
-        if (const auto hr = layout->m_text_analyzer->AnalyzeLineBreakpoints(
-            data.m_src.get(), 0, paragraph.LogicTextLength, data.m_sink.get()
-        ); FAILED(hr))
-            throw ComException(hr, "Failed to analyze LineBreakpoints");
-        data.AnalyzeFonts();
-        data.AnalyzeStyles();
-        data.CollectRuns();
-        data.AnalyzeGlyphsFirst();
-        // data.AnalyzeGlyphsCarets();
+        data.m_analyzer = layout->m_text_analyzer.get();
+        data.ReBuildEdited(edit.Start, edit.OldLength, edit.NewLength);
     }
     m_node = {};
 }
@@ -563,155 +770,215 @@ void ParagraphData::CollectRuns()
     }
 }
 
+void ParagraphData::Analyze()
+{
+    const auto& paragraph = GetParagraph();
+    const auto analyzer = m_analyzer;
+    // CollectChars();
+    if (const auto hr = analyzer->AnalyzeScript(m_src.get(), 0, paragraph.LogicTextLength, m_sink.get()); FAILED(hr))
+        throw ComException(hr, "Failed to analyze script");
+    if (const auto hr = analyzer->AnalyzeBidi(m_src.get(), 0, paragraph.LogicTextLength, m_sink.get()); FAILED(hr))
+        throw ComException(hr, "Failed to analyze bidi");
+    if (const auto hr = analyzer->AnalyzeLineBreakpoints(
+        m_src.get(), 0, paragraph.LogicTextLength, m_sink.get()
+    ); FAILED(hr))
+        throw ComException(hr, "Failed to analyze LineBreakpoints");
+    AnalyzeFonts();
+    AnalyzeStyles();
+    CollectRuns();
+}
+
 void ParagraphData::AnalyzeGlyphsFirst()
 {
-    // std::vector<u16> cluster_map;
-    // std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> text_props;
-    // std::vector<u16> glyph_indices;
-    // std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> glyph_props;
+    for (auto& run : m_runs) ShapeRun(run);
+}
+
+void ParagraphData::AnalyzeGlyphsEdited(const u32 start, const u32 end, const u32 old_end)
+{
+    u32 reused = 0;
+    for (auto& run : m_runs)
+    {
+        // Runs are shaped independently, so a run with the same text and the same key as a previous one has the
+        // same glyphs; runs overlapping the new chars are always shaped again
+        if (run.Start + run.Length <= start || run.Start >= end)
+        {
+            auto key = GetShapedRunKey(run);
+            if (run.Start >= end) key.Start = run.Start - end + old_end;
+            const auto prev = std::ranges::lower_bound(m_prev_runs, key.Start, {}, &ShapedRunKey::Start);
+            if (prev != m_prev_runs.end() && prev->Start == key.Start && !key.IsInlineBlock && prev->SameShaping(key))
+            {
+                run.ClusterStartIndex = m_glyphs.CharCount();
+                run.GlyphStartIndex = m_glyphs.GlyphCount();
+                run.ActualGlyphCount = prev->ActualGlyphCount;
+                m_glyphs.AppendFrom(
+                    m_prev_glyphs, prev->ClusterStartIndex, prev->Length, prev->GlyphStartIndex, prev->ActualGlyphCount
+                );
+                reused++;
+                continue;
+            }
+        }
+        ShapeRun(run);
+    }
+    Logger().Log(
+        LogLevel::Debug, [&]
+        {
+            return fmt::format(L"paragraph {} edited, reused {} of {} runs", m_index, reused, m_runs.size());
+        }
+    );
+}
+
+ShapedRunKey ParagraphData::GetShapedRunKey(const Run& run) const
+{
+    const auto& script = m_script_ranges[run.ScriptRangeIndex];
+    const auto& font = m_font_ranges[run.FontRangeIndex];
+    return ShapedRunKey{
+        .Start = run.Start,
+        .Length = run.Length,
+        .ClusterStartIndex = run.ClusterStartIndex,
+        .GlyphStartIndex = run.GlyphStartIndex,
+        .ActualGlyphCount = run.ActualGlyphCount,
+        .Script = script.Analysis,
+        .Locale = script.Locale,
+        // .Font = font.Font.get(),
+        .FirstScope = m_same_style_ranges[run.StyleRangeIndex].FirstScope,
+        .BidiLevel = m_bidi_ranges[run.BidiRangeIndex].ResolvedLevel,
+        .IsInlineBlock = font.IsInlineBlock,
+    };
+}
+
+bool ShapedRunKey::SameShaping(const ShapedRunKey& other) const
+{
+    return Length == other.Length
+        && Script.script == other.Script.script && Script.shapes == other.Script.shapes
+        && Locale == other.Locale
+        // && Font == other.Font
+        && FirstScope == other.FirstScope
+        && BidiLevel == other.BidiLevel
+        && IsInlineBlock == other.IsInlineBlock;
+}
+
+void ParagraphData::ShapeRun(Run& run)
+{
+    // auto& analyzer = m_analyzer;
+    const auto& script = m_script_ranges[run.ScriptRangeIndex];
+    const auto& bidi = m_bidi_ranges[run.BidiRangeIndex];
+    const auto& font = m_font_ranges[run.FontRangeIndex];
+    const auto& same_style = m_same_style_ranges[run.StyleRangeIndex];
+
+    // COPLT_DEBUG_ASSERT(font.IsInlineBlock ? !font.Font : true, "inline block definitely no font");
+    // if (!font.Font) return; // skip if no font find
+
+    const auto scope = GetScope(same_style);
+    const auto& style = scope.StyleData();
+
+    const auto is_rtl = bidi.ResolvedLevel % 2 == 1;
+    // const auto locale = style.LocaleMode == LocaleMode::ByScript ? script.Locale : style.Locale.Name;
+    const auto locale = script.Locale;
+
+    // todo features from style
+    // DWRITE_TYPOGRAPHIC_FEATURES typ_features[] = {
+    //     DWRITE_TYPOGRAPHIC_FEATURES{
+    //         .features = const_cast<DWRITE_FONT_FEATURE*>(DefaultFontFeatures),
+    //         .featureCount = std::size(DefaultFontFeatures)
+    //     },
+    // };
+    // const DWRITE_TYPOGRAPHIC_FEATURES* arg_features = typ_features;
+    // const u32 feature_range_length = run.Length;
+
+    // A run with the same text and key has the same glyphs in any layout; no font means nothing gets shaped
+    auto& shape_cache = ShapeCache::Shared();
+    const std::span chars(m_chars.data() + run.Start, run.Length);
+    const ShapeCacheKey cache_key{
+        // .Font = font.Font->m_face.get(),
+        .FontSize = style.FontSize,
+        .Script = script.Analysis,
+        .Locale = locale,
+        .Features = DefaultFontFeaturesHash(),
+        .IsRtl = is_rtl,
+    };
+    const auto cacheable = cache_key.Font != nullptr && shape_cache.Enabled() && run.Length <= ShapeCache::MaxRunLength;
+    const auto cache_hash = cacheable ? ShapeCache::Hash(chars, cache_key) : 0;
+    if (cacheable)
+    {
+        const auto char_start = m_glyphs.CharCount();
+        const auto glyph_start = m_glyphs.GlyphCount();
+        if (const auto glyph_count = shape_cache.TryAppend(cache_hash, chars, cache_key, m_glyphs); glyph_count >= 0)
+        {
+            run.ClusterStartIndex = char_start;
+            run.GlyphStartIndex = glyph_start;
+            run.ActualGlyphCount = static_cast<u32>(glyph_count);
+            return;
+        }
+    }
+
+    // const auto text = m_chars.data() + run.Start;
     //
-    // auto& analyzer = m_layout->m_text_analyzer;
-    // const auto& items = m_text_layout->m_items;
-    // auto item_index = 0;
-    // for (auto& run : m_runs)
+    // HRESULT hr{};
+    // u32 actual_glyph_count{};
+    // auto buf_size = 3 * run.Length / 2 + 16;
+    // run.ClusterStartIndex = m_glyphs.AddChars(run.Length);
+    // run.GlyphStartIndex = m_glyphs.GlyphCount();
+    // for (;;)
     // {
-    //     const auto& script = m_script_ranges[run.ScriptRangeIndex];
-    //     const auto& bidi = m_bidi_ranges[run.BidiRangeIndex];
-    //     const auto& font = m_font_ranges[run.FontRangeIndex];
-    //     const auto& same_style = m_same_style_ranges[run.StyleRangeIndex];
-    //
-    //     COPLT_DEBUG_ASSERT(font.IsInlineBlock ? !font.Font : true, "inline block definitely no font");
-    //     if (!font.Font) continue; // skip if no font find
-    //
-    //     const auto scope = GetScope(same_style);
-    //     const auto& style = scope.StyleData();
-    //
-    //     const auto is_rtl = bidi.ResolvedLevel % 2 == 1;
-    //     const auto locale = style.LocaleMode == LocaleMode::ByScript ? script.Locale : style.Locale.Name;
-    //
-    //     // todo features from style
-    //     DWRITE_FONT_FEATURE features[] = {
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_REQUIRED_LIGATURES,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_CONTEXTUAL_ALTERNATES,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_STANDARD_LIGATURES,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_CONTEXTUAL_LIGATURES,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_LOCALIZED_FORMS,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_GLYPH_COMPOSITION_DECOMPOSITION,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_MARK_POSITIONING,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_MARK_TO_MARK_POSITIONING,
-    //             .parameter = 1,
-    //         },
-    //         DWRITE_FONT_FEATURE{
-    //             .nameTag = DWRITE_FONT_FEATURE_TAG_KERNING,
-    //             .parameter = 1,
-    //         },
-    //     };
-    //     DWRITE_TYPOGRAPHIC_FEATURES typ_features[] = {
-    //         DWRITE_TYPOGRAPHIC_FEATURES{
-    //             .features = features,
-    //             .featureCount = std::size(features)
-    //         },
-    //     };
-    //     const DWRITE_TYPOGRAPHIC_FEATURES* arg_features = typ_features;
-    //     const u32 feature_range_length = run.Length;
-    //
-    //     const auto text = m_chars.data() + run.Start;
-    //
-    //     HRESULT hr{};
-    //     u32 actual_glyph_count{};
-    //     auto buf_size = 3 * run.Length / 2 + 16;
-    //     for (;;)
-    //     {
-    //         if (cluster_map.size() < run.Length)
-    //         {
-    //             cluster_map.resize(run.Length, {});
-    //             text_props.resize(run.Length, {});
-    //         }
-    //         if (glyph_indices.size() < buf_size)
-    //         {
-    //             glyph_indices.resize(buf_size, {});
-    //             glyph_props.resize(buf_size, {});
-    //         }
-    //         hr = analyzer->GetGlyphs(
-    //             text,
-    //             run.Length,
-    //             font.Font->m_face.get(),
-    //             false, // sideways
-    //             is_rtl,
-    //             &script.Analysis,
-    //             locale,
-    //             nullptr, // todo number subsitiution
-    //             &arg_features,
-    //             &feature_range_length,
-    //             1,
-    //             glyph_indices.size(),
-    //             cluster_map.data(),
-    //             text_props.data(),
-    //             glyph_indices.data(),
-    //             glyph_props.data(),
-    //             &actual_glyph_count
-    //         );
-    //         if (hr != ERROR_INSUFFICIENT_BUFFER) break;
-    //         buf_size *= 2;
-    //     }
-    //     if (FAILED(hr)) throw ComException(hr, "Failed to get glyphs");
-    //
-    //     run.ClusterStartIndex = m_cluster_map.size();
-    //     run.GlyphStartIndex = m_glyph_indices.size();
-    //     run.ActualGlyphCount = actual_glyph_count;
-    //
-    //     m_cluster_map.insert(m_cluster_map.end(), cluster_map.data(), cluster_map.data() + run.Length);
-    //     m_text_props.insert(m_text_props.end(), text_props.data(), text_props.data() + run.Length);
-    //     m_glyph_indices.insert(m_glyph_indices.end(), glyph_indices.data(), glyph_indices.data() + actual_glyph_count);
-    //     m_glyph_props.insert(m_glyph_props.end(), glyph_props.data(), glyph_props.data() + actual_glyph_count);
-    //
-    //     m_glyph_advances.resize(m_glyph_advances.size() + actual_glyph_count, {});
-    //     m_glyph_offsets.resize(m_glyph_offsets.size() + actual_glyph_count, {});
-    //
-    //     hr = analyzer->GetGlyphPlacements(
+    //     // shape straight into the tail of the buffer
+    //     m_glyphs.AddGlyphs(buf_size);
+    //     hr = analyzer->GetGlyphs(
     //         text,
-    //         cluster_map.data(),
-    //         text_props.data(),
     //         run.Length,
-    //         glyph_indices.data(),
-    //         glyph_props.data(),
-    //         actual_glyph_count,
     //         font.Font->m_face.get(),
-    //         style.FontSize,
     //         false, // sideways
     //         is_rtl,
     //         &script.Analysis,
     //         locale,
+    //         nullptr, // todo number subsitiution
     //         &arg_features,
     //         &feature_range_length,
     //         1,
-    //         m_glyph_advances.data() + run.GlyphStartIndex,
-    //         m_glyph_offsets.data() + run.GlyphStartIndex
+    //         buf_size,
+    //         m_glyphs.m_cluster_map + run.ClusterStartIndex,
+    //         m_glyphs.m_text_props + run.ClusterStartIndex,
+    //         m_glyphs.m_glyph_indices + run.GlyphStartIndex,
+    //         m_glyphs.m_glyph_props + run.GlyphStartIndex,
+    //         &actual_glyph_count
     //     );
-    //     if (FAILED(hr)) throw ComException(hr, "Failed to get glyphs");
+    //     m_glyphs.PopGlyphs(buf_size);
+    //     if (hr != ERROR_INSUFFICIENT_BUFFER) break;
+    //     buf_size *= 2;
     // }
+    // if (FAILED(hr)) throw ComException(hr, "Failed to get glyphs");
+    //
+    // run.ActualGlyphCount = actual_glyph_count;
+    // m_glyphs.AddGlyphs(actual_glyph_count);
+    //
+    // hr = analyzer->GetGlyphPlacements(
+    //     text,
+    //     m_glyphs.m_cluster_map + run.ClusterStartIndex,
+    //     m_glyphs.m_text_props + run.ClusterStartIndex,
+    //     run.Length,
+    //     m_glyphs.m_glyph_indices + run.GlyphStartIndex,
+    //     m_glyphs.m_glyph_props + run.GlyphStartIndex,
+    //     actual_glyph_count,
+    //     font.Font->m_face.get(),
+    //     style.FontSize,
+    //     false, // sideways
+    //     is_rtl,
+    //     &script.Analysis,
+    //     locale,
+    //     &arg_features,
+    //     &feature_range_length,
+    //     1,
+    //     m_glyphs.m_glyph_advances + run.GlyphStartIndex,
+    //     m_glyphs.m_glyph_offsets + run.GlyphStartIndex
+    // );
+    // if (FAILED(hr)) throw ComException(hr, "Failed to get glyphs");
+
+    m_glyphs.ComputeClusterWidths(run.GlyphStartIndex, run.ActualGlyphCount);
+    if (cacheable)
+    {
+        shape_cache.Store(
+            cache_hash, chars, cache_key, m_glyphs, run.ClusterStartIndex, run.GlyphStartIndex, run.ActualGlyphCount
+        );
+    }
 }
 
 // void ParagraphData::AnalyzeGlyphsCarets()
@@ -751,8 +1018,8 @@ void ParagraphData::AnalyzeGlyphsFirst()
 //             hb_font = value.Font;
 //         };
 //
-//         const std::span cluster_map{m_cluster_map.data() + run.ClusterStartIndex, run.Length};
-//         const std::span glyph_indices{m_glyph_indices.data() + run.GlyphStartIndex, run.ActualGlyphCount};
+//         const std::span cluster_map{m_glyphs.m_cluster_map + run.ClusterStartIndex, run.Length};
+//         const std::span glyph_indices{m_glyphs.m_glyph_indices + run.GlyphStartIndex, run.ActualGlyphCount};
 //
 //         std::vector<hb_position_t> caret_buf{};
 //
@@ -988,7 +1255,7 @@ HRESULT TextAnalysisSink::SetScriptAnalysis(
 )
 {
     DWRITE_SCRIPT_PROPERTIES properties{};
-    if (const auto hr = m_paragraph_data->m_layout->m_text_analyzer->GetScriptProperties(*scriptAnalysis, &properties);
+    if (const auto hr = m_paragraph_data->m_analyzer->GetScriptProperties(*scriptAnalysis, &properties);
         FAILED(hr))
         throw ComException(hr, "Failed to get script properties");
 
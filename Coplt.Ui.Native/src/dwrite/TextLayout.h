@@ -1,14 +1,20 @@
 ﻿#pragma once
 
 #include <span>
-#include <generator>
+#include <limits>
+#include <optional>
 #include <icu.h>
 #include <dwrite_3.h>
 
 #include "../Com.h"
+#include "../Arena.h"
+#include "../RingBuffer.h"
 #include "../TextLayout.h"
 #include "../Layout.h"
+#include "../PackedLines.h"
 #include "../Utils.h"
+#include "FontMetricsCache.h"
+#include "GlyphBuffer.h"
 
 namespace Coplt
 {
@@ -24,36 +30,6 @@ namespace Coplt::LayoutCalc::Texts
 {
     struct ParagraphData;
 
-    struct TextLayoutCache_Final : CacheEntryBase
-    {
-        LayoutOutput Output;
-        // todo other data
-    };
-
-    struct TextLayoutCache_Measure : CacheEntryBase
-    {
-        f32 Width;
-        f32 Height;
-
-        Size<f32> Size() const
-        {
-            return {.Width = Width, .Height = Height};
-        }
-    };
-
-    struct TextLayoutCache
-    {
-        TextLayoutCache_Final Final;
-        TextLayoutCache_Measure Measure[9];
-        LayoutCacheFlags Flags;
-
-        std::optional<LayoutOutput> GetOutput(const LayoutInputs& inputs);
-
-        void StoreFinal(const LayoutInputs& inputs, LayoutOutput output);
-        void StoreMeasure(const LayoutInputs& inputs, f32 width, f32 height);
-        void Clear();
-    };
-
     // ReSharper disable once CppPolymorphicClassWithNonVirtualPublicDestructor
     struct OneSpaceTextAnalysisSource final : IDWriteTextAnalysisSource1, RefCount<OneSpaceTextAnalysisSource>
     {
@@ -143,11 +119,29 @@ namespace Coplt::LayoutCalc::Texts
         CtxNodeRef m_node{};
         Layout* m_layout{}; // todo:  init when ctor
 
+        // Backs the analysis vectors of every paragraph, reset at the start of each rebuild
+        Arena m_arena{};
         std::vector<ParagraphData> m_paragraph_datas{};
+        // Arenas of workers 1.. of a parallel rebuild, worker 0 is the calling thread and uses m_arena
+        std::vector<std::unique_ptr<Arena>> m_worker_arenas{};
+        // Arena usage right after the last full rebuild, incremental rebuilds fall back to a full one
+        // once the arena has grown far past it
+        usize m_arena_used_after_rebuild{};
 
         // Rc<DWriteFontFace> m_fallback_undef_font{};
         Rc<OneSpaceTextAnalysisSource> m_one_space_analysis_source{};
+        // Set while the layout is scrolled, paragraphs then only break the lines around it; lines already broken
+        // are kept as the viewport moves
+        std::optional<TextViewport> m_viewport{};
+
         void ReBuild(Layout* layout, CtxNodeRef node);
+        // Only re-analyses the paragraphs touched by edits, other paragraphs keep their analysis and shaping;
+        // style or paragraph structure changes still need the full ReBuild
+        void ReBuild(Layout* layout, CtxNodeRef node, std::span<const TextEdit> edits);
+        // Analyses and shapes one paragraph with the analyzer and arena of the given worker
+        void ReBuildParagraph(u32 index, i32 worker);
+        Arena& WorkerArena(i32 worker);
+        usize ArenaUsed() const;
 
         COPLT_IMPL_START
         COPLT_IMPL_END
@@ -156,6 +150,9 @@ namespace Coplt::LayoutCalc::Texts
 
         void Compute(void* sub_doc, LayoutOutput& out, const LayoutInputs& inputs, CtxNodeRef node);
         LayoutOutput Compute(void* sub_doc, const LayoutInputs& inputs);
+
+        // Null lays out every line again
+        void SetViewport(const TextViewport* viewport);
     };
 
     // ReSharper disable once CppPolymorphicClassWithNonVirtualPublicDestructor
@@ -260,11 +257,130 @@ namespace Coplt::LayoutCalc::Texts
 
     struct RunBreakLineIter;
 
+    // Cluster steps of every run, in the order Run::BreakLines walks them, and the ones it may break after;
+    // built once per shaping so intrinsic sizing never walks the clusters again, see ParagraphData::ComputeIntrinsicSizes,
+    // and so breaking at a definite width can jump between the clusters where something happens
+    struct BreakIndex
+    {
+        // Advance from the start of the run to the end of each cluster, summed in double so long runs keep precision
+        ArenaVector<double> m_cluster_ends;
+        // First char of each cluster, relative to the run
+        ArenaVector<u32> m_cluster_chars;
+        // Clusters with a CAN_BREAK or MUST_BREAK after them
+        ArenaVector<u32> m_breaks;
+        // m_breaks plus the clusters starting with a space, used with WrapFlags::WrapInSpace
+        ArenaVector<u32> m_space_breaks;
+        // Clusters starting with a LF
+        ArenaVector<u32> m_new_lines;
+        // For each cluster, the first one from it on that BreakLines has to look at whatever the width: one that may
+        // change the span type (its first char is a space, a LF or CR, or none of them, unlike the cluster before),
+        // one in m_space_breaks or m_new_lines, or the last of the run; relative to the run
+        ArenaVector<u32> m_next_events;
+
+        explicit BreakIndex(std::pmr::memory_resource* arena);
+
+        void Release();
+    };
+
+    // Content size of a paragraph at min-content, taking every break opportunity, and at max-content, only breaking
+    // at new lines; both come from the break index in one pass, so intrinsic sizing never has to break lines
+    struct ParagraphIntrinsicSizes
+    {
+        // Longest unbreakable segment
+        f32 MinContentMain{};
+        f32 MinContentCross{};
+        u32 MinContentLines{};
+        // Longest hard line
+        f32 MaxContentMain{};
+        f32 MaxContentCross{};
+        u32 MaxContentLines{};
+        // Not filled for block paragraphs or paragraphs with inline blocks, those are always laid out
+        bool Valid{};
+    };
+
+    // A run of the previous build with what its shaping depends on besides its text,
+    // a new run with the same text and key copies its glyphs instead of being shaped again
+    struct ShapedRunKey
+    {
+        u32 Start;
+        u32 Length;
+        u32 ClusterStartIndex;
+        u32 GlyphStartIndex;
+        u32 ActualGlyphCount;
+
+        DWRITE_SCRIPT_ANALYSIS Script;
+        const char16* Locale;
+        // DWriteFontFace* Font;
+        u32 FirstScope;
+        u8 BidiLevel;
+        bool IsInlineBlock;
+
+        bool SameShaping(const ShapedRunKey& other) const;
+    };
+
     struct RunBreakLineCtx
     {
         u32 NthLine{};
         f32 CurrentLineOffset{};
         f32 AvailableSpace{};
+        // Heap allocations made by BreakLines, growing the span buffer or spilling the sub span ring;
+        // stays 0 once the buffer has been warmed up by an earlier layout
+        u32 HeapAllocations{};
+        // BreakLines returns before starting this line, see RunBreakLineState
+        u32 StopLine{std::numeric_limits<u32>::max()};
+        // Skip the clusters that only add their advance with ParagraphData::m_break_index, a binary search on the
+        // cluster ends finds where the line overflows; needs a definite AvailableSpace to pay off
+        bool UseBreakIndex{};
+    };
+
+    namespace Compute
+    {
+        struct Cursor
+        {
+            i32 Char;
+            f32 Offset;
+
+            COPLT_FORCE_INLINE
+            Cursor() = default;
+
+            COPLT_FORCE_INLINE
+            explicit Cursor(const i32 c, const f32 o)
+                : Char(c), Offset(o)
+            {
+            }
+        };
+    }
+
+    // Where Run::BreakLines stopped inside a wrapping run when it reached RunBreakLineCtx::StopLine, the next call
+    // with the same state continues from there and emits exactly the spans a single call would have
+    struct RunBreakLineState
+    {
+        struct SubSpan
+        {
+            i32 EndChar; // not include
+            f32 Size;
+            ParagraphSpanType Type;
+        };
+
+        bool Started{};
+        i32 Char{};
+        // Cluster of Char in the break index, relative to the run
+        u32 Cluster{};
+        u32 NthLine{};
+        f32 CurrentOffset{};
+        f32 LastSubSpanOffset{};
+        Compute::Cursor SpanStart{};
+        std::optional<Compute::Cursor> BreakAfter{};
+        ParagraphSpanType LastType{};
+        bool SubSpanPending{};
+        RingBuffer<SubSpan, 16> SubSpans{};
+
+        // Makes the next BreakLines call start its run from the beginning
+        void Reset()
+        {
+            Started = false;
+            SubSpans.Clear();
+        }
     };
 
     struct Run
@@ -283,6 +399,12 @@ namespace Coplt::LayoutCalc::Texts
         bool HasLineInfo;
         ParagraphLineInfo LineInfo;
 
+        // Clusters of this run in ParagraphData::m_break_index
+        u32 BreakClusterStart;
+        u32 BreakClusterCount;
+        // No cluster has a negative width, so the cluster ends can be binary searched
+        bool BreakClusterEndsSorted;
+
         std::span<const char16> Chars(const ParagraphData& data) const;
         std::span<const CharMeta> CharMetas(const ParagraphData& data) const;
         std::span<const DWRITE_LINE_BREAKPOINT> LineBreakpoints(const ParagraphData& data) const;
@@ -292,18 +414,51 @@ namespace Coplt::LayoutCalc::Texts
         std::span<const DWRITE_SHAPING_GLYPH_PROPERTIES> GlyphProps(const ParagraphData& data) const;
         std::span<const f32> GlyphAdvances(const ParagraphData& data) const;
         std::span<const DWRITE_GLYPH_OFFSET> GlyphOffsets(const ParagraphData& data) const;
+        std::span<const f32> ClusterWidths(const ParagraphData& data) const;
 
         bool IsInlineBlock(const ParagraphData& data) const;
-        const ParagraphLineInfo& GetLineInfo(const ParagraphData& data);
-        #ifdef _DEBUG
-        std::vector<ParagraphSpan> BreakLines(
-            const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info
+        const ParagraphLineInfo& GetLineInfo(const ParagraphData& data, FontMetricsCache& metrics);
+        // Appends the spans of this run to spans, the caller keeps the buffer across layouts so its capacity is reused
+        void BreakLines(
+            const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info,
+            std::vector<ParagraphSpan>& spans
         ) const;
-        #else
-        std::generator<ParagraphSpan> BreakLines(
-            const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info
+        // Returns false if it stopped at ctx.StopLine, the run is then continued by calling again with the same state
+        bool BreakLines(
+            const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info,
+            std::vector<ParagraphSpan>& spans, RunBreakLineState& state
         ) const;
-        #endif
+    };
+
+    // The part of a text layout on screen along the cross axis (y for horizontal text), in content coordinates
+    struct TextViewport
+    {
+        f32 Start;
+        f32 Length;
+        // Lines are broken this far past the end of the viewport, so small scrolls need no layout
+        f32 Margin;
+    };
+
+    // Lines of a paragraph laid out for a viewport, broken so far into m_final_spans and m_final_lines, or packed into
+    // m_packed_lines once placed; the next layout continues from here if the main axis space did not change
+    struct LazyLines
+    {
+        f32 SpaceMain{};
+        // Next run to break, m_runs.size() once every line is broken
+        u32 Run{};
+        bool RunStarted{};
+        // First span of the run in m_final_spans, 0 if the run started in a packed line
+        u32 RunSpanStart{};
+        RunBreakLineCtx Ctx{};
+        RunBreakLineState State{};
+        ParagraphLine CurLine{};
+        u32 CurNthLine{};
+        f32 DefinedLineHeight{};
+        f32 MaxMain{};
+        // Cross size of the closed lines
+        f32 SumCross{};
+        // Chars of the closed lines
+        u32 ClosedChars{};
     };
 
     struct ParagraphData
@@ -319,29 +474,51 @@ namespace Coplt::LayoutCalc::Texts
 
         Rc<TextAnalysisSource> m_src{};
         Rc<TextAnalysisSink> m_sink{};
-
-        std::vector<char16> m_chars{};
-        std::vector<CharMeta> m_char_metas{};
-        std::vector<ScriptRange> m_script_ranges{};
-        std::vector<BidiRange> m_bidi_ranges{};
-        std::vector<DWRITE_LINE_BREAKPOINT> m_line_breakpoints{};
-        std::vector<FontRange> m_font_ranges{};
-        std::vector<FontRange> m_font_ranges_tmp{};
-        std::vector<SameStyleRange> m_same_style_ranges{};
-        std::vector<Run> m_runs{};
-
-        std::vector<u16> m_cluster_map{};
-        std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> m_text_props{};
-        std::vector<u16> m_glyph_indices{};
-        std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> m_glyph_props{};
-        std::vector<f32> m_glyph_advances{};
-        std::vector<DWRITE_GLYPH_OFFSET> m_glyph_offsets{};
+        // Analyzer of the thread building this paragraph
+        IDWriteTextAnalyzer1* m_analyzer{};
+
+        // Every arena vector below allocates through it, it points at the arena of the thread building this paragraph;
+        // boxed so the vectors keep a stable resource when m_paragraph_datas reallocates
+        std::unique_ptr<ArenaSlot> m_arena;
+        ArenaVector<char16> m_chars;
+        ArenaVector<CharMeta> m_char_metas;
+        ArenaVector<ScriptRange> m_script_ranges;
+        ArenaVector<BidiRange> m_bidi_ranges;
+        ArenaVector<DWRITE_LINE_BREAKPOINT> m_line_breakpoints;
+        ArenaVector<FontRange> m_font_ranges;
+        ArenaVector<FontRange> m_font_ranges_tmp;
+        ArenaVector<SameStyleRange> m_same_style_ranges;
+        ArenaVector<Run> m_runs;
+
+        // Outlives rebuilds, its block is reused instead of coming from the arena
+        GlyphBuffer m_glyphs{};
+        // Shaping of the previous build during an incremental rebuild, untouched runs are copied from it
+        GlyphBuffer m_prev_glyphs{};
+        ArenaVector<ShapedRunKey> m_prev_runs;
+        BreakIndex m_break_index;
+        ParagraphIntrinsicSizes m_intrinsic_sizes{};
 
         TextLayoutCache m_cache{};
+        TextMeasureCache m_measure_cache{};
         std::vector<ParagraphSpan> m_final_spans{};
+        // Run of every span in m_final_spans
+        std::vector<u32> m_final_span_runs{};
         std::vector<ParagraphLine> m_final_lines{};
-
+        // Lines placed by a layout and their spans, they never change again so they are kept in half the memory;
+        // m_final_spans and m_final_lines only hold the lines not placed yet and the spans of the open line
+        PackedLines m_packed_lines{};
+        // Lines of the last ComputeContent, or of the measure cache entry that replaced it
+        u32 m_line_count{};
+        // RunBreakLineCtx::HeapAllocations of the last layout
+        u32 m_break_line_allocations{};
+        // Set while the final lines come from a viewport layout, boxed since the sub span ring cannot move
+        std::unique_ptr<LazyLines> m_lazy_lines{};
+
+        // Drops everything allocated from the text layout arena, must run before the arena is reset
+        void ReleaseScratch();
         void ReBuild();
+        // Chars [Start, Start + OldLength) of the previous text are now [Start, Start + NewLength)
+        void ReBuildEdited(u32 start, u32 old_length, u32 new_length);
 
         std::vector<Paragraph>& GetTextLayoutParagraphs() const;
         Paragraph& GetParagraph() const;
@@ -357,12 +534,30 @@ namespace Coplt::LayoutCalc::Texts
         void AnalyzeFonts();
         void AnalyzeStyles();
         void CollectRuns();
+        void Analyze();
         void AnalyzeGlyphsFirst();
+        // Like AnalyzeGlyphsFirst, but runs outside the new chars [start, end) reuse the previous shaping if they can
+        void AnalyzeGlyphsEdited(u32 start, u32 end, u32 old_end);
+        void ShapeRun(Run& run);
+        ShapedRunKey GetShapedRunKey(const Run& run) const;
+        void BuildBreakIndex();
+        void ComputeIntrinsicSizes();
         // void AnalyzeGlyphsCarets();
 
+        // viewport is relative to the paragraph, null lays out every line
         LayoutOutput ComputeContent(
             void* sub_doc, TextLayout& layout, u32& order, const LayoutInputs& inputs, Size<bool> MaxOnly,
-            const Size<AvailableSpace>& AvailableSpace, const Size<std::optional<f32>>& KnownSize
+            const Size<AvailableSpace>& AvailableSpace, const Size<std::optional<f32>>& KnownSize,
+            const TextViewport* viewport
+        );
+        // Only breaks lines until they cover the viewport, the cross size of the rest is estimated
+        LayoutOutput ComputeContentLazy(
+            const LayoutInputs& inputs, const StyleData& root_style, Axis axis, f32 space_main, f32 cross_end
         );
+        // Continues the lazy lines until the closed ones reach cross_end, returns whether every line is broken
+        bool BreakLinesUntil(f32 cross_end);
+        // Moves the lines in m_final_lines, all placed, and their spans to m_packed_lines
+        void PackPlacedLines();
+        f32 EstimateLazyCross() const;
     };
 } // namespace Coplt
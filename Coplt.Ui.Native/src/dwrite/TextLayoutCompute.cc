@@ -1,13 +1,16 @@
 #include "TextLayout.h"
 
 #include <span>
+#include <algorithm>
 #include <array>
-#include <deque>
+#include <climits>
+#include <cmath>
 #include <fmt/xchar.h>
 
 #include "../lib.h"
 #include "../Algorithm.h"
 #include "../Text.h"
+#include "../RingBuffer.h"
 #include "../Layout.h"
 #include "Layout.h"
 #include "Error.h"
@@ -34,111 +37,6 @@ HResultE Texts::coplt_ui_layout_text_compute(
     );
 }
 
-std::optional<LayoutOutput> TextLayoutCache::GetOutput(const LayoutInputs& inputs)
-{
-    switch (inputs.RunMode)
-    {
-    case LayoutRunMode::PerformLayout:
-        {
-            if (!HasFlags(Flags, LayoutCacheFlags::Final)) return std::nullopt;
-            const auto& entry = Final;
-            const auto cached_size = GetSize(entry.Output);
-            const auto input_known_size = GetKnownSize(inputs);
-            const auto cache_known_size = GetKnownSize(entry);
-            const auto input_available_space = GetAvailableSpace(inputs);
-            const auto cache_available_space = GetAvailableSpace(entry);
-
-            if (
-                (input_known_size.Width == cache_known_size.Width || input_known_size.Width == cached_size.Width)
-                && (input_known_size.Height == cache_known_size.Height || input_known_size.Height == cached_size.Height)
-                && (input_known_size.Width.has_value() || IsRoughlyEqual(
-                    cache_available_space.Width, input_available_space.Width
-                ))
-                && (input_known_size.Height.has_value() || IsRoughlyEqual(
-                    cache_available_space.Height, input_available_space.Height
-                ))
-            )
-                return entry.Output;
-        }
-    case LayoutRunMode::ComputeSize:
-        {
-            if ((Flags & ~LayoutCacheFlags::Final) == 0) return std::nullopt;
-            for (u16 i = 0; i < 9; ++i)
-            {
-                if (!HasFlags(Flags, static_cast<LayoutCacheFlags>(1 << (i + 1)))) continue;
-                const auto& entry = Measure[i];
-                const auto size = entry.Size();
-                const auto input_known_size = GetKnownSize(inputs);
-                const auto cache_known_size = GetKnownSize(entry);
-                const auto input_available_space = GetAvailableSpace(inputs);
-                const auto cache_available_space = GetAvailableSpace(entry);
-                if (
-                    (input_known_size.Width == cache_known_size.Width || input_known_size.Width == size.Width)
-                    && (input_known_size.Height == cache_known_size.Height || input_known_size.Height == size.Height)
-                    && (input_known_size.Width.has_value() || IsRoughlyEqual(
-                        cache_available_space.Width, input_available_space.Width
-                    ))
-                    && (input_known_size.Height.has_value() || IsRoughlyEqual(
-                        cache_available_space.Height, input_available_space.Height
-                    ))
-                )
-                    return LayoutOutputFromOuterSize(size);
-            }
-            break;
-        }
-    case LayoutRunMode::PerformHiddenLayout:
-        break;
-    }
-    return std::nullopt;
-}
-
-void TextLayoutCache::StoreFinal(const LayoutInputs& inputs, LayoutOutput output)
-{
-    Flags |= LayoutCacheFlags::Final;
-    Final = {
-        {
-            .KnownWidth = inputs.KnownWidth,
-            .KnownHeight = inputs.KnownHeight,
-            .AvailableSpaceWidthValue = inputs.AvailableSpaceWidthValue,
-            .AvailableSpaceHeightValue = inputs.AvailableSpaceHeightValue,
-            .HasKnownWidth = inputs.HasKnownWidth,
-            .HasKnownHeight = inputs.HasKnownHeight,
-            .AvailableSpaceWidth = inputs.AvailableSpaceWidth,
-            .AvailableSpaceHeight = inputs.AvailableSpaceHeight,
-        },
-        .Output = output,
-    };
-}
-
-void TextLayoutCache::StoreMeasure(const LayoutInputs& inputs, const f32 width, const f32 height)
-{
-    const auto i = ComputeCacheSlot(
-        inputs.HasKnownWidth, inputs.HasKnownHeight,
-        inputs.AvailableSpaceWidth, inputs.AvailableSpaceHeight
-    );
-    Flags |= static_cast<LayoutCacheFlags>(1 << (i + 1));
-    Measure[i] = TextLayoutCache_Measure
-    {
-        {
-            .KnownWidth = inputs.KnownWidth,
-            .KnownHeight = inputs.KnownHeight,
-            .AvailableSpaceWidthValue = inputs.AvailableSpaceWidthValue,
-            .AvailableSpaceHeightValue = inputs.AvailableSpaceHeightValue,
-            .HasKnownWidth = inputs.HasKnownWidth,
-            .HasKnownHeight = inputs.HasKnownHeight,
-            .AvailableSpaceWidth = inputs.AvailableSpaceWidth,
-            .AvailableSpaceHeight = inputs.AvailableSpaceHeight,
-        },
-        .Width = width,
-        .Height = height,
-    };
-}
-
-void TextLayoutCache::Clear()
-{
-    Flags = LayoutCacheFlags::Empty;
-}
-
 void TextLayout::Compute(void* sub_doc, LayoutOutput& out, const LayoutInputs& inputs, CtxNodeRef node)
 {
     m_node = node;
@@ -203,13 +101,79 @@ LayoutOutput TextLayout::Compute(void* sub_doc, const LayoutInputs& inputs)
 
     #pragma endregion
 
+    const auto axis = ToAxis(style.WritingDirection);
+    const auto measure_cache_options = m_layout
+        ? m_layout->m_lib->m_text_measure_cache
+        : TextMeasureCacheOptions{.Capacity = 0};
+    // Sizes of a viewport layout are estimates that change as it scrolls
+    const auto use_measure_cache = inputs.RunMode == LayoutRunMode::ComputeSize && measure_cache_options.Capacity > 0
+        && !m_viewport.has_value();
+    u32 measure_cache_hits = 0;
+    u32 measure_cache_misses = 0;
+    u32 intrinsic_hits = 0;
+
     u32 order = 0;
     auto last_available_space = available_space.Normalize(clamped_size, min_size, max_size);
     Size<f32> size{};
+    f32 cross_offset = 0;
     for (auto& data : m_paragraph_datas)
     {
-        auto output = data.ComputeContent(sub_doc, *this, order, inputs, max_only, last_available_space, known_dimensions);
+        LayoutOutput output;
+        std::optional<TextViewport> viewport = m_viewport;
+        if (viewport) viewport->Start -= cross_offset;
+        const auto main_space_type = last_available_space.MainAxis(axis).first;
+        if (
+            inputs.RunMode == LayoutRunMode::ComputeSize && data.m_intrinsic_sizes.Valid
+            && main_space_type != AvailableSpaceType::Definite && !known_dimensions.MainAxis(axis).has_value()
+        )
+        {
+            // Min-content and max-content never depend on the width, so they are answered without breaking lines
+            intrinsic_hits++;
+            const auto& intrinsic = data.m_intrinsic_sizes;
+            const auto is_min = main_space_type == AvailableSpaceType::MinContent;
+            Size<f32> content_size{};
+            content_size.MainAxis(axis) = is_min ? intrinsic.MinContentMain : intrinsic.MaxContentMain;
+            content_size.CrossAxis(axis) = is_min ? intrinsic.MinContentCross : intrinsic.MaxContentCross;
+            output = LayoutOutputFromOuterSize(content_size);
+            data.m_line_count = is_min ? intrinsic.MinContentLines : intrinsic.MaxContentLines;
+        }
+        else if (use_measure_cache)
+        {
+            const auto space_main = last_available_space.Or(known_dimensions).MainAxis(axis)
+                .value_or(std::numeric_limits<f32>::infinity());
+            const auto key = TextMeasureCache::KeyOf(measure_cache_options, space_main);
+            if (const auto entry = data.m_measure_cache.Find(key))
+            {
+                measure_cache_hits++;
+                output = entry->Output;
+                data.m_line_count = entry->LineCount;
+            }
+            else
+            {
+                measure_cache_misses++;
+                // Measured at the key, so the entry is right for every width that rounds to it
+                auto measure_space = last_available_space;
+                auto measure_known = known_dimensions;
+                if (key != space_main)
+                {
+                    measure_space.MainAxis(axis) = std::make_pair(AvailableSpaceType::Definite, key);
+                    if (measure_known.MainAxis(axis).has_value()) measure_known.MainAxis(axis) = key;
+                }
+                output = data.ComputeContent(
+                    sub_doc, *this, order, inputs, max_only, measure_space, measure_known, nullptr
+                );
+                data.m_measure_cache.Store(measure_cache_options, key, output, data.m_line_count);
+            }
+        }
+        else
+        {
+            output = data.ComputeContent(
+                sub_doc, *this, order, inputs, max_only, last_available_space, known_dimensions,
+                viewport ? &*viewport : nullptr
+            );
+        }
         last_available_space = last_available_space.TrySub(GetSize(output));
+        cross_offset += GetSize(output).CrossAxis(axis);
         if (style.WritingDirection == WritingDirection::Horizontal)
         {
             size.Width += output.Width;
@@ -221,6 +185,18 @@ LayoutOutput TextLayout::Compute(void* sub_doc, const LayoutInputs& inputs)
             size.Height += output.Height;
         }
     }
+    if (m_layout && intrinsic_hits + measure_cache_hits + measure_cache_misses > 0)
+    {
+        m_layout->m_lib->m_logger.Log(
+            LogLevel::Debug, [&]
+            {
+                return fmt::format(
+                    L"text measure: {} intrinsic, cache {} hits, {} misses",
+                    intrinsic_hits, measure_cache_hits, measure_cache_misses
+                );
+            }
+        );
+    }
     if (inputs.RunMode == LayoutRunMode::ComputeSize)
     {
         return LayoutOutputFromOuterSize(size);
@@ -232,11 +208,35 @@ LayoutOutput TextLayout::Compute(void* sub_doc, const LayoutInputs& inputs)
     };
 }
 
+void TextLayout::SetViewport(const TextViewport* viewport)
+{
+    if (viewport) m_viewport = *viewport;
+    else m_viewport = std::nullopt;
+}
+
 LayoutOutput ParagraphData::ComputeContent(
     void* sub_doc, TextLayout& layout, u32& order, const LayoutInputs& inputs, Size<bool> MaxOnly,
-    const Size<AvailableSpace>& AvailableSpace, const Size<std::optional<f32>>& KnownSize
+    const Size<AvailableSpace>& AvailableSpace, const Size<std::optional<f32>>& KnownSize,
+    const TextViewport* viewport
 )
 {
+    // Needs a definite width, lines broken ahead of the viewport must not depend on the ones after it;
+    // the intrinsic sizes are only valid for paragraphs without inline blocks
+    if (viewport != nullptr && m_intrinsic_sizes.Valid && inputs.RunMode != LayoutRunMode::PerformHiddenLayout)
+    {
+        const auto& root_style = layout.m_node.StyleData();
+        const auto axis = ToAxis(root_style.WritingDirection);
+        const auto space_main = AvailableSpace.Or(KnownSize).MainAxis(axis)
+            .value_or(std::numeric_limits<f32>::infinity());
+        if (!std::isinf(space_main) && !MaxOnly.MainAxis(axis))
+        {
+            return ComputeContentLazy(
+                inputs, root_style, axis, space_main, viewport->Start + viewport->Length + viewport->Margin
+            );
+        }
+    }
+    m_lazy_lines = nullptr;
+
     return {};
 
     // const auto& root_style = layout.m_node.StyleData();
@@ -422,6 +422,7 @@ LayoutOutput ParagraphData::ComputeContent(
     //         sum_cross += cur_line.CrossSize;
     //         lines.push_back(cur_line);
     //     }
+    //     m_line_count = static_cast<u32>(lines.size());
     //
     //     if (inputs.RunMode == LayoutRunMode::PerformLayout)
     //     {
@@ -497,6 +498,164 @@ LayoutOutput ParagraphData::ComputeContent(
     // return LayoutOutputFromOuterSize(result_size);
 }
 
+LayoutOutput ParagraphData::ComputeContentLazy(
+    const LayoutInputs& inputs, const StyleData& root_style, const Axis axis, const f32 space_main, const f32 cross_end
+)
+{
+    if (!m_lazy_lines || m_lazy_lines->SpaceMain != space_main)
+    {
+        m_final_spans.clear();
+        m_final_span_runs.clear();
+        m_final_lines.clear();
+        m_packed_lines.Clear();
+        m_lazy_lines = std::make_unique<LazyLines>();
+        m_lazy_lines->SpaceMain = space_main;
+        m_lazy_lines->Ctx.AvailableSpace = space_main;
+        m_lazy_lines->Ctx.UseBreakIndex = true;
+        m_lazy_lines->DefinedLineHeight = Resolve(GetLineHeight(root_style), root_style.FontSize);
+    }
+    auto& lazy = *m_lazy_lines;
+    const auto done = BreakLinesUntil(cross_end);
+    m_line_count = m_packed_lines.LineCount() + static_cast<u32>(m_final_lines.size());
+
+    Size<f32> result_size{};
+    if (inputs.RunMode == LayoutRunMode::PerformLayout)
+    {
+        // The main size is the space, so lines broken later never move the ones placed before
+        result_size.MainAxis(axis) = space_main;
+        for (auto& line : m_final_lines)
+        {
+            switch (root_style.TextAlign)
+            {
+            case TextAlign::End:
+                line.MainOffset = space_main - line.MainSize;
+                break;
+            case TextAlign::Center:
+                line.MainOffset = (space_main - line.MainSize) / 2;
+                break;
+            case TextAlign::Start:
+            default:
+                break;
+            }
+        }
+        PackPlacedLines();
+    }
+    else
+    {
+        // Lines not broken yet are at most as long as the longest hard line
+        result_size.MainAxis(axis) = done
+            ? lazy.MaxMain
+            : std::max(lazy.MaxMain, std::min(space_main, m_intrinsic_sizes.MaxContentMain));
+    }
+    result_size.CrossAxis(axis) = done ? lazy.SumCross : EstimateLazyCross();
+    return LayoutOutputFromOuterSize(result_size);
+}
+
+// Same line building as ComputeContent, only it can stop between lines and pick up there on the next call
+bool ParagraphData::BreakLinesUntil(const f32 cross_end)
+{
+    auto& lazy = *m_lazy_lines;
+    auto& spans = m_final_spans;
+    auto& lines = m_final_lines;
+    auto& cur_line = lazy.CurLine;
+    if (lazy.Run >= m_runs.size()) return true;
+
+    auto& font_metrics = FontMetricsCache::Of(m_text_layout->m_node.ctx->font_manager);
+    while (lazy.Run < m_runs.size())
+    {
+        if (lazy.SumCross >= cross_end) return false;
+
+        auto& run = m_runs[lazy.Run];
+        const auto& style = GetScope(m_same_style_ranges[run.StyleRangeIndex]).StyleData();
+        const auto& line_info = run.GetLineInfo(*this, font_metrics);
+        if (!lazy.RunStarted)
+        {
+            lazy.DefinedLineHeight = Resolve(GetLineHeight(style), style.FontSize);
+            cur_line.Ascent = std::max(cur_line.Ascent, line_info.Ascent);
+            cur_line.Descent = std::max(cur_line.Descent, line_info.Descent);
+            cur_line.LineGap = std::max(cur_line.LineGap, line_info.LineGap);
+            lazy.State.Reset();
+            lazy.RunStarted = true;
+            lazy.RunSpanStart = static_cast<u32>(spans.size());
+        }
+
+        // Stopping once the line after the current one starts closes at least the current one
+        lazy.Ctx.StopLine = lazy.CurNthLine + 2;
+        const auto run_span_start = spans.size();
+        const auto finished = run.BreakLines(*this, style, lazy.Ctx, line_info, spans, lazy.State);
+        m_final_span_runs.resize(spans.size(), lazy.Run);
+        for (auto i = run_span_start; i < spans.size(); ++i)
+        {
+            const auto& span = spans[i];
+            if (span.NthLine == lazy.CurNthLine) continue;
+            lazy.ClosedChars = i > lazy.RunSpanStart
+                ? run.Start + spans[i - 1].CharStart + spans[i - 1].CharLength
+                : run.Start;
+            cur_line.NthLine = lazy.CurNthLine;
+            cur_line.MainSize = i == 0 ? 0 : spans[i - 1].Offset + spans[i - 1].Size;
+            cur_line.SpanLength = static_cast<u32>(i) - cur_line.SpanStart;
+            cur_line.CrossSize = cur_line.CalcSize(lazy.DefinedLineHeight);
+            lazy.MaxMain = std::max(lazy.MaxMain, cur_line.MainSize);
+            lazy.SumCross += cur_line.CrossSize;
+            lines.push_back(cur_line);
+            cur_line = ParagraphLine{
+                .CrossOffset = lazy.SumCross,
+                .SpanStart = static_cast<u32>(i),
+            };
+            lazy.CurNthLine = span.NthLine;
+        }
+        if (!finished) continue;
+        lazy.Run++;
+        lazy.RunStarted = false;
+    }
+
+    m_break_line_allocations = lazy.Ctx.HeapAllocations;
+    if (spans.size() != cur_line.SpanStart)
+    {
+        cur_line.NthLine = lazy.CurNthLine;
+        cur_line.MainSize = spans.empty() ? 0 : spans.back().Offset + spans.back().Size;
+        cur_line.SpanLength = static_cast<u32>(spans.size()) - cur_line.SpanStart;
+        cur_line.CrossSize = cur_line.CalcSize(lazy.DefinedLineHeight);
+        lazy.MaxMain = std::max(lazy.MaxMain, cur_line.MainSize);
+        lazy.SumCross += cur_line.CrossSize;
+        lines.push_back(cur_line);
+    }
+    lazy.ClosedChars = static_cast<u32>(m_chars.size());
+    return true;
+}
+
+void ParagraphData::PackPlacedLines()
+{
+    if (m_final_lines.empty()) return;
+    auto& lazy = *m_lazy_lines;
+    const auto& last = m_final_lines.back();
+    const auto span_end = last.SpanStart + last.SpanLength;
+    // Packed lines count their spans from the first packed one
+    const auto span_base = m_packed_lines.SpanCount();
+    for (u32 i = 0; i < span_end; ++i) m_packed_lines.AddSpan(m_final_spans[i], m_final_span_runs[i]);
+    for (auto line : m_final_lines)
+    {
+        line.SpanStart += span_base;
+        m_packed_lines.AddLine(line);
+    }
+    m_final_spans.erase(m_final_spans.begin(), m_final_spans.begin() + span_end);
+    m_final_span_runs.erase(m_final_span_runs.begin(), m_final_span_runs.begin() + span_end);
+    m_final_lines.clear();
+
+    // The open line starts after the packed spans, unless every line is broken and it was packed too
+    lazy.CurLine.SpanStart = lazy.CurLine.SpanStart >= span_end ? lazy.CurLine.SpanStart - span_end : 0;
+    lazy.RunSpanStart = lazy.RunSpanStart >= span_end ? lazy.RunSpanStart - span_end : 0;
+}
+
+f32 ParagraphData::EstimateLazyCross() const
+{
+    const auto& lazy = *m_lazy_lines;
+    if (lazy.ClosedChars == 0) return std::max(lazy.SumCross, m_intrinsic_sizes.MaxContentCross);
+    // Lines not broken yet are as tall and hold as many chars as the closed ones on average
+    const auto rest = static_cast<f32>(m_chars.size() - lazy.ClosedChars);
+    return lazy.SumCross + rest * (lazy.SumCross / static_cast<f32>(lazy.ClosedChars));
+}
+
 std::span<const char16> Run::Chars(const ParagraphData& data) const
 {
     return std::span(data.m_chars.data() + Start, Length);
@@ -514,32 +673,37 @@ std::span<const DWRITE_LINE_BREAKPOINT> Run::LineBreakpoints(const ParagraphData
 
 std::span<const u16> Run::ClusterMap(const ParagraphData& data) const
 {
-    return std::span(data.m_cluster_map.data() + ClusterStartIndex, Length);
+    return std::span(data.m_glyphs.m_cluster_map + ClusterStartIndex, Length);
 }
 
 std::span<const DWRITE_SHAPING_TEXT_PROPERTIES> Run::TextProps(const ParagraphData& data) const
 {
-    return std::span(data.m_text_props.data() + ClusterStartIndex, Length);
+    return std::span(data.m_glyphs.m_text_props + ClusterStartIndex, Length);
 }
 
 std::span<const u16> Run::GlyphIndices(const ParagraphData& data) const
 {
-    return std::span(data.m_glyph_indices.data() + GlyphStartIndex, ActualGlyphCount);
+    return std::span(data.m_glyphs.m_glyph_indices + GlyphStartIndex, ActualGlyphCount);
 }
 
 std::span<const DWRITE_SHAPING_GLYPH_PROPERTIES> Run::GlyphProps(const ParagraphData& data) const
 {
-    return std::span(data.m_glyph_props.data() + GlyphStartIndex, ActualGlyphCount);
+    return std::span(data.m_glyphs.m_glyph_props + GlyphStartIndex, ActualGlyphCount);
 }
 
 std::span<const f32> Run::GlyphAdvances(const ParagraphData& data) const
 {
-    return std::span(data.m_glyph_advances.data() + GlyphStartIndex, ActualGlyphCount);
+    return std::span(data.m_glyphs.m_glyph_advances + GlyphStartIndex, ActualGlyphCount);
 }
 
 std::span<const DWRITE_GLYPH_OFFSET> Run::GlyphOffsets(const ParagraphData& data) const
 {
-    return std::span(data.m_glyph_offsets.data() + GlyphStartIndex, ActualGlyphCount);
+    return std::span(data.m_glyphs.m_glyph_offsets + GlyphStartIndex, ActualGlyphCount);
+}
+
+std::span<const f32> Run::ClusterWidths(const ParagraphData& data) const
+{
+    return std::span(data.m_glyphs.m_cluster_widths + GlyphStartIndex, ActualGlyphCount);
 }
 
 bool Run::IsInlineBlock(const ParagraphData& data) const
@@ -549,7 +713,7 @@ bool Run::IsInlineBlock(const ParagraphData& data) const
     // return !font.Font;
 }
 
-const ParagraphLineInfo& Run::GetLineInfo(const ParagraphData& data)
+const ParagraphLineInfo& Run::GetLineInfo(const ParagraphData& data, FontMetricsCache& metrics)
 {
     if (HasLineInfo) return LineInfo;
     const auto& font = data.m_font_ranges[FontRangeIndex];
@@ -558,47 +722,16 @@ const ParagraphLineInfo& Run::GetLineInfo(const ParagraphData& data)
     // if (!font.Font) return LineInfo;
 
     HasLineInfo = true;
-    if (style.WritingDirection == WritingDirection::Horizontal)
-    {
-        DWRITE_FONT_METRICS1 metrics{};
-        // font.Font->m_face->GetMetrics(&metrics);
-        const auto scale = style.FontSize / metrics.designUnitsPerEm;
-        LineInfo.Ascent = metrics.ascent * scale;
-        LineInfo.Descent = metrics.descent * scale;
-        LineInfo.LineGap = metrics.lineGap * scale;
-    }
-    else
-    {
-        // todo: not sure, need test
-        DWRITE_FONT_METRICS1 metrics{};
-        // font.Font->m_face->GetMetrics(&metrics);
-        const auto scale = style.FontSize / metrics.designUnitsPerEm;
-        LineInfo.LineGap = metrics.lineGap * scale;
-        const auto glyph_box_size = metrics.glyphBoxRight - metrics.glyphBoxLeft;
-        LineInfo.Ascent = LineInfo.Descent = glyph_box_size * scale * 0.5f;
-    }
-    LineInfo.MinSize = LineInfo.Ascent + LineInfo.Descent;
+    // LineInfo = metrics.Get(
+    //     font.Font->Impl_get_Id(), font.Font->m_face.get(), style.FontSize, style.WritingDirection
+    // );
+    LineInfo = metrics.Get(0, nullptr, style.FontSize, style.WritingDirection);
 
     return LineInfo;
 }
 
 namespace Coplt::LayoutCalc::Texts::Compute
 {
-    struct Cursor
-    {
-        i32 Char;
-        f32 Offset;
-
-        COPLT_FORCE_INLINE
-        Cursor() = default;
-
-        COPLT_FORCE_INLINE
-        explicit Cursor(const i32 c, const f32 o)
-            : Char(c), Offset(o)
-        {
-        }
-    };
-
     COPLT_FORCE_INLINE
     u16 NextGlyph(const u32 next_char, const std::span<const u16> cluster_map)
     {
@@ -664,6 +797,21 @@ namespace Coplt::LayoutCalc::Texts::Compute
         return sum_size;
     }
 
+    // StepCluster only groups chars that share a glyph cluster, so the width precomputed after shaping almost always applies
+    COPLT_FORCE_INLINE
+    f32 ClusterSize(
+        const Run& self,
+        const std::span<const f32> cluster_widths,
+        const std::span<const DWRITE_SHAPING_GLYPH_PROPERTIES> glyph_props,
+        const std::span<const f32> glyph_advances,
+        const std::span<const DWRITE_GLYPH_OFFSET> glyph_offsets,
+        const u16 first_cluster, const u16 last_cluster
+    )
+    {
+        if (first_cluster == last_cluster) [[likely]] return cluster_widths[first_cluster];
+        return SumSize(self, glyph_props, glyph_advances, glyph_offsets, first_cluster, last_cluster);
+    }
+
     COPLT_FORCE_INLINE
     ParagraphSpanType CheckParagraphSpanType(const char16 the_char, const RawCharType char_raw, const bool allow_newline)
     {
@@ -681,28 +829,30 @@ namespace Coplt::LayoutCalc::Texts::Compute
     }
 }
 
-#ifdef _DEBUG
-std::vector<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info) const
-#else
-std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info) const
-#endif
+void Run::BreakLines(
+    const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info,
+    std::vector<ParagraphSpan>& spans
+) const
+{
+    RunBreakLineState state{};
+    BreakLines(data, style, ctx, line_info, spans, state);
+}
+
+bool Run::BreakLines(
+    const ParagraphData& data, const StyleData& style, RunBreakLineCtx& ctx, const ParagraphLineInfo& line_info,
+    std::vector<ParagraphSpan>& spans, RunBreakLineState& state
+) const
 {
     using namespace Coplt::LayoutCalc::Texts::Compute;
+    using SubSpan = RunBreakLineState::SubSpan;
+
+    const auto push_span = [&](const ParagraphSpan& span)
+    {
+        if (spans.size() == spans.capacity()) [[unlikely]] ctx.HeapAllocations++;
+        spans.push_back(span);
+    };
 
-    #pragma push_macro("YIELD")
-    #pragma push_macro("RETURN")
-    #undef YIELD
-    #undef RETURN
-    #ifdef _DEBUG
-    std::vector<ParagraphSpan> result;
-    #define YIELD result.push_back
-    #define RETURN return result
-    #else
-    #define YIELD co_yield
-    #define RETURN co_return
-    #endif
-
-    if (Length == 0 || ActualGlyphCount == 0) [[unlikely]] RETURN;
+    if (Length == 0 || ActualGlyphCount == 0) [[unlikely]] return true;
 
     const auto allow_newline = HasFlags(style.WrapFlags, WrapFlags::AllowNewLine);
     const auto wrap_in_space = HasFlags(style.WrapFlags, WrapFlags::WrapInSpace);
@@ -716,6 +866,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
     const std::span glyph_props = GlyphProps(data);
     const std::span glyph_advances = GlyphAdvances(data);
     const std::span glyph_offsets = GlyphOffsets(data);
+    const std::span cluster_widths = ClusterWidths(data);
 
     // todo support WordBreak
 
@@ -728,17 +879,89 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
         Cursor span_start(0, cur_offset);
         std::optional<Cursor> break_after = cur_offset == 0 ? std::nullopt : std::optional(Cursor(-1, cur_offset));
         auto last_type = static_cast<ParagraphSpanType>(-1);
-        struct SubSpan
+        auto& sub_spans = state.SubSpans;
+        // Whether sub spans were queued since the line started, flushing early does not reset it
+        bool sub_span_pending = false;
+
+        // Emits the queued sub spans that end at or before end_char
+        const auto flush_sub_spans = [&](const i32 end_char)
         {
-            i32 EndChar; // not include
-            f32 Size;
-            ParagraphSpanType Type;
+            while (!sub_spans.IsEmpty())
+            {
+                const auto sub_span = sub_spans.Front();
+                if (sub_span.EndChar > end_char) break;
+                const u16 first_glyph = cluster_map[span_start.Char];
+                const u32 char_len = sub_span.EndChar - span_start.Char;
+                const u32 glyph_length = GlyphLength(sub_span.EndChar, cluster_map, first_glyph);
+                const f32 size = sub_span.Size;
+                const f32 next_offset = span_start.Offset + sub_span.Size;
+                ctx.NthLine = nth_line;
+                ctx.CurrentLineOffset = next_offset;
+                push_span(
+                    ParagraphSpan{
+                        .NthLine = nth_line,
+                        .CharStart = static_cast<u32>(span_start.Char),
+                        .CharLength = char_len,
+                        .GlyphStart = first_glyph,
+                        .GlyphLength = glyph_length,
+                        .Ascent = line_info.Ascent,
+                        .Descent = line_info.Descent,
+                        .Offset = span_start.Offset,
+                        .Size = size,
+                        .Type = sub_span.Type,
+                        .NeedReShape = false,
+                    }
+                );
+                span_start = Cursor(sub_span.EndChar, next_offset);
+                sub_spans.PopFront();
+            }
         };
-        std::deque<SubSpan> sub_spans{};
+
+        // Only read with RunBreakLineCtx::UseBreakIndex, see the end of the loop
+        const auto use_index = ctx.UseBreakIndex && BreakClusterEndsSorted;
+        const auto& index = data.m_break_index;
+        const auto count = use_index ? BreakClusterCount : 0;
+        const std::span<const double> ends(index.m_cluster_ends.data() + BreakClusterStart, count);
+        const std::span<const u32> cluster_chars(index.m_cluster_chars.data() + BreakClusterStart, count);
+        const std::span<const u32> next_events(index.m_next_events.data() + BreakClusterStart, count);
+        // Clusters this close to the end of the line are still walked, so whether they overflow is decided on the
+        // same f32 offsets as without the index
+        const f32 overflow_margin =
+            std::isfinite(ctx.AvailableSpace) ? std::max(1.0f, std::abs(ctx.AvailableSpace)) / 1024 : 0;
 
         i32 c = span_start.Char;
+        u32 cluster = 0;
+        if (state.Started)
+        {
+            c = state.Char;
+            cluster = state.Cluster;
+            nth_line = state.NthLine;
+            cur_offset = state.CurrentOffset;
+            last_sub_span_offset = state.LastSubSpanOffset;
+            span_start = state.SpanStart;
+            break_after = state.BreakAfter;
+            last_type = state.LastType;
+            sub_span_pending = state.SubSpanPending;
+        }
+        else sub_spans.Clear();
         for (;;)
         {
+            if (nth_line >= ctx.StopLine) [[unlikely]]
+            {
+                // Every span of the lines before is out, the pending sub spans belong to this line
+                state.Started = true;
+                state.Char = c;
+                state.Cluster = cluster;
+                state.NthLine = nth_line;
+                state.CurrentOffset = cur_offset;
+                state.LastSubSpanOffset = last_sub_span_offset;
+                state.SpanStart = span_start;
+                state.BreakAfter = break_after;
+                state.LastType = last_type;
+                state.SubSpanPending = sub_span_pending;
+                return false;
+            }
+
             const char16 the_char = chars[c];
             const RawCharType char_raw = char_metas[c].RawType;
 
@@ -747,15 +970,24 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
             const i32 next_char = StepCluster(*this, cluster_map, first_cluster, c);
             const u16 last_cluster = cluster_map[c];
 
-            const f32 sum_size = SumSize(*this, glyph_props, glyph_advances, glyph_offsets, first_cluster, last_cluster);
+            const f32 sum_size = ClusterSize(
+                *this, cluster_widths, glyph_props, glyph_advances, glyph_offsets, first_cluster, last_cluster
+            );
             const f32 new_line_offset = sum_size + cur_offset;
 
             const ParagraphSpanType type = CheckParagraphSpanType(the_char, char_raw, allow_newline);
             if (last_type == static_cast<ParagraphSpanType>(-1)) last_type = type;
             else if (last_type != type)
             {
-                const f32 size = sub_spans.empty() ? cur_offset : cur_offset - last_sub_span_offset;
-                sub_spans.push_back(
+                const f32 size = sub_span_pending ? cur_offset - last_sub_span_offset : cur_offset;
+                if (sub_spans.IsFull())
+                {
+                    // Sub spans before the last break opportunity stay on this line whatever comes next
+                    flush_sub_spans(break_after.has_value() ? break_after.value().Char : INT_MAX);
+                    if (sub_spans.IsFull()) ctx.HeapAllocations++;
+                }
+                sub_span_pending = true;
+                sub_spans.PushBack(
                     SubSpan{
                         .EndChar = start_char,
                         .Size = size,
@@ -774,33 +1006,8 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
 
             if (allow_newline && char_raw == RawCharType::LF)
             {
-                for (const auto& sub_span : sub_spans)
-                {
-                    const u16 first_glyph = cluster_map[span_start.Char];
-                    const u32 char_len = sub_span.EndChar - span_start.Char;
-                    const u32 glyph_length = GlyphLength(sub_span.EndChar, cluster_map, first_glyph);
-                    const f32 size = sub_span.Size;
-                    const f32 next_offset = span_start.Offset + sub_span.Size;
-                    ctx.NthLine = nth_line;
-                    ctx.CurrentLineOffset = next_offset;
-                    YIELD(
-                        ParagraphSpan{
-                            .NthLine = nth_line,
-                            .CharStart = static_cast<u32>(span_start.Char),
-                            .CharLength = char_len,
-                            .GlyphStart = first_glyph,
-                            .GlyphLength = glyph_length,
-                            .Ascent = line_info.Ascent,
-                            .Descent = line_info.Descent,
-                            .Offset = span_start.Offset,
-                            .Size = size,
-                            .Type = sub_span.Type,
-                            .NeedReShape = false,
-                        }
-                    );
-                    span_start = Cursor(sub_span.EndChar, next_offset);
-                }
-                sub_spans.clear();
+                flush_sub_spans(INT_MAX);
+                sub_span_pending = false;
                 {
                     cur_offset = new_line_offset;
                     const u16 first_glyph = cluster_map[span_start.Char];
@@ -809,7 +1016,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                     const f32 size = cur_offset - span_start.Offset;
                     ctx.NthLine = nth_line;
                     ctx.CurrentLineOffset = cur_offset;
-                    YIELD(
+                    push_span(
                         ParagraphSpan{
                             .NthLine = nth_line,
                             .CharStart = static_cast<u32>(span_start.Char),
@@ -834,36 +1041,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
             }
             else if (new_line_offset > ctx.AvailableSpace && break_after.has_value() && static_cast<i32>(c) > break_after.value().Char)
             {
-                u32 i = 0;
-                for (; i < sub_spans.size(); ++i)
-                {
-                    const auto& sub_span = sub_spans[i];
-                    if (sub_span.EndChar > break_after.value().Char) break;
-                    const u16 first_glyph = cluster_map[span_start.Char];
-                    const u32 char_len = sub_span.EndChar - span_start.Char;
-                    const u32 glyph_length = GlyphLength(sub_span.EndChar, cluster_map, first_glyph);
-                    const f32 size = sub_span.Size;
-                    const f32 next_offset = span_start.Offset + sub_span.Size;
-                    ctx.NthLine = nth_line;
-                    ctx.CurrentLineOffset = next_offset;
-                    YIELD(
-                        ParagraphSpan{
-                            .NthLine = nth_line,
-                            .CharStart = static_cast<u32>(span_start.Char),
-                            .CharLength = char_len,
-                            .GlyphStart = first_glyph,
-                            .GlyphLength = glyph_length,
-                            .Ascent = line_info.Ascent,
-                            .Descent = line_info.Descent,
-                            .Offset = span_start.Offset,
-                            .Size = size,
-                            .Type = sub_span.Type,
-                            .NeedReShape = false,
-                        }
-                    );
-                    span_start = Cursor(sub_span.EndChar, next_offset);
-                }
-                sub_spans.erase(sub_spans.begin(), sub_spans.begin() + i);
+                flush_sub_spans(break_after.value().Char);
 
                 if (break_after.value().Char == -1)
                 {
@@ -874,7 +1052,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                 }
                 else
                 {
-                    const auto break_span_type = sub_spans.empty() ? type : sub_spans.back().Type;
+                    const auto break_span_type = sub_spans.IsEmpty() ? type : sub_spans.Back().Type;
                     const auto& text_prop = text_props[break_after.value().Char];
                     const u16 first_glyph = cluster_map[span_start.Char];
                     const u32 break_next_char = break_after.value().Char + 1;
@@ -883,7 +1061,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                     const f32 size = break_after.value().Offset - span_start.Offset;
                     ctx.NthLine = nth_line;
                     ctx.CurrentLineOffset = break_after.value().Offset;
-                    YIELD(
+                    push_span(
                         ParagraphSpan{
                             .NthLine = nth_line,
                             .CharStart = static_cast<u32>(span_start.Char),
@@ -900,12 +1078,12 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                     );
 
                     nth_line++;
-                    if (!sub_spans.empty())
+                    if (!sub_spans.IsEmpty())
                     {
-                        auto& sub_span = sub_spans.back();
+                        auto& sub_span = sub_spans.Back();
                         if (sub_span.EndChar == break_next_char)
                         {
-                            sub_spans.pop_front();
+                            sub_spans.PopFront();
                         }
                         else
                         {
@@ -917,6 +1095,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                     last_sub_span_offset = cur_offset = rem_offset + sum_size;
                     span_start = Cursor(break_next_char, 0);
                 }
+                sub_span_pending = !sub_spans.IsEmpty();
 
                 if (is_break_point_after)
                 {
@@ -939,32 +1118,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
 
             if (next_char >= Length)
             {
-                for (const auto& sub_span : sub_spans)
-                {
-                    const u16 first_glyph = cluster_map[span_start.Char];
-                    const u32 char_len = sub_span.EndChar - span_start.Char;
-                    const u32 glyph_length = GlyphLength(sub_span.EndChar, cluster_map, first_glyph);
-                    const f32 size = sub_span.Size;
-                    const f32 next_offset = span_start.Offset + sub_span.Size;
-                    ctx.NthLine = nth_line;
-                    ctx.CurrentLineOffset = next_offset;
-                    YIELD(
-                        ParagraphSpan{
-                            .NthLine = nth_line,
-                            .CharStart = static_cast<u32>(span_start.Char),
-                            .CharLength = char_len,
-                            .GlyphStart = first_glyph,
-                            .GlyphLength = glyph_length,
-                            .Ascent = line_info.Ascent,
-                            .Descent = line_info.Descent,
-                            .Offset = span_start.Offset,
-                            .Size = size,
-                            .Type = sub_span.Type,
-                            .NeedReShape = false,
-                        }
-                    );
-                    span_start = Cursor(sub_span.EndChar, next_offset);
-                }
+                flush_sub_spans(INT_MAX);
                 {
                     const u16 first_glyph = cluster_map[span_start.Char];
                     const u32 char_len = next_char - span_start.Char;
@@ -972,7 +1126,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                     const f32 size = cur_offset - span_start.Offset;
                     ctx.NthLine = nth_line;
                     ctx.CurrentLineOffset = cur_offset;
-                    YIELD(
+                    push_span(
                         ParagraphSpan{
                             .NthLine = nth_line,
                             .CharStart = static_cast<u32>(span_start.Char),
@@ -988,10 +1142,28 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                         }
                     );
                 }
-                RETURN;
+                return true;
             }
 
             c = next_char;
+            cluster++;
+            if (use_index && last_type != static_cast<ParagraphSpanType>(-1))
+            {
+                // Clusters before the next event only add their advance, unless one overflows the line
+                u32 next = next_events[cluster];
+                if (break_after.has_value() && next > cluster)
+                {
+                    const double limit = ends[cluster - 1] + ctx.AvailableSpace - cur_offset - overflow_margin;
+                    if (ends[next - 1] > limit)
+                        next = static_cast<u32>(std::upper_bound(&ends[cluster], &ends[next - 1], limit) - ends.data());
+                }
+                if (next > cluster)
+                {
+                    cur_offset = static_cast<f32>(cur_offset + (ends[next - 1] - ends[cluster - 1]));
+                    cluster = next;
+                    c = static_cast<i32>(cluster_chars[cluster]);
+                }
+            }
         }
     }
     else
@@ -1009,7 +1181,9 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
             const i32 next_char = StepCluster(*this, cluster_map, first_cluster, c);
             const u16 last_cluster = cluster_map[c];
 
-            const f32 sum_size = SumSize(*this, glyph_props, glyph_advances, glyph_offsets, first_cluster, last_cluster);
+            const f32 sum_size = ClusterSize(
+                *this, cluster_widths, glyph_props, glyph_advances, glyph_offsets, first_cluster, last_cluster
+            );
             const f32 new_line_offset = sum_size + cur_offset;
 
             const ParagraphSpanType type = CheckParagraphSpanType(the_char, char_raw, allow_newline);
@@ -1022,7 +1196,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                 const u32 glyph_length = GlyphLength(start_char, cluster_map, first_glyph);
                 const f32 size = cur_offset - span_start.Offset;
                 ctx.CurrentLineOffset = cur_offset;
-                YIELD(
+                push_span(
                     ParagraphSpan{
                         .NthLine = nth_line,
                         .CharStart = static_cast<u32>(span_start.Char),
@@ -1051,7 +1225,7 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                 const u32 glyph_length = GlyphLength(next_char, cluster_map, first_glyph);
                 const f32 size = cur_offset - span_start.Offset;
                 ctx.CurrentLineOffset = cur_offset;
-                YIELD(
+                push_span(
                     ParagraphSpan{
                         .NthLine = nth_line,
                         .CharStart = static_cast<u32>(span_start.Char),
@@ -1066,12 +1240,215 @@ std::generator<ParagraphSpan> Run::BreakLines(const ParagraphData& data, const S
                         .NeedReShape = false,
                     }
                 );
-                RETURN;
+                return true;
             }
             c = next_char;
         }
     }
+}
+
+void ParagraphData::BuildBreakIndex()
+{
+    using namespace Coplt::LayoutCalc::Texts::Compute;
+
+    auto& index = m_break_index;
+    index.m_cluster_ends.clear();
+    index.m_cluster_chars.clear();
+    index.m_breaks.clear();
+    index.m_space_breaks.clear();
+    index.m_new_lines.clear();
+    index.m_next_events.clear();
+    index.m_cluster_ends.reserve(m_chars.size());
+    index.m_cluster_chars.reserve(m_chars.size());
+
+    for (auto& run : m_runs)
+    {
+        run.BreakClusterStart = static_cast<u32>(index.m_cluster_ends.size());
+        run.BreakClusterCount = 0;
+        run.BreakClusterEndsSorted = true;
+        if (run.Length == 0 || run.ActualGlyphCount == 0) continue;
+
+        const std::span chars = run.Chars(*this);
+        const std::span char_metas = run.CharMetas(*this);
+        const std::span line_breakpoints = run.LineBreakpoints(*this);
+        const std::span cluster_map = run.ClusterMap(*this);
+        const std::span glyph_props = run.GlyphProps(*this);
+        const std::span glyph_advances = run.GlyphAdvances(*this);
+        const std::span glyph_offsets = run.GlyphOffsets(*this);
+        const std::span cluster_widths = run.ClusterWidths(*this);
+
+        // Same cluster walk as Run::BreakLines
+        double end = 0;
+        i32 c = 0;
+        u8 last_kind = 0;
+        for (;;)
+        {
+            const i32 start_char = c;
+            const u16 first_cluster = cluster_map[c];
+            const i32 next_char = StepCluster(run, cluster_map, first_cluster, c);
+            const u16 last_cluster = cluster_map[c];
+
+            const f32 sum_size = ClusterSize(
+                run, cluster_widths, glyph_props, glyph_advances, glyph_offsets, first_cluster, last_cluster
+            );
+            if (sum_size < 0) run.BreakClusterEndsSorted = false;
+            end += sum_size;
+
+            const auto cluster = static_cast<u32>(index.m_cluster_ends.size());
+            index.m_cluster_ends.push_back(end);
+            index.m_cluster_chars.push_back(start_char);
+
+            const auto& break_info = line_breakpoints[c];
+            const bool can_break =
+                break_info.breakConditionAfter == DWRITE_BREAK_CONDITION_MUST_BREAK
+                || break_info.breakConditionAfter == DWRITE_BREAK_CONDITION_CAN_BREAK;
+            const auto is_space = chars[start_char] == 0x0020;
+            const auto raw = char_metas[start_char].RawType;
+            if (can_break) index.m_breaks.push_back(cluster);
+            if (can_break || is_space) index.m_space_breaks.push_back(cluster);
+            if (raw == RawCharType::LF) index.m_new_lines.push_back(cluster);
+
+            const u8 kind = raw == RawCharType::LF || raw == RawCharType::CR ? 2 : is_space ? 1 : 0;
+            const auto event = can_break || is_space || raw == RawCharType::LF || (start_char != 0 && kind != last_kind);
+            // Filled with the next event below
+            index.m_next_events.push_back(event ? cluster - run.BreakClusterStart : UINT_MAX);
+            last_kind = kind;
+
+            if (next_char >= run.Length) break;
+            c = next_char;
+        }
+
+        run.BreakClusterCount = static_cast<u32>(index.m_cluster_ends.size()) - run.BreakClusterStart;
+        const std::span next_events(index.m_next_events.data() + run.BreakClusterStart, run.BreakClusterCount);
+        u32 next_event = run.BreakClusterCount - 1;
+        for (auto i = next_events.size(); i-- > 0;)
+        {
+            if (next_events[i] != UINT_MAX) next_event = next_events[i];
+            next_events[i] = next_event;
+        }
+    }
+}
+
+void ParagraphData::ComputeIntrinsicSizes()
+{
+    auto& sizes = m_intrinsic_sizes;
+    sizes = {};
+    const auto& index = m_break_index;
+
+    struct LineAcc
+    {
+        ParagraphLineInfo Info{};
+        double Main{};
+        f32 MaxMain{};
+        f32 SumCross{};
+        u32 Lines{};
+
+        void Merge(const ParagraphLineInfo& info)
+        {
+            Info.Ascent = std::max(Info.Ascent, info.Ascent);
+            Info.Descent = std::max(Info.Descent, info.Descent);
+            Info.LineGap = std::max(Info.LineGap, info.LineGap);
+        }
+
+        void Close(const f32 defined_line_height)
+        {
+            MaxMain = std::max(MaxMain, static_cast<f32>(Main));
+            SumCross += Info.CalcSize(defined_line_height);
+            Lines++;
+            Info = {};
+            Main = 0;
+        }
+    };
+
+    LineAcc min{};
+    LineAcc max{};
+    auto& font_metrics = FontMetricsCache::Of(m_text_layout->m_node.ctx->font_manager);
+    const auto& root_style = m_text_layout->m_node.StyleData();
+    f32 defined_line_height = Resolve(GetLineHeight(root_style), root_style.FontSize);
+    for (auto& run : m_runs)
+    {
+        if (run.IsInlineBlock(*this)) return;
+
+        const auto& style = GetScope(m_same_style_ranges[run.StyleRangeIndex]).StyleData();
+        defined_line_height = Resolve(GetLineHeight(style), style.FontSize);
+        if (run.Length == 0 || run.ActualGlyphCount == 0) continue;
+
+        const auto& line_info = run.GetLineInfo(*this, font_metrics);
+        const auto count = run.BreakClusterCount;
+        const auto first = run.BreakClusterStart;
+        const auto last = first + count;
+        const std::span ends(index.m_cluster_ends.data() + first, count);
+
+        max.Merge(line_info);
+        if (style.TextWrap == TextWrap::NoWrap)
+        {
+            // Never breaks inside, not even at LF, same as Run::BreakLines
+            min.Merge(line_info);
+            min.Main += ends[count - 1];
+            max.Main += ends[count - 1];
+            continue;
+        }
+
+        // Wrapping at min-content also breaks before a run that does not start its line
+        if (min.Main > 0) min.Close(defined_line_height);
+        min.Merge(line_info);
+
+        const std::span<const u32> opportunities =
+            HasFlags(style.WrapFlags, WrapFlags::WrapInSpace) ? index.m_space_breaks : index.m_breaks;
+        const auto new_lines = HasFlags(style.WrapFlags, WrapFlags::AllowNewLine)
+            ? std::span<const u32>(index.m_new_lines)
+            : std::span<const u32>();
+        auto opportunity = std::ranges::lower_bound(opportunities, first);
+        auto new_line = std::ranges::lower_bound(new_lines, first);
 
-    #pragma pop_macro("YIELD")
-    #pragma pop_macro("RETURN")
+        double min_origin = 0;
+        double max_origin = 0;
+        for (;;)
+        {
+            const u32 next_opportunity = opportunity != opportunities.end() ? *opportunity : last;
+            const u32 next_new_line = new_line != new_lines.end() ? *new_line : last;
+            const u32 cluster = std::min(std::min(next_opportunity, next_new_line), last);
+            if (cluster >= last) break;
+
+            const auto end = ends[cluster - first];
+            if (cluster == next_new_line)
+            {
+                // A LF always ends its line, even as the last cluster of the run
+                min.Main += end - min_origin;
+                min.Close(defined_line_height);
+                min.Merge(line_info);
+                min_origin = end;
+                max.Main += end - max_origin;
+                max.Close(defined_line_height);
+                max.Merge(line_info);
+                max_origin = end;
+                ++new_line;
+                if (cluster == next_opportunity) ++opportunity;
+                continue;
+            }
+            ++opportunity;
+            // An opportunity after the last cluster is only taken if a later wrapping run has content
+            if (cluster + 1 == last) break;
+            // A LF never overflows, so one right after the opportunity stays on this line
+            if (cluster + 1 == next_new_line) continue;
+            min.Main += end - min_origin;
+            min.Close(defined_line_height);
+            min.Merge(line_info);
+            min_origin = end;
+        }
+        min.Main += ends[count - 1] - min_origin;
+        max.Main += ends[count - 1] - max_origin;
+    }
+    min.Close(defined_line_height);
+    max.Close(defined_line_height);
+
+    sizes = ParagraphIntrinsicSizes{
+        .MinContentMain = min.MaxMain,
+        .MinContentCross = min.SumCross,
+        .MinContentLines = min.Lines,
+        .MaxContentMain = max.MaxMain,
+        .MaxContentCross = max.SumCross,
+        .MaxContentLines = max.Lines,
+        .Valid = true,
+    };
 }
@@ -2,15 +2,21 @@
 
 #include "lib.h"
 #include "Alloc.h"
+#include "Arena.h"
 
-#include <icu.h>
+#include "Icu.h"
 
 #include "Error.h"
+#include "Path.h"
+#include "ShelfAtlas.h"
+#include "Tessellator.h"
+#include "TessCache.h"
 #include "Text.h"
-#include "dwrite/FontFallbackBuilder.h"
 
 #if _WINDOWS
+#include "dwrite/FontFallbackBuilder.h"
 #include "dwrite/Layout.h"
+#include "dwrite/ShapeCache.h"
 #endif
 
 using namespace Coplt;
@@ -64,7 +70,9 @@ HResult LibUi::Impl_CreateAtlasAllocator(AtlasAllocatorType Type, i32 Width, i32
     return feb(
         [&]
         {
-            coplt_ui_new_atlas_allocator(Type, Width, Height, aa);
+            if (Type == AtlasAllocatorType::Shelf) *aa = new ShelfAtlasAllocator(Width, Height);
+            else coplt_ui_new_atlas_allocator(Type, Width, Height, aa);
+            if (*aa == nullptr) return HResultE::InvalidArg;
             return HResultE::Ok;
         }
     );
@@ -155,6 +163,107 @@ HResult LibUi::Impl_SplitTexts(NativeList<TextRange>* ranges, char16 const* char
     );
 }
 
+HResult LibUi::Impl_WarmUpLikelyLocales()
+{
+    return feb(
+        [&]
+        {
+            UnicodeUtils::WarmUpLikelyLocales();
+            return HResultE::Ok;
+        }
+    );
+}
+
+HResult LibUi::Impl_SplitTextsBatch(
+    NativeList<TextRange>* ranges, NativeList<i32>* offsets, Str16 const* inputs, const i32 count, const bool parallel
+)
+{
+    return feb(
+        [&]
+        {
+            Coplt::SplitTextsBatch(*ffi_list(ranges), *ffi_list(offsets), inputs, count, parallel);
+            return HResultE::Ok;
+        }
+    );
+}
+
+void LibUi::Impl_GetArenaStats(u64* used, u64* peak)
+{
+    const auto stats = Arena::GlobalStats();
+    *used = stats.Used;
+    *peak = stats.Peak;
+}
+
+void LibUi::Impl_SetTextMeasureCache(const u32 capacity, const f32 width_quantum)
+{
+    m_text_measure_cache = TextMeasureCacheOptions{
+        .Capacity = std::min(capacity, TextMeasureCache::MaxCapacity),
+        .WidthQuantum = std::max(width_quantum, 0.0f),
+    };
+}
+
+void LibUi::Impl_SetParallelTextLayout(const bool enable)
+{
+    m_parallel_text_layout = enable;
+}
+
+void LibUi::Impl_SetShapeCacheBudget(const u64 bytes)
+{
+#if _WINDOWS
+    LayoutCalc::Texts::ShapeCache::Shared().SetBudget(bytes);
+#endif
+}
+
+void LibUi::Impl_GetShapeCacheStats(u64* hits, u64* misses, u64* evictions, u64* bytes, u32* entries)
+{
+#if _WINDOWS
+    const auto stats = LayoutCalc::Texts::ShapeCache::Shared().Stats();
+    *hits = stats.Hits;
+    *misses = stats.Misses;
+    *evictions = stats.Evictions;
+    *bytes = stats.Bytes;
+    *entries = stats.Entries;
+#else
+    *hits = *misses = *evictions = *bytes = 0;
+    *entries = 0;
+#endif
+}
+
+HResult LibUi::Impl_CreatePathBuilder(IPathBuilder** pb)
+{
+    return feb(
+        [&]
+        {
+            *pb = new PathBuilder();
+            return HResultE::Ok;
+        }
+    );
+}
+
+HResult LibUi::Impl_CreateTessellator(ITessellator** tess)
+{
+    return feb(
+        [&]
+        {
+            *tess = new Tessellator();
+            return HResultE::Ok;
+        }
+    );
+}
+
+HResult LibUi::Impl_CreateTessCache(IFrameSource* fs, ITessCache** cache)
+{
+    return feb(
+        [&] -> HResult
+        {
+            if (fs == nullptr || cache == nullptr) return HResultE::InvalidArg;
+            fs->AddRef();
+            *cache = new TessCache(Rc(fs));
+            return HResultE::Ok;
+        }
+    );
+}
+
 HResultE Coplt::coplt_ui_create_lib(LibLoadInfo* info, ILib** lib)
 {
     return feb(
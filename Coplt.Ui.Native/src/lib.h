@@ -4,6 +4,7 @@
 #include "Defines.h"
 #include "Backend.h"
 #include "FrameSource.h"
+#include "TextLayout.h"
 
 namespace Coplt
 {
@@ -123,6 +124,9 @@ namespace Coplt
     {
         LoggerData m_logger{};
         Rc<TextBackend> m_backend{};
+        LayoutCalc::Texts::TextMeasureCacheOptions m_text_measure_cache{};
+        // Text layout rebuilds analyse and shape paragraphs on the shared thread pool
+        bool m_parallel_text_layout{};
 
         explicit LibUi(LibLoadInfo* info);
 
@@ -161,6 +165,36 @@ namespace Coplt
         COPLT_FORCE_INLINE
         HResult Impl_SplitTexts(NativeList<TextRange>* ranges, char16 const* chars, i32 len);
 
+        COPLT_FORCE_INLINE
+        HResult Impl_WarmUpLikelyLocales();
+
+        COPLT_FORCE_INLINE
+        HResult Impl_SplitTextsBatch(NativeList<TextRange>* ranges, NativeList<i32>* offsets, Str16 const* inputs, i32 count, bool parallel);
+
+        COPLT_FORCE_INLINE
+        void Impl_GetArenaStats(u64* used, u64* peak);
+
+        COPLT_FORCE_INLINE
+        void Impl_SetTextMeasureCache(u32 capacity, f32 width_quantum);
+
+        COPLT_FORCE_INLINE
+        void Impl_SetParallelTextLayout(bool enable);
+
+        COPLT_FORCE_INLINE
+        void Impl_SetShapeCacheBudget(u64 bytes);
+
+        COPLT_FORCE_INLINE
+        void Impl_GetShapeCacheStats(u64* hits, u64* misses, u64* evictions, u64* bytes, u32* entries);
+
+        COPLT_FORCE_INLINE
+        HResult Impl_CreatePathBuilder(IPathBuilder** pb);
+
+        COPLT_FORCE_INLINE
+        HResult Impl_CreateTessellator(ITessellator** tess);
+
+        COPLT_FORCE_INLINE
+        HResult Impl_CreateTessCache(IFrameSource* fs, ITessCache** cache);
+
         COPLT_IMPL_END
     };
 
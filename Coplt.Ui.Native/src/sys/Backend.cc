@@ -0,0 +1,44 @@
+#include "Backend.h"
+
+#include "../Error.h"
+
+using namespace Coplt;
+
+extern "C" HResultE coplt_ui_sys_get_system_font_collection(IFontCollection** out);
+extern "C" HResultE coplt_ui_sys_get_system_font_fallback(IFontFallback** out);
+extern "C" HResultE coplt_ui_sys_create_font_fallback_builder(FontFallbackBuilderCreateInfo const* info, IFontFallbackBuilder** out);
+extern "C" HResultE coplt_ui_sys_create_layout(ILayout** out);
+
+Rc<TextBackend> TextBackend::Create(void* reserved)
+{
+    return Rc(new TextBackend());
+}
+
+Rc<IFontCollection> TextBackend::GetSystemFontCollection() const
+{
+    Rc<IFontCollection> out{};
+    if (const auto hr = coplt_ui_sys_get_system_font_collection(out.put()); hr != HResultE::Ok)
+        throw Exception("Failed to get system font collection");
+    return out;
+}
+
+Rc<IFontFallback> TextBackend::GetSystemFontFallback() const
+{
+    Rc<IFontFallback> out{};
+    if (const auto hr = coplt_ui_sys_get_system_font_fallback(out.put()); hr != HResultE::Ok)
+        throw Exception("Failed to get system font fallback");
+    return out;
+}
+
+Rc<IFontFallbackBuilder> TextBackend::CreateFontFallbackBuilder(const FontFallbackBuilderCreateInfo& info) const
+{
+    Rc<IFontFallbackBuilder> out{};
+    if (const auto hr = coplt_ui_sys_create_font_fallback_builder(&info, out.put()); hr != HResultE::Ok)
+        throw Exception("Failed to create font fallback builder");
+    return out;
+}
+
+HResultE TextBackend::CreateLayout(ILayout** out) const
+{
+    return coplt_ui_sys_create_layout(out);
+}
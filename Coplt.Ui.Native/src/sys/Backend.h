@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../Com.h"
+
+namespace Coplt
+{
+    /// Portable backend, fonts come from the font directories scanned by the rust part
+    struct TextBackend : RefCount<TextBackend>
+    {
+        static Rc<TextBackend> Create(void* reserved);
+
+        Rc<IFontCollection> GetSystemFontCollection() const;
+
+        Rc<IFontFallback> GetSystemFontFallback() const;
+
+        Rc<IFontFallbackBuilder> CreateFontFallbackBuilder(const FontFallbackBuilderCreateInfo& info) const;
+
+        HResultE CreateLayout(ILayout** out) const;
+    };
+}
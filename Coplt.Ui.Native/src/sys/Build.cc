@@ -0,0 +1 @@
+#include "Backend.cc"
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../src/PackedLines.h"
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc;
+
+namespace
+{
+    struct PlacedLines
+    {
+        std::vector<ParagraphSpan> Spans{};
+        std::vector<u32> Runs{};
+        std::vector<ParagraphLine> Lines{};
+    };
+
+    // Spans and lines as line breaking emits them, with a few that do not fit the packed format: inline blocks, very
+    // long spans, huge or non finite sizes, lines skipping a line number and spans jumping back in their run;
+    // packed offsets and sizes are multiples of 1/256 so they survive packing exactly
+    PlacedLines MakeLines(std::mt19937& rng, const i32 span_count)
+    {
+        std::uniform_int_distribution<u32> percent(0, 99);
+        const auto fixed = [&](const u32 max) { return static_cast<f32>(rng() % (max * 256)) / 256; };
+        constexpr f32 font_sizes[] = {12.0f, 14.0f, 20.0f};
+
+        PlacedLines lines{};
+        u32 run = 0, char_end = 0, nth_line = 0, line_start = 0;
+        f32 font_size = font_sizes[0], offset = 0;
+        const auto close_line = [&](const u32 span_end, const u32 line_step)
+        {
+            auto line = ParagraphLine{
+                ParagraphLineInfo{.Ascent = font_size * 0.75f, .Descent = font_size * 0.25f, .LineGap = 1},
+                nth_line, fixed(100), fixed(10000), offset, font_size * 1.25f, line_start, span_end - line_start,
+            };
+            if (percent(rng) < 2) line.CrossSize = std::numeric_limits<f32>::infinity();
+            lines.Lines.push_back(line);
+            line_start = span_end;
+            nth_line += line_step;
+            offset = 0;
+        };
+        for (i32 i = 0; i < span_count; ++i)
+        {
+            if (percent(rng) < 5)
+            {
+                run += 1 + (percent(rng) < 20 ? rng() % 300 : 0);
+                char_end = 0;
+                font_size = font_sizes[rng() % std::size(font_sizes)];
+            }
+            const auto kind = percent(rng);
+            ParagraphSpan span{
+                .NthLine = nth_line,
+                .CharStart = char_end,
+                .CharLength = 1 + rng() % 12,
+                .GlyphStart = char_end,
+                .GlyphLength = 1 + rng() % 12,
+                .Ascent = font_size * 0.75f,
+                .Descent = font_size * 0.25f,
+                .Offset = offset,
+                .Size = fixed(200),
+                .Type = kind % 2 == 0 ? ParagraphSpanType::Common : ParagraphSpanType::Space,
+                .NeedReShape = percent(rng) < 10,
+            };
+            if (kind < 2)
+            {
+                span.Node = NodeId{.Index = rng() % 1000, .IdAndType = rng()};
+                span.InlineBlockIndex = rng() % 10;
+                span.CrossSize = fixed(100);
+                span.Type = ParagraphSpanType::Block;
+            }
+            else if (kind < 3) span.CharLength = 70000;
+            else if (kind < 4) span.Size = std::numeric_limits<f32>::quiet_NaN();
+            else if (kind < 5) span.Size = 1e9f;
+            else if (kind < 6 && span.CharStart > 0) span.CharStart--;
+            else if (kind < 7) span.NeedReShape = true;
+            lines.Spans.push_back(span);
+            lines.Runs.push_back(run);
+            if (span.Type != ParagraphSpanType::Block)
+            {
+                char_end = span.CharStart + span.CharLength;
+                if (std::isfinite(span.Size)) offset += span.Size;
+            }
+            if (percent(rng) < 15) close_line(static_cast<u32>(lines.Spans.size()), percent(rng) < 5 ? 2 : 1);
+            // The next span is on the next line, the line itself is closed later
+            else if (percent(rng) < 3) nth_line++;
+        }
+        close_line(static_cast<u32>(lines.Spans.size()), 1);
+        return lines;
+    }
+
+    void ExpectSameSpan(const ParagraphSpan& e, const ParagraphSpan& a)
+    {
+        EXPECT_EQ(e.NthLine, a.NthLine);
+        EXPECT_EQ(e.Type, a.Type);
+        EXPECT_EQ(e.NeedReShape, a.NeedReShape);
+        if (e.Type == ParagraphSpanType::Block)
+        {
+            EXPECT_EQ(e.Node.Index, a.Node.Index);
+            EXPECT_EQ(e.Node.IdAndType, a.Node.IdAndType);
+            EXPECT_EQ(e.InlineBlockIndex, a.InlineBlockIndex);
+            EXPECT_EQ(e.CrossSize, a.CrossSize);
+        }
+        else
+        {
+            EXPECT_EQ(e.CharStart, a.CharStart);
+            EXPECT_EQ(e.CharLength, a.CharLength);
+            EXPECT_EQ(e.GlyphStart, a.GlyphStart);
+            EXPECT_EQ(e.GlyphLength, a.GlyphLength);
+            EXPECT_EQ(e.Ascent, a.Ascent);
+            EXPECT_EQ(e.Descent, a.Descent);
+        }
+        EXPECT_EQ(e.Offset, a.Offset);
+        if (std::isnan(e.Size)) EXPECT_TRUE(std::isnan(a.Size));
+        else EXPECT_EQ(e.Size, a.Size);
+    }
+
+    void ExpectSameLine(const ParagraphLine& e, const ParagraphLine& a)
+    {
+        EXPECT_EQ(e.Ascent, a.Ascent);
+        EXPECT_EQ(e.Descent, a.Descent);
+        EXPECT_EQ(e.LineGap, a.LineGap);
+        EXPECT_EQ(e.MinSize, a.MinSize);
+        EXPECT_EQ(e.NthLine, a.NthLine);
+        EXPECT_EQ(e.MainOffset, a.MainOffset);
+        EXPECT_EQ(e.CrossOffset, a.CrossOffset);
+        EXPECT_EQ(e.MainSize, a.MainSize);
+        EXPECT_EQ(e.CrossSize, a.CrossSize);
+        EXPECT_EQ(e.SpanStart, a.SpanStart);
+        EXPECT_EQ(e.SpanLength, a.SpanLength);
+    }
+
+    void ExpectUnpacks(const PackedLines& packed, const PlacedLines& lines)
+    {
+        std::vector<ParagraphSpan> spans{};
+        std::vector<u32> runs{};
+        std::vector<ParagraphLine> unpacked_lines{};
+        packed.Unpack(spans, runs, unpacked_lines);
+        ASSERT_EQ(lines.Spans.size(), spans.size());
+        ASSERT_EQ(lines.Lines.size(), unpacked_lines.size());
+        EXPECT_EQ(lines.Runs, runs);
+        for (usize i = 0; i < spans.size(); ++i)
+        {
+            SCOPED_TRACE(testing::Message() << "span " << i);
+            ExpectSameSpan(lines.Spans[i], spans[i]);
+        }
+        for (usize i = 0; i < unpacked_lines.size(); ++i)
+        {
+            SCOPED_TRACE(testing::Message() << "line " << i);
+            ExpectSameLine(lines.Lines[i], unpacked_lines[i]);
+        }
+    }
+}
+
+TEST(PackedLines, UnpackGivesBackWhatWasPacked)
+{
+    std::mt19937 rng(42);
+    for (i32 i = 0; i < 20; ++i)
+    {
+        const auto lines = MakeLines(rng, 2000);
+        const auto packed = PackedLines::Pack(lines.Spans, lines.Runs, lines.Lines);
+        EXPECT_EQ(packed.SpanCount(), lines.Spans.size());
+        EXPECT_EQ(packed.LineCount(), lines.Lines.size());
+        EXPECT_FALSE(packed.m_wide_spans.empty());
+        EXPECT_FALSE(packed.m_wide_lines.empty());
+        ExpectUnpacks(packed, lines);
+        if (HasFailure()) return;
+    }
+}
+
+// ParagraphData packs its lines a few at a time, as layouts place them
+TEST(PackedLines, AddingLineByLineMatchesPack)
+{
+    std::mt19937 rng(7);
+    const auto lines = MakeLines(rng, 3000);
+    PackedLines packed{};
+    u32 span = 0;
+    for (const auto& line : lines.Lines)
+    {
+        for (; span < line.SpanStart + line.SpanLength; ++span) packed.AddSpan(lines.Spans[span], lines.Runs[span]);
+        packed.AddLine(line);
+    }
+    ExpectUnpacks(packed, lines);
+
+    packed.Clear();
+    EXPECT_EQ(packed.SpanCount(), 0u);
+    EXPECT_EQ(packed.LineCount(), 0u);
+    EXPECT_TRUE(packed.m_infos.empty());
+    const auto repacked = MakeLines(rng, 500);
+    for (usize i = 0; i < repacked.Spans.size(); ++i) packed.AddSpan(repacked.Spans[i], repacked.Runs[i]);
+    for (const auto& line : repacked.Lines) packed.AddLine(line);
+    ExpectUnpacks(packed, repacked);
+}
+
+TEST(PackedLines, ToLineDataMatchesTheUnpackedLines)
+{
+    std::mt19937 rng(3);
+    const auto lines = MakeLines(rng, 2000);
+    const auto packed = PackedLines::Pack(lines.Spans, lines.Runs, lines.Lines);
+    std::vector<u32> run_starts(lines.Runs.back() + 1), run_nodes(lines.Runs.back() + 1);
+    for (usize r = 0; r < run_starts.size(); ++r)
+    {
+        run_starts[r] = static_cast<u32>(r * 1000);
+        run_nodes[r] = static_cast<u32>(r % 7);
+    }
+
+    for (const auto direction : {WritingDirection::Horizontal, WritingDirection::Vertical})
+    {
+        SCOPED_TRACE(testing::Message() << "direction " << static_cast<i32>(direction));
+        const auto is_row = direction == WritingDirection::Horizontal;
+        std::vector<LineData> line_datas{};
+        std::vector<LineSpanData> span_datas{};
+        packed.ToLineData(direction, run_starts, run_nodes, line_datas, span_datas);
+        ASSERT_EQ(span_datas.size(), lines.Spans.size());
+        ASSERT_EQ(line_datas.size(), lines.Lines.size());
+
+        for (usize i = 0; i < span_datas.size(); ++i)
+        {
+            SCOPED_TRACE(testing::Message() << "span " << i);
+            const auto& span = lines.Spans[i];
+            const auto& data = span_datas[i];
+            const auto run = lines.Runs[i];
+            const auto is_block = span.Type == ParagraphSpanType::Block;
+            const auto cross_size = is_block ? span.CrossSize : span.Ascent + span.Descent;
+            EXPECT_EQ(data.X, is_row ? span.Offset : 0);
+            EXPECT_EQ(data.Y, is_row ? 0 : span.Offset);
+            if (std::isnan(span.Size)) EXPECT_TRUE(std::isnan(is_row ? data.Width : data.Height));
+            else EXPECT_EQ(is_row ? data.Width : data.Height, span.Size);
+            EXPECT_EQ(is_row ? data.Height : data.Width, cross_size);
+            EXPECT_EQ(data.BaseLine, is_block ? cross_size : span.Ascent);
+            EXPECT_EQ(data.NthLine, span.NthLine);
+            EXPECT_EQ(data.NodeIndex, run_nodes[run]);
+            EXPECT_EQ(data.RunRange, run);
+            EXPECT_EQ(data.Start, is_block ? run_starts[run] : run_starts[run] + span.CharStart);
+            EXPECT_EQ(data.End, is_block ? run_starts[run] : run_starts[run] + span.CharStart + span.CharLength);
+            switch (span.Type)
+            {
+            case ParagraphSpanType::Common:
+                EXPECT_EQ(data.Type, LineSpanType::Text);
+                break;
+            case ParagraphSpanType::Space:
+                EXPECT_EQ(data.Type, LineSpanType::Space);
+                break;
+            case ParagraphSpanType::NewLine:
+                EXPECT_EQ(data.Type, LineSpanType::NewLine);
+                break;
+            case ParagraphSpanType::Block:
+                EXPECT_EQ(data.Type, LineSpanType::Object);
+                break;
+            }
+        }
+
+        for (usize i = 0; i < line_datas.size(); ++i)
+        {
+            SCOPED_TRACE(testing::Message() << "line " << i);
+            const auto& line = lines.Lines[i];
+            const auto& data = line_datas[i];
+            EXPECT_EQ(data.X, is_row ? line.MainOffset : line.CrossOffset);
+            EXPECT_EQ(data.Y, is_row ? line.CrossOffset : line.MainOffset);
+            EXPECT_EQ(data.Width, is_row ? line.MainSize : line.CrossSize);
+            EXPECT_EQ(data.Height, is_row ? line.CrossSize : line.MainSize);
+            EXPECT_EQ(data.BaseLine, line.Ascent);
+            EXPECT_EQ(data.NthLine, line.NthLine);
+            EXPECT_EQ(data.SpanStart, line.SpanStart);
+            EXPECT_EQ(data.SpanEnd, line.SpanStart + line.SpanLength);
+        }
+        if (HasFailure()) return;
+    }
+}
+
+TEST(PackedLines, SpansOutOfRunOrderAreRejected)
+{
+    PackedLines packed{};
+    packed.AddSpan(ParagraphSpan{.NthLine = 0, .CharStart = 0, .CharLength = 1}, 2);
+    EXPECT_THROW(packed.AddSpan(ParagraphSpan{.NthLine = 0, .CharStart = 0, .CharLength = 1}, 1), Exception);
+    const std::vector<ParagraphSpan> spans(2);
+    const std::vector<u32> runs(1);
+    EXPECT_THROW(PackedLines::Pack(spans, runs, {}), Exception);
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../src/dwrite/TextLayout.h"
+
+using namespace Coplt;
+using namespace Coplt::LayoutCalc::Texts;
+
+namespace
+{
+    // Shaped paragraph made up without dwrite, with spaces, LF, CR, ligatures, combining marks and CJK like breaks
+    struct TestParagraph
+    {
+        Rc<TextLayout> Layout{new TextLayout()};
+        ParagraphData Data{Layout.get()};
+        std::vector<StyleData> Styles{};
+
+        // Quarter pixel advances sum without rounding, so both ways of breaking give the same offsets bit for bit
+        TestParagraph(std::mt19937& rng, const bool exact_advances, const bool negative_advances)
+        {
+            std::uniform_int_distribution<u32> percent(0, 99);
+            std::uniform_real_distribution<f32> fraction(3.0f, 14.0f);
+            const auto advance = [&]
+            {
+                if (negative_advances && percent(rng) < 3) return -3.0f;
+                return exact_advances ? static_cast<f32>(4 + rng() % 40) / 4 : fraction(rng);
+            };
+
+            const auto runs = 1 + rng() % 4;
+            for (u32 r = 0; r < runs; ++r)
+            {
+                const u32 length = 1 + rng() % (rng() % 4 == 0 ? 3000 : 200);
+                std::vector<u16> cluster_map{};
+                std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> text_props{};
+                std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> glyph_props{};
+                std::vector<f32> advances{};
+                std::vector<DWRITE_GLYPH_OFFSET> offsets{};
+                const auto add_glyph = [&](const bool cluster_start)
+                {
+                    glyph_props.push_back(DWRITE_SHAPING_GLYPH_PROPERTIES{.isClusterStart = cluster_start});
+                    advances.push_back(cluster_start ? advance() : 1.0f);
+                    offsets.push_back(DWRITE_GLYPH_OFFSET{.advanceOffset = cluster_start ? 0.0f : -0.5f});
+                };
+                const auto add_char = [&](const char16 c, const RawCharType raw, const DWRITE_BREAK_CONDITION after)
+                {
+                    Data.m_chars.push_back(c);
+                    Data.m_char_metas.push_back(CharMeta{.RawType = raw});
+                    Data.m_line_breakpoints.push_back(DWRITE_LINE_BREAKPOINT{.breakConditionAfter = static_cast<u8>(after)});
+                    cluster_map.push_back(static_cast<u16>(advances.size() - 1));
+                    text_props.push_back(DWRITE_SHAPING_TEXT_PROPERTIES{.canBreakShapingAfter = percent(rng) < 50});
+                };
+
+                const auto start = static_cast<u32>(Data.m_chars.size());
+                for (u32 i = 0; i < length; ++i)
+                {
+                    const auto kind = percent(rng);
+                    add_glyph(true);
+                    // A LF that ends a run is left out, the cluster walk emits an empty span after it
+                    if (kind < 15) add_char(u' ', RawCharType::AsIs, DWRITE_BREAK_CONDITION_CAN_BREAK);
+                    else if (kind < 17 && i + 1 < length) add_char(u'\n', RawCharType::LF, DWRITE_BREAK_CONDITION_MUST_BREAK);
+                    else if (kind < 18) add_char(u'\r', RawCharType::CR, DWRITE_BREAK_CONDITION_MAY_NOT_BREAK);
+                    else if (kind < 19) add_char(u'\t', RawCharType::HT, DWRITE_BREAK_CONDITION_MAY_NOT_BREAK);
+                    else if (kind < 24) add_char(u'\u5b57', RawCharType::AsIs, DWRITE_BREAK_CONDITION_CAN_BREAK);
+                    else add_char(u'a', RawCharType::AsIs, DWRITE_BREAK_CONDITION_MAY_NOT_BREAK);
+                    // Ligature, two chars share one glyph
+                    if (kind >= 90 && kind < 95 && i + 1 < length)
+                    {
+                        add_char(u'b', RawCharType::AsIs, DWRITE_BREAK_CONDITION_MAY_NOT_BREAK);
+                        ++i;
+                    }
+                    // Combining mark, one char with two glyphs
+                    else if (kind >= 95) add_glyph(false);
+                }
+
+                const auto glyph_count = static_cast<u32>(advances.size());
+                auto& glyphs = Data.m_glyphs;
+                const auto cluster_start = glyphs.AddChars(static_cast<u32>(cluster_map.size()));
+                const auto glyph_start = glyphs.AddGlyphs(glyph_count);
+                std::ranges::copy(cluster_map, glyphs.m_cluster_map + cluster_start);
+                std::ranges::copy(text_props, glyphs.m_text_props + cluster_start);
+                std::ranges::copy(glyph_props, glyphs.m_glyph_props + glyph_start);
+                std::ranges::copy(advances, glyphs.m_glyph_advances + glyph_start);
+                std::ranges::copy(offsets, glyphs.m_glyph_offsets + glyph_start);
+                std::ranges::fill_n(glyphs.m_glyph_indices + glyph_start, glyph_count, u16{});
+                glyphs.ComputeClusterWidths(glyph_start, glyph_count);
+
+                Data.m_runs.push_back(
+                    Run{
+                        .Start = start,
+                        .Length = static_cast<u32>(Data.m_chars.size()) - start,
+                        .ClusterStartIndex = cluster_start,
+                        .GlyphStartIndex = glyph_start,
+                        .ActualGlyphCount = glyph_count,
+                    }
+                );
+                StyleData style{};
+                style.TextWrap = percent(rng) < 10 ? TextWrap::NoWrap : TextWrap::Wrap;
+                style.WrapFlags = static_cast<WrapFlags>(rng() % 4);
+                Styles.push_back(style);
+            }
+            Data.BuildBreakIndex();
+        }
+
+        // Breaks every run in order like ParagraphData::BreakLinesUntil, stopping every line or two if resume is set
+        std::vector<ParagraphSpan> BreakLines(const f32 width, const bool use_index, const bool resume)
+        {
+            std::vector<ParagraphSpan> spans{};
+            RunBreakLineCtx ctx{.AvailableSpace = width, .UseBreakIndex = use_index};
+            const ParagraphLineInfo line_info{.Ascent = 10, .Descent = 3};
+            for (usize r = 0; r < Data.m_runs.size(); ++r)
+            {
+                const auto& run = Data.m_runs[r];
+                if (!resume)
+                {
+                    run.BreakLines(Data, Styles[r], ctx, line_info, spans);
+                    continue;
+                }
+                RunBreakLineState state{};
+                for (u32 stop = 1;; stop = 3 - stop)
+                {
+                    ctx.StopLine = (state.Started ? state.NthLine : ctx.NthLine) + stop;
+                    if (run.BreakLines(Data, Styles[r], ctx, line_info, spans, state)) break;
+                }
+                ctx.StopLine = std::numeric_limits<u32>::max();
+            }
+            return spans;
+        }
+    };
+
+    void ExpectSameSpans(
+        const std::vector<ParagraphSpan>& expected, const std::vector<ParagraphSpan>& actual, const f32 width,
+        const bool exact_advances
+    )
+    {
+        ASSERT_EQ(expected.size(), actual.size()) << "width " << width;
+        for (usize i = 0; i < expected.size(); ++i)
+        {
+            const auto& e = expected[i];
+            const auto& a = actual[i];
+            SCOPED_TRACE(testing::Message() << "width " << width << " span " << i);
+            ASSERT_EQ(e.NthLine, a.NthLine);
+            ASSERT_EQ(e.CharStart, a.CharStart);
+            ASSERT_EQ(e.CharLength, a.CharLength);
+            ASSERT_EQ(e.GlyphStart, a.GlyphStart);
+            ASSERT_EQ(e.GlyphLength, a.GlyphLength);
+            ASSERT_EQ(e.Type, a.Type);
+            ASSERT_EQ(e.NeedReShape, a.NeedReShape);
+            // Skipped clusters are summed in double instead of one by one in f32
+            const auto tolerance = exact_advances ? 0.0f : 1e-3f * std::max(1.0f, std::abs(e.Offset) + std::abs(e.Size));
+            ASSERT_NEAR(e.Offset, a.Offset, tolerance);
+            ASSERT_NEAR(e.Size, a.Size, tolerance);
+        }
+    }
+
+    // Lines as ParagraphData::BreakLinesUntil closes them, every span of a line has its NthLine
+    std::vector<std::pair<u32, f32>> LineEnds(const std::vector<ParagraphSpan>& spans)
+    {
+        std::vector<std::pair<u32, f32>> lines{};
+        for (usize i = 0; i < spans.size(); ++i)
+        {
+            if (i + 1 < spans.size() && spans[i + 1].NthLine == spans[i].NthLine) continue;
+            lines.emplace_back(spans[i].NthLine, spans[i].Offset + spans[i].Size);
+        }
+        return lines;
+    }
+}
+
+TEST(BreakLines, BreakIndexMatchesClusterWalk)
+{
+    std::mt19937 rng(42);
+    for (i32 i = 0; i < 150; ++i)
+    {
+        const auto exact_advances = i % 2 == 0;
+        TestParagraph paragraph(rng, exact_advances, i % 7 == 0);
+        for (i32 w = 0; w < 16; ++w)
+        {
+            const auto width = w == 0
+                ? std::numeric_limits<f32>::infinity()
+                : exact_advances
+                ? static_cast<f32>(rng() % 800)
+                : std::uniform_real_distribution<f32>(0, 800)(rng);
+            const auto walked = paragraph.BreakLines(width, false, false);
+            const auto indexed = paragraph.BreakLines(width, true, false);
+            ExpectSameSpans(walked, indexed, width, exact_advances);
+            ExpectSameSpans(walked, paragraph.BreakLines(width, true, true), width, exact_advances);
+
+            const auto walked_lines = LineEnds(walked);
+            const auto indexed_lines = LineEnds(indexed);
+            ASSERT_EQ(walked_lines.size(), indexed_lines.size()) << "width " << width;
+            for (usize l = 0; l < walked_lines.size(); ++l)
+            {
+                ASSERT_EQ(walked_lines[l].first, indexed_lines[l].first);
+                ASSERT_NEAR(walked_lines[l].second, indexed_lines[l].second, exact_advances ? 0.0f : 0.1f);
+            }
+            if (HasFailure()) return;
+        }
+    }
+}
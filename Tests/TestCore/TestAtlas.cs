@@ -0,0 +1,49 @@
+﻿using Coplt.UI.Core.Geometry;
+
+namespace TestCore;
+
+public class TestAtlas
+{
+    [Test]
+    public void TestShelfHeightNotMultipleOfQuantum([Values(1, 3, 10, 61)] int height)
+    {
+        // Height classes round up to 4px, the last one of such an atlas is cut short by it
+        for (var h = 1; h <= height; h++)
+        {
+            using var atlas = new AtlasAllocator(16, height, AtlasAllocatorType.Shelf);
+            Assert.That(atlas.Allocate(3, h, out var id, out var rect), Is.True);
+            Assert.That(rect, Is.EqualTo(new AABB2DI { MinX = 0, MinY = 0, MaxX = 3, MaxY = h }));
+            atlas.Deallocate(id);
+            Assert.That(atlas.IsEmpty, Is.True);
+        }
+    }
+
+    [Test]
+    public void TestShelfNoOverlap()
+    {
+        using var atlas = new AtlasAllocator(64, 50, AtlasAllocatorType.Shelf);
+        var rand = new Random(7);
+        var live = new Dictionary<AtlasAllocator.AllocId, AABB2DI>();
+        for (var n = 0; n < 2000; n++)
+        {
+            if (live.Count > 0 && rand.Next(3) == 0)
+            {
+                var id = live.Keys.ElementAt(rand.Next(live.Count));
+                atlas.Deallocate(id);
+                live.Remove(id);
+                continue;
+            }
+            var (w, h) = (rand.Next(1, 20), rand.Next(1, 20));
+            if (!atlas.Allocate(w, h, out var new_id, out var r)) continue;
+            Assert.That((r.MaxX - r.MinX, r.MaxY - r.MinY), Is.EqualTo((w, h)));
+            Assert.That(r.MinX >= 0 && r.MinY >= 0 && r.MaxX <= 64 && r.MaxY <= 50, Is.True);
+            foreach (var o in live.Values)
+            {
+                Assert.That(r.MaxX <= o.MinX || o.MaxX <= r.MinX || r.MaxY <= o.MinY || o.MaxY <= r.MinY, Is.True);
+            }
+            live.Add(new_id, r);
+        }
+        foreach (var id in live.Keys) atlas.Deallocate(id);
+        Assert.That(atlas.IsEmpty, Is.True);
+    }
+}
@@ -0,0 +1,290 @@
+﻿using Coplt.Com;
+using Coplt.UI.Core.Geometry;
+using Coplt.UI.Core.Geometry.Native;
+using Coplt.UI.Miscellaneous;
+using Coplt.UI.Native;
+
+namespace TestCore;
+
+public unsafe class TestGeometry
+{
+    private static Rc<IPath> Build(Rc<IPathBuilder> builder)
+    {
+        IPath* path;
+        Assert.That(builder.Build(&path).IsSuccess, Is.True);
+        return new(path);
+    }
+
+    private static Rc<IPath> Polyline(bool close, params (float X, float Y)[] points)
+    {
+        using var builder = NativeLib.Instance.CreatePathBuilder();
+        builder.MoveTo(points[0].X, points[0].Y);
+        foreach (var (x, y) in points.AsSpan(1)) builder.LineTo(x, y);
+        if (close) builder.Close();
+        return Build(builder);
+    }
+
+    private static Rc<IPath> Rect(float x, float y, float w, float h) =>
+        Polyline(true, (x, y), (x + w, y), (x + w, y + h), (x, y + h));
+
+    private static ((float X, float Y)[] Vertices, uint[] Indices) MeshOf(Rc<ITessellator> tess)
+    {
+        float* vertices;
+        uint* indices;
+        int vertex_count, index_count;
+        tess.GetMesh(&vertices, &vertex_count, &indices, &index_count);
+        var points = new (float X, float Y)[vertex_count];
+        for (var i = 0; i < vertex_count; i++) points[i] = (vertices[i * 2], vertices[i * 2 + 1]);
+        return (points, new ReadOnlySpan<uint>(indices, index_count).ToArray());
+    }
+
+    // Twice the signed area summed over the triangles
+    private static float AreaOf((float X, float Y)[] vertices, ReadOnlySpan<uint> indices)
+    {
+        var area = 0f;
+        for (var i = 0; i < indices.Length; i += 3)
+        {
+            var (a, b, c) = (vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]]);
+            area += MathF.Abs((b.X - a.X) * (c.Y - a.Y) - (c.X - a.X) * (b.Y - a.Y));
+        }
+        return area / 2;
+    }
+
+    [Test]
+    public void TestPathAABB()
+    {
+        using var rect = Rect(-2, 3, 10, 5);
+        AABB2DF aabb;
+        rect.CalcAABB(&aabb);
+        Assert.That(aabb, Is.EqualTo(new AABB2DF { MinX = -2, MinY = 3, MaxX = 8, MaxY = 8 }));
+
+        using var builder = NativeLib.Instance.CreatePathBuilder();
+        builder.MoveTo(15, 10);
+        builder.Arc(10, 10, 5, 5, MathF.Tau, 0);
+        builder.Close();
+        using var circle = Build(builder);
+        circle.CalcAABB(&aabb);
+        Assert.That(aabb.MinX, Is.EqualTo(5).Within(1e-3f));
+        Assert.That(aabb.MinY, Is.EqualTo(5).Within(1e-3f));
+        Assert.That(aabb.MaxX, Is.EqualTo(15).Within(1e-3f));
+        Assert.That(aabb.MaxY, Is.EqualTo(15).Within(1e-3f));
+
+        // A builder is reusable and starts empty after Build
+        builder.MoveTo(1, 1);
+        builder.LineTo(2, 4);
+        using var line = Build(builder);
+        line.CalcAABB(&aabb);
+        Assert.That(aabb, Is.EqualTo(new AABB2DF { MinX = 1, MinY = 1, MaxX = 2, MaxY = 4 }));
+    }
+
+    [Test]
+    public void TestFillRect()
+    {
+        using var rect = Rect(0, 0, 10, 5);
+        using var tess = NativeLib.Instance.CreateTessellator();
+        var options = new TessFillOptions();
+        Assert.That(tess.Fill(rect.Handle, &options).IsSuccess, Is.True);
+        var (vertices, indices) = MeshOf(tess);
+        Assert.That(vertices, Is.EquivalentTo(new (float, float)[] { (0, 0), (10, 0), (10, 5), (0, 5) }));
+        Assert.That(indices, Has.Length.EqualTo(6));
+        Assert.That(AreaOf(vertices, indices), Is.EqualTo(50).Within(1e-3f));
+    }
+
+    [Test]
+    public void TestStrokeSegment()
+    {
+        using var segment = Polyline(false, (0, 0), (10, 0));
+        using var tess = NativeLib.Instance.CreateTessellator();
+        var options = new TessStrokeOptions { LineWidth = 2 };
+        Assert.That(tess.Stroke(segment.Handle, &options).IsSuccess, Is.True);
+        var (vertices, indices) = MeshOf(tess);
+        // Butt caps, so just the quad around the segment
+        Assert.That(vertices, Is.EquivalentTo(new (float, float)[] { (0, -1), (10, -1), (10, 1), (0, 1) }));
+        Assert.That(indices, Has.Length.EqualTo(6));
+        Assert.That(AreaOf(vertices, indices), Is.EqualTo(20).Within(1e-3f));
+
+        // Clear empties the mesh
+        tess.Clear();
+        Assert.That(MeshOf(tess).Vertices, Is.Empty);
+    }
+
+    private static Rc<ITessMesh> CacheFill(Rc<ITessCache> cache, Rc<IPath> path, float tolerance = 0.1f)
+    {
+        var options = new TessFillOptions { ToLerance = tolerance };
+        ITessMesh* mesh;
+        Assert.That(cache.Fill(path.Handle, &options, &mesh).IsSuccess, Is.True);
+        return new(mesh);
+    }
+
+    private static (ulong Hits, ulong Misses, ulong Evictions, ulong Bytes, uint Entries) StatsOf(Rc<ITessCache> cache)
+    {
+        ulong hits, misses, evictions, bytes;
+        uint entries;
+        cache.GetStats(&hits, &misses, &evictions, &bytes, &entries);
+        return (hits, misses, evictions, bytes, entries);
+    }
+
+    [Test]
+    public void TestTessCacheHit()
+    {
+        using var fs = new FrameSource();
+        using var cache = NativeLib.Instance.CreateTessCache(fs);
+        using var a = Rect(0, 0, 10, 5);
+        using var b = Rect(0, 0, 10, 5);
+        using var c = Rect(0, 0, 10, 6);
+
+        using var m0 = CacheFill(cache, a);
+        // Same content in another path object, and a tolerance in the same power of two bucket
+        using var m1 = CacheFill(cache, b);
+        using var m2 = CacheFill(cache, a, 0.12f);
+        using var m3 = CacheFill(cache, c);
+        Assert.That((nint)m1.Handle, Is.EqualTo((nint)m0.Handle));
+        Assert.That((nint)m2.Handle, Is.EqualTo((nint)m0.Handle));
+        Assert.That((nint)m3.Handle, Is.Not.EqualTo((nint)m0.Handle));
+
+        var options = new TessStrokeOptions();
+        ITessMesh* stroke;
+        Assert.That(cache.Stroke(a.Handle, &options, &stroke).IsSuccess, Is.True);
+        using var m4 = new Rc<ITessMesh>(stroke);
+        Assert.That((nint)m4.Handle, Is.Not.EqualTo((nint)m0.Handle));
+
+        float* vertices;
+        uint* indices;
+        int vertex_count, index_count;
+        m0.GetData(&vertices, &vertex_count, &indices, &index_count);
+        Assert.That((vertex_count, index_count), Is.EqualTo((4, 6)));
+
+        var stats = StatsOf(cache);
+        Assert.That((stats.Hits, stats.Misses, stats.Entries), Is.EqualTo((2ul, 3ul, 3u)));
+
+        // A disabled cache still tessellates, but keeps nothing
+        cache.SetBudget(0);
+        Assert.That(StatsOf(cache).Entries, Is.EqualTo(0u));
+        using var m5 = CacheFill(cache, a);
+        Assert.That(StatsOf(cache).Entries, Is.EqualTo(0u));
+    }
+
+    [Test]
+    public void TestTessCacheEviction()
+    {
+        using var fs = new FrameSource();
+        using var cache = NativeLib.Instance.CreateTessCache(fs);
+        fs.Data = new() { NthFrame = 1 };
+        using var a = Rect(0, 0, 10, 5);
+        using var b = Rect(0, 0, 20, 5);
+        using var c = Rect(0, 0, 30, 5);
+        CacheFill(cache, a).Dispose();
+        var one = StatsOf(cache).Bytes;
+
+        // Over the budget, but everything is used in the current frame so nothing goes before Collect
+        cache.SetBudget(one);
+        CacheFill(cache, b).Dispose();
+        CacheFill(cache, c).Dispose();
+        Assert.That(StatsOf(cache).Entries, Is.EqualTo(3u));
+
+        fs.Data = new() { NthFrame = 2 };
+        cache.Collect();
+        var stats = StatsOf(cache);
+        Assert.That((stats.Entries, stats.Evictions), Is.EqualTo((1u, 2ul)));
+        Assert.That(stats.Bytes, Is.LessThanOrEqualTo(one));
+
+        // The most recently used one is kept
+        CacheFill(cache, c).Dispose();
+        Assert.That(StatsOf(cache).Hits, Is.EqualTo(1ul));
+    }
+
+    [Test]
+    public void TestTessCacheFrameRetention()
+    {
+        using var fs = new FrameSource();
+        using var cache = NativeLib.Instance.CreateTessCache(fs);
+        using var a = Rect(0, 0, 10, 5);
+        using var b = Rect(0, 0, 20, 5);
+        cache.SetExpireFrame(5);
+        for (var frame = 0ul; frame < 10; frame++)
+        {
+            fs.Data = new() { NthFrame = frame };
+            CacheFill(cache, a).Dispose();
+            if (frame < 3) CacheFill(cache, b).Dispose();
+        }
+        Assert.That(StatsOf(cache).Entries, Is.EqualTo(2u));
+
+        // b was last used 7 frames ago, a in this one
+        cache.Collect();
+        Assert.That(StatsOf(cache).Entries, Is.EqualTo(1u));
+        CacheFill(cache, a).Dispose();
+        var stats = StatsOf(cache);
+        Assert.That((stats.Hits, stats.Misses), Is.EqualTo((12ul, 2ul)));
+    }
+
+    private static Rc<IPath> Circle(float cx, float cy, float r)
+    {
+        using var builder = NativeLib.Instance.CreatePathBuilder();
+        builder.MoveTo(cx + r, cy);
+        builder.Arc(cx, cy, r, r, MathF.Tau, 0);
+        builder.Close();
+        return Build(builder);
+    }
+
+    [Test]
+    public void TestTessBatch([Values(false, true)] bool stroke, [Values(false, true)] bool parallel)
+    {
+        const int Count = 200;
+        var paths = new Rc<IPath>[Count];
+        var handles = new IPath*[Count];
+        var fill_options = new TessFillOptions[Count];
+        var stroke_options = new TessStrokeOptions[Count];
+        try
+        {
+            for (var i = 0; i < Count; i++)
+            {
+                paths[i] = i % 3 == 0 ? Circle(i, i, 1 + i % 7) : Rect(i, -i, 1 + i % 5, 2 + i % 3);
+                handles[i] = paths[i].Handle;
+                fill_options[i] = new() { FillRule = i % 2 == 0 ? FillRule.EvenOdd : FillRule.NonZero };
+                stroke_options[i] = new() { LineWidth = 1 + i % 4, LineJoin = i % 2 == 0 ? LineJoin.Miter : LineJoin.Round };
+            }
+
+            using var tess = NativeLib.Instance.CreateTessellator();
+            using var single = NativeLib.Instance.CreateTessellator();
+            // Batches append to what is already in the mesh
+            var first = fill_options[1];
+            Assert.That(tess.Fill(handles[1], &first).IsSuccess, Is.True);
+            var vertex_offsets = new uint[Count + 1];
+            var index_offsets = new uint[Count + 1];
+            fixed (IPath** p_paths = handles)
+            fixed (TessFillOptions* p_fill = fill_options)
+            fixed (TessStrokeOptions* p_stroke = stroke_options)
+            fixed (uint* p_vertex_offsets = vertex_offsets)
+            fixed (uint* p_index_offsets = index_offsets)
+            {
+                var hr = stroke
+                    ? tess.StrokeBatch(p_paths, p_stroke, Count, p_vertex_offsets, p_index_offsets, parallel)
+                    : tess.FillBatch(p_paths, p_fill, Count, p_vertex_offsets, p_index_offsets, parallel);
+                Assert.That(hr.IsSuccess, Is.True);
+            }
+            var (vertices, indices) = MeshOf(tess);
+            Assert.That(vertex_offsets[0], Is.EqualTo(4u));
+            Assert.That(index_offsets[0], Is.EqualTo(6u));
+            Assert.That(vertex_offsets[Count], Is.EqualTo((uint)vertices.Length));
+            Assert.That(index_offsets[Count], Is.EqualTo((uint)indices.Length));
+
+            // Every shape is the mesh a Fill or Stroke of it alone gives, indices rebased to its vertices
+            for (var i = 0; i < Count; i++)
+            {
+                single.Clear();
+                var fill = fill_options[i];
+                var line = stroke_options[i];
+                Assert.That((stroke ? single.Stroke(handles[i], &line) : single.Fill(handles[i], &fill)).IsSuccess, Is.True);
+                var (expected_vertices, expected_indices) = MeshOf(single);
+                var (vs, ve) = ((int)vertex_offsets[i], (int)vertex_offsets[i + 1]);
+                var (@is, ie) = ((int)index_offsets[i], (int)index_offsets[i + 1]);
+                Assert.That(vertices[vs..ve], Is.EqualTo(expected_vertices), $"shape {i}");
+                Assert.That(indices[@is..ie], Is.EqualTo(expected_indices.Select(a => a + (uint)vs)), $"shape {i}");
+            }
+        }
+        finally
+        {
+            foreach (var path in paths) path.Dispose();
+        }
+    }
+}
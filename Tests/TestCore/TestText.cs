@@ -1,4 +1,6 @@
-﻿using Coplt.UI.Collections;
+﻿using System.Runtime.InteropServices;
+using Coplt.Com;
+using Coplt.UI.Collections;
 using Coplt.UI.Native;
 using Coplt.UI.Texts;
 
@@ -20,4 +22,111 @@ public unsafe class TestText
             Console.WriteLine($"{range} ; {str.Substring(range.Start, range.Length)}");
         }
     }
+
+    [Test]
+    public void TestSplitMatchesPerCodePoint()
+    {
+        // The ascii fast path skips whole runs at once, while a single code point always takes the plain icu
+        // classification, so merging the ranges of every code point on its own must give the same output
+        string[] pieces =
+        [
+            "hello", "World ", "ABC", "12345", " ", "\t\n", "!?,.", "abcdefghijklmnopqrstuvwxyz", "阿斯顿",
+            "ياخشىمۇسىز", "😊", "こんにちは", "\ud800", "é", "́",
+        ];
+        var rand = new Random(42);
+        using var actual = new NativeList<TextRange>();
+        using var single = new NativeList<TextRange>();
+        var expected = new List<TextRange>();
+        for (var n = 0; n < 500; n++)
+        {
+            var str = string.Concat(Enumerable.Range(0, rand.Next(1, 24)).Select(_ => pieces[rand.Next(pieces.Length)]));
+            actual.Clear();
+            expected.Clear();
+            fixed (char* p_str = str)
+            {
+                NativeLib.Instance.SplitTexts(&actual, p_str, str.Length);
+                for (var i = 0; i < str.Length;)
+                {
+                    var len = char.IsHighSurrogate(str[i]) && i + 1 < str.Length && char.IsLowSurrogate(str[i + 1]) ? 2 : 1;
+                    single.Clear();
+                    NativeLib.Instance.SplitTexts(&single, p_str + i, len);
+                    var range = single[0] with { Start = i };
+                    if (expected.Count > 0 && expected[^1].Script == range.Script && expected[^1].Category == range.Category)
+                        expected[^1] = expected[^1] with { Length = expected[^1].Length + len };
+                    else expected.Add(range);
+                    i += len;
+                }
+            }
+            Assert.That(actual.Count, Is.EqualTo(expected.Count), str);
+            for (var i = 0; i < expected.Count; i++)
+            {
+                Assert.That(actual[i], Is.EqualTo(expected[i]), str);
+            }
+        }
+    }
+
+    [Test]
+    public void TestWarmUpLikelyLocales()
+    {
+        NativeLib.Instance.WarmUpLikelyLocales();
+        using var a = new NativeList<TextRange>();
+        using var b = new NativeList<TextRange>();
+        var str = "abc 阿斯顿 def ياخشىمۇسىز こんにちは";
+        fixed (char* p_str = str)
+        {
+            NativeLib.Instance.SplitTexts(&a, p_str, str.Length);
+            NativeLib.Instance.SplitTexts(&b, p_str, str.Length);
+        }
+        Assert.That(a.Count, Is.EqualTo(b.Count));
+        for (var i = 0; i < a.Count; i++)
+        {
+            // Locales are interned per script, so the same pointer must come back every time
+            Assert.That(a[i].Locale, Is.EqualTo(b[i].Locale));
+            Assert.That(a[i].Locale.ToString(), Is.Not.Empty);
+        }
+    }
+
+    [Test]
+    public void TestSplitBatch([Values(false, true)] bool parallel)
+    {
+        var strs = new string[2000];
+        for (var i = 0; i < strs.Length; i++)
+        {
+            strs[i] = i % 3 == 0 ? $"label {i} 你好" : i % 3 == 1 ? "" : $"ياخشىمۇسىز {i}";
+        }
+        var handles = new GCHandle[strs.Length];
+        var inputs = new Str16[strs.Length];
+        try
+        {
+            for (var i = 0; i < strs.Length; i++)
+            {
+                handles[i] = GCHandle.Alloc(strs[i], GCHandleType.Pinned);
+                inputs[i] = new() { Data = (char*)handles[i].AddrOfPinnedObject(), Size = (uint)strs[i].Length };
+            }
+            using var ranges = new NativeList<TextRange>();
+            using var offsets = new NativeList<int>();
+            fixed (Str16* p_inputs = inputs)
+            {
+                NativeLib.Instance.SplitTextsBatch(&ranges, &offsets, p_inputs, inputs.Length, parallel);
+            }
+            Assert.That(offsets.Count, Is.EqualTo(strs.Length + 1));
+            for (var i = 0; i < strs.Length; i++)
+            {
+                using var single = new NativeList<TextRange>();
+                NativeLib.Instance.SplitTexts(&single, inputs[i].Data, strs[i].Length);
+                Assert.That(offsets[i + 1] - offsets[i], Is.EqualTo(single.Count));
+                for (var j = 0; j < single.Count; j++)
+                {
+                    Assert.That(ranges[offsets[i] + j], Is.EqualTo(single[j]));
+                }
+            }
+        }
+        finally
+        {
+            foreach (var handle in handles)
+            {
+                if (handle.IsAllocated) handle.Free();
+            }
+        }
+    }
 }